@@ -0,0 +1,171 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <chrono>
+#include "../HFTCore/DepthFeed.hpp"
+#include "../HFTCore/LatencyHistogram.hpp"
+#include "../HFTCore/Price.hpp"
+#include "../HFTCore/TscClock.hpp"
+#include "../HFTCore/Utils.hpp"
+
+// Depth of one symbol as rebuilt from the feed: a snapshot replaces it,
+// level updates edit it. After a sequence gap it's stale until the next
+// snapshot.
+struct SymbolDepth {
+    std::map<int64_t, DepthLevel, std::greater<int64_t>> bids;
+    std::map<int64_t, DepthLevel> asks;
+    uint64_t lastSequence = 0;
+    bool synced = false;
+    uint64_t updates = 0;
+};
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [OPTIONS]\n"
+        << "Follows the depth feed HFTApp publishes with --depth-shm.\n"
+        << "Options:\n"
+        << "  -n, --name NAME     Shared-memory name (default: /hft_depth)\n"
+        << "  -l, --levels N      Levels per side to print (default: 5)\n"
+        << "  -s, --symbol SYM    Print only this symbol\n"
+        << "  -i, --interval MS   Print every MS milliseconds (default: 1000)\n"
+        << "  -d, --duration SEC  Stop after SEC seconds (default: 0 = run until killed)\n"
+        << "  --quiet             Statistics only, no books\n"
+        << "  --help              Show this help message\n";
+}
+
+template<typename Side>
+static void applyLevel(Side& side, const DepthLevel& level) {
+    if (level.qty == 0) side.erase(level.price);
+    else side[level.price] = level;
+}
+
+static void printBook(const char* name, const SymbolDepth& d, size_t levels) {
+    std::cout << "  " << std::left << std::setw(8) << name << std::right
+        << (d.synced ? "" : " (stale, waiting for snapshot)") << std::endl;
+    auto bid = d.bids.begin();
+    auto ask = d.asks.begin();
+    for (size_t i = 0; i < levels && (bid != d.bids.end() || ask != d.asks.end()); ++i) {
+        std::cout << "    ";
+        if (bid != d.bids.end()) {
+            std::cout << std::setw(8) << bid->second.qty << " @ " << std::setw(10) << std::fixed << std::setprecision(4)
+                << static_cast<double>(bid->first) / kPriceScale;
+            ++bid;
+        }
+        else {
+            std::cout << std::setw(21) << "";
+        }
+        std::cout << "  |  ";
+        if (ask != d.asks.end()) {
+            std::cout << std::setw(10) << std::fixed << std::setprecision(4)
+                << static_cast<double>(ask->first) / kPriceScale << " @ " << ask->second.qty;
+            ++ask;
+        }
+        std::cout << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string name = "/hft_depth";
+    size_t levels = 5;
+    std::string symbolFilter;
+    int intervalMs = 1000;
+    int duration = 0;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if ((arg == "-n" || arg == "--name") && i + 1 < argc) {
+            name = argv[++i];
+        }
+        else if ((arg == "-l" || arg == "--levels") && i + 1 < argc) {
+            levels = static_cast<size_t>(std::stoul(argv[++i]));
+        }
+        else if ((arg == "-s" || arg == "--symbol") && i + 1 < argc) {
+            symbolFilter = argv[++i];
+        }
+        else if ((arg == "-i" || arg == "--interval") && i + 1 < argc) {
+            intervalMs = std::stoi(argv[++i]);
+        }
+        else if ((arg == "-d" || arg == "--duration") && i + 1 < argc) {
+            duration = std::stoi(argv[++i]);
+        }
+        else if (arg == "--quiet") {
+            quiet = true;
+        }
+        else if (arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    DepthReader reader;
+    if (!reader.open(name)) {
+        std::cerr << "Cannot open depth feed " << name << " (is HFTApp running with --depth-shm?)" << std::endl;
+        return 1;
+    }
+    std::cout << "=== Depth Feed: " << name << " ===" << std::endl;
+
+    std::vector<SymbolDepth> books;
+    LatencyHistogram hop;
+    uint64_t resyncs = 0;
+    uint64_t lastReceived = 0;
+    const auto interval = std::chrono::milliseconds(intervalMs);
+    const auto start = std::chrono::steady_clock::now();
+    auto nextPrint = start + interval;
+
+    DepthMessage m;
+    for (;;) {
+        // Spin on the ring: no syscalls while following the feed
+        if (reader.poll(m)) {
+            uint64_t now = TscClock::now();
+            hop.record(now > m.publishTicks ? TscClock::toNanos(now - m.publishTicks) : 0);
+            if (m.symbolId >= books.size()) books.resize(m.symbolId + 1);
+            SymbolDepth& d = books[m.symbolId];
+            if (m.type == static_cast<uint8_t>(DepthMessageType::Snapshot)) {
+                d.bids.clear();
+                d.asks.clear();
+                d.synced = true;
+            }
+            else if (d.lastSequence && m.bookSequence != d.lastSequence + 1) {
+                d.synced = false;
+                ++resyncs;
+            }
+            d.lastSequence = m.bookSequence;
+            ++d.updates;
+            for (size_t i = 0; i < m.bidCount && i < kDepthLevels; ++i) applyLevel(d.bids, m.bids[i]);
+            for (size_t i = 0; i < m.askCount && i < kDepthLevels; ++i) applyLevel(d.asks, m.asks[i]);
+            continue;
+        }
+        cpuRelax();
+
+        // steady_clock reads through the vDSO, so this is no syscall either
+        auto now = std::chrono::steady_clock::now();
+        if (now < nextPrint) continue;
+        nextPrint = now + interval;
+
+        HistogramSnapshot h(hop);
+        hop.reset();
+        double seconds = intervalMs * 1e-3;
+        std::cout << std::endl << "[DepthView] " << std::fixed << std::setprecision(0)
+            << (reader.received() - lastReceived) / seconds << " msg/s, hop p50 "
+            << h.percentile(0.50) << " ns, p99 " << h.percentile(0.99) << " ns, max " << h.max()
+            << " ns, overruns " << reader.overruns() << ", sequence gaps " << resyncs << std::endl;
+        lastReceived = reader.received();
+        if (!quiet) {
+            for (uint32_t id = 0; id < books.size(); ++id) {
+                const char* symbol = reader.symbolName(id);
+                if (!books[id].updates || (!symbolFilter.empty() && symbolFilter != symbol)) continue;
+                printBook(symbol, books[id], levels);
+            }
+        }
+        if (duration > 0 && now - start >= std::chrono::seconds(duration)) break;
+    }
+    return 0;
+}
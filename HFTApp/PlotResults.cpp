@@ -1,4 +1,5 @@
 #include "SimplePlotter.h"
+#include "RollingAnalytics.hpp"
 #include <iostream>
 #include <vector>
 #include <cmath>
@@ -31,17 +32,12 @@ void PlotTradingResults() {
     multi_series.push_back(prices);
     series_names.push_back("Price");
 
-    //Moving average series
+    //Moving average series (5-point window, one update per price)
     std::vector<double> moving_avg;
-    int window = 5;
+    RollingAnalytics window(1, RollingWindowConfig{ 5, 0 });
     for (size_t i = 0; i < prices.size(); ++i) {
-        double sum = 0;
-        int count = 0;
-        for (int j = std::max(0, (int)i - window + 1); j <= (int)i; ++j) {
-            sum += prices[j];
-            count++;
-        }
-        moving_avg.push_back(sum / count);
+        window.onTrade(0, toFixedPrice(prices[i]), 1, i);
+        moving_avg.push_back(window.average(0));
     }
     multi_series.push_back(moving_avg);
     series_names.push_back("Moving_Average");
@@ -3,17 +3,158 @@
 #include <chrono>
 #include <vector>
 #include <cmath>
-#include <numeric>
-#include "../HFTCore/OrderBook.hpp"
+#include <memory>
+#include <algorithm>
+#include <string>
+#include <fstream>
+#include "../HFTCore/Backtester.hpp"
+#include "../HFTCore/DepthFeed.hpp"
+#include "../HFTCore/OrderBookManager.hpp"
 #include "../HFTCore/MarketDataHandler.hpp"
+#include "../HFTCore/MarketMaker.hpp"
+#include "../HFTCore/PositionKeeper.hpp"
+#include "../HFTCore/RiskGate.hpp"
+#include "../HFTCore/RollingAnalytics.hpp"
 #include "../HFTCore/Utils.hpp"
+#include "../HFTCore/TscClock.hpp"
+#include "../HFTCore/StageLatency.hpp"
 #include "../HFTCore/PrometheusExporter.hpp"
-#include "../HFTCore/SimplePlotter.h"
+#include "../HFTCore/TimeSeriesWriter.hpp"
 
 PrometheusExporter exporter(9091);
 
-int main() {
+int main(int argc, char* argv[]) {
     std::cout << "=== High-Frequency Trading Engine ===" << std::endl;
+
+    bool binaryFeed = false;
+    int recvBatch = 0;                  // 0 = one recvfrom per iteration
+    IdlePolicy idlePolicy = IdlePolicy::Sleep;
+    int busyPollMicros = 0;
+    std::string recordDir;
+    std::string replayPath;
+    ReplayPacing replayPacing = ReplayPacing::AsFastAsPossible;
+    std::string backtestPath;
+    unsigned backtestThreads = 1;
+    TimeSeriesFormat seriesFormat = TimeSeriesFormat::Csv;
+    size_t seriesRotateBytes = 0;
+    FeedLine lineA, lineB;              // multicast groups; unicast UDP_PORT when unset
+    std::string multicastIf;
+    int receiveBuffer = MarketDataHandler::kDefaultReceiveBuffer;
+    std::string depthName;              // shared-memory depth feed, off when empty
+    std::string shmFeedName;            // shared-memory ring from MarketDataGen instead of UDP
+    uint32_t depthSnapshotEvery = 64;
+    bool marketMaker = false;           // run the sample strategy against the books
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--binary") {
+            binaryFeed = true;
+        }
+        else if (arg == "--recv-batch" && i + 1 < argc) {
+            recvBatch = std::stoi(argv[++i]);
+        }
+        else if (arg == "--idle" && i + 1 < argc) {
+            std::string policy = argv[++i];
+            idlePolicy = policy == "spin" ? IdlePolicy::Spin
+                : policy == "yield" ? IdlePolicy::Yield : IdlePolicy::Sleep;
+        }
+        else if (arg == "--busy-poll" && i + 1 < argc) {
+            busyPollMicros = std::stoi(argv[++i]);
+        }
+        else if (arg == "--record" && i + 1 < argc) {
+            recordDir = argv[++i];
+        }
+        else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        }
+        else if (arg == "--replay-pace" && i + 1 < argc) {
+            replayPacing = std::string(argv[++i]) == "recorded" ? ReplayPacing::AsRecorded : ReplayPacing::AsFastAsPossible;
+        }
+        else if (arg == "--backtest" && i + 1 < argc) {
+            backtestPath = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            backtestThreads = static_cast<unsigned>(std::stoi(argv[++i]));
+        }
+        else if (arg == "--series-format" && i + 1 < argc) {
+            seriesFormat = std::string(argv[++i]) == "binary" ? TimeSeriesFormat::Binary : TimeSeriesFormat::Csv;
+        }
+        else if (arg == "--series-rotate-mb" && i + 1 < argc) {
+            seriesRotateBytes = static_cast<size_t>(std::stoul(argv[++i])) << 20;
+        }
+        else if ((arg == "--mcast-a" || arg == "--mcast-b") && i + 1 < argc) {
+            std::string spec = argv[++i];
+            size_t colon = spec.rfind(':');
+            if (colon == std::string::npos) {
+                std::cerr << "Expected GROUP:PORT for " << arg << ": " << spec << std::endl;
+                return 1;
+            }
+            FeedLine& line = arg == "--mcast-a" ? lineA : lineB;
+            line.group = spec.substr(0, colon);
+            line.port = std::stoi(spec.substr(colon + 1));
+        }
+        else if (arg == "--mcast-if" && i + 1 < argc) {
+            multicastIf = argv[++i];
+        }
+        else if (arg == "--rcvbuf" && i + 1 < argc) {
+            receiveBuffer = std::stoi(argv[++i]);
+        }
+        else if (arg == "--shm-feed" && i + 1 < argc) {
+            shmFeedName = argv[++i];
+        }
+        else if (arg == "--depth-shm" && i + 1 < argc) {
+            depthName = argv[++i];
+        }
+        else if (arg == "--depth-snapshot" && i + 1 < argc) {
+            depthSnapshotEvery = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--market-maker") {
+            marketMaker = true;
+        }
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            std::cerr << "Usage: " << argv[0]
+                << " [--binary] [--recv-batch N] [--idle sleep|yield|spin] [--busy-poll US]"
+                << " [--record DIR] [--replay PATH [--replay-pace recorded|asap]]"
+                << " [--backtest FILE.csv|JOURNAL [--threads N]]"
+                << " [--series-format csv|binary] [--series-rotate-mb N]"
+                << " [--mcast-a GROUP:PORT [--mcast-b GROUP:PORT] [--mcast-if ADDR]] [--rcvbuf BYTES]"
+                << " [--shm-feed NAME]"
+                << " [--depth-shm NAME [--depth-snapshot N]] [--market-maker]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (!backtestPath.empty()) {
+        // Offline run on simulated time; no sockets, no wall-clock pacing
+        BacktestReader reader;
+        if (!reader.open(backtestPath)) {
+            std::cerr << "[Main] Cannot open backtest input " << backtestPath << std::endl;
+            return 1;
+        }
+        std::cout << "[Backtest] Replaying " << backtestPath << " ("
+            << (reader.format() == BacktestReader::Format::Csv ? "CSV" : "journal") << ") on "
+            << backtestThreads << " worker thread(s)..." << std::endl;
+        BacktestResult result = Backtester(backtestThreads).run(reader);
+
+        double simulatedSeconds = (result.lastTimeNs - result.firstTimeNs) * 1e-9;
+        std::cout << std::endl << "=== Backtest Summary ===" << std::endl;
+        std::cout << "Orders: " << result.orders << " (" << result.malformed << " malformed, "
+            << result.rejected << " rejected by the book)" << std::endl;
+        std::cout << "Symbols: " << result.symbols.size() << std::endl;
+        std::cout << "Trades Executed: " << result.trades << " (" << result.volume << " shares)" << std::endl;
+        std::cout << "Final P&L: $" << result.pnl() << std::endl;
+        std::cout << "Simulated Time: " << simulatedSeconds << " s, replayed in "
+            << result.wallSeconds << " s (" << (result.wallSeconds > 0 ? result.orders / result.wallSeconds : 0.0)
+            << " orders/s)" << std::endl;
+        std::cout << "Result Digest: " << std::hex << result.digest << std::dec << std::endl;
+
+        std::ofstream out("backtest_results.csv");
+        result.writeCsv(out);
+        std::cout << std::endl << "Files generated:" << std::endl;
+        std::cout << "  - backtest_results.csv" << std::endl;
+        return 0;
+    }
+
     std::cout << "[Main] Initializing components..." << std::endl;
 
     // Configuration
@@ -23,15 +164,82 @@ int main() {
     const int MAX_ORDERS = 50;           // Process up to 50 orders for demo
 
     // Initialize core components
-    LockFreeQueue<Order> queue;
-    OrderBook book;
-    MarketDataHandler md(queue, UDP_PORT, ENABLE_SYNTHETIC, SYNTHETIC_RATE);
+    auto queue = std::make_unique<OrderRing>();
+    OrderBookManager books;
+    MarketDataHandler md(*queue, UDP_PORT, ENABLE_SYNTHETIC, SYNTHETIC_RATE);
+    md.setSymbolTable(&books.symbols());
+    if (binaryFeed) {
+        md.setWireFormat(WireFormat::Binary);
+    }
+    if (recvBatch > 0) {
+        md.setReceiveMode(ReceiveMode::Batched, recvBatch);
+    }
+    md.setIdlePolicy(idlePolicy);
+    md.setBusyPoll(busyPollMicros);
+    md.setReceiveBuffer(receiveBuffer);
+    if (!lineA.group.empty()) {
+        md.setFeedLines(lineA, lineB, multicastIf);
+    }
+    if (!shmFeedName.empty()) {
+        md.setShmFeed(shmFeedName);
+    }
+
+    JournalWriter journal;
+    JournalReader replay;
+    if (!replayPath.empty()) {
+        if (!replay.open(replayPath)) {
+            std::cerr << "[Main] Cannot open journal " << replayPath << std::endl;
+            return 1;
+        }
+        if ((replay.wireFormat() == WireFormat::Binary) != binaryFeed) {
+            std::cerr << "[Main] Journal " << replayPath << " holds "
+                << (binaryFeed ? "ASCII datagrams; drop --binary" : "binary datagrams; add --binary") << std::endl;
+            return 1;
+        }
+        md.setReplaySource(&replay, replayPacing);
+    }
+    else if (!recordDir.empty()) {
+        if (!journal.open(recordDir, binaryFeed ? WireFormat::Binary : WireFormat::Ascii)) {
+            std::cerr << "[Main] Cannot create journal in " << recordDir << std::endl;
+            return 1;
+        }
+        md.setJournal(&journal);
+    }
+
+    // Books publish depth from this (the matching) thread
+    DepthPublisher depth;
+    if (!depthName.empty()) {
+        if (!depth.open(depthName)) {
+            std::cerr << "[Main] Cannot create depth feed " << depthName << std::endl;
+            return 1;
+        }
+        books.setDepthPublisher(&depth, depthSnapshotEvery);
+    }
 
     std::cout << "[Main] Configuration:" << std::endl;
-    std::cout << "  UDP Port: " << UDP_PORT << std::endl;
+    if (!shmFeedName.empty()) {
+        std::cout << "  Feed: shared memory " << shmFeedName << std::endl;
+    }
+    else {
+        std::cout << "  UDP Port: " << UDP_PORT << std::endl;
+    }
+    std::cout << "  Feed Format: " << (binaryFeed ? "Binary" : "ASCII") << std::endl;
+    std::cout << "  Receive: " << (recvBatch > 0 ? "recvmmsg x" + std::to_string(recvBatch) : "recvfrom") << std::endl;
     std::cout << "  Synthetic Data: " << (ENABLE_SYNTHETIC ? "Enabled" : "Disabled") << std::endl;
     std::cout << "  Synthetic Rate: " << SYNTHETIC_RATE << " Hz" << std::endl;
     std::cout << "  Max Orders: " << MAX_ORDERS << std::endl;
+    if (depth.isOpen()) {
+        std::cout << "  Depth Feed: " << depthName << " (snapshot every " << depthSnapshotEvery << " updates)" << std::endl;
+    }
+    if (marketMaker) {
+        std::cout << "  Strategy: market maker (orders trade in the local books)" << std::endl;
+    }
+    if (TscClock::usingTsc()) {
+        std::cout << "  Clock: invariant TSC @ " << TscClock::ghz() << " GHz" << std::endl;
+    }
+    else {
+        std::cout << "  Clock: OS monotonic (no invariant TSC)" << std::endl;
+    }
     std::cout << std::endl;
 
     // Start market data handler
@@ -41,11 +249,119 @@ int main() {
     // Give time for UDP socket initialization
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
 
-    // Data collection vectors
-    std::vector<double> timestamps, prices, moving_avg, cum_pnl, volume;
+    // Per-order samples stream to disk from a background thread; only
+    // running aggregates are kept in memory
+    TimeSeriesWriter series("dashboard_timeseries", { "Time", "Price", "MovingAvg", "Volume", "CumPnL" },
+        seriesFormat, seriesRotateBytes);
+    if (!series.start()) {
+        std::cerr << "[Main] Cannot open time-series output" << std::endl;
+        return 1;
+    }
+
+    // Order-book matching latency and per-hop pipeline latencies, all
+    // recorded by the worker thread
+    LatencyHistogram& matchLatency = exporter.addStage("match");
+    StageLatency stageLatency(exporter);
+
+    // Positions from strategy fills, marked at each symbol's last trade
+    PositionKeeper positions;
+    // Rolling signals over each symbol's last 64 trades within a second,
+    // updated inside the match that printed them
+    RollingAnalytics analytics(4096, RollingWindowConfig{ 64, 1000000000ull });
+
+    // Strategies see every book change on the worker thread. What they
+    // send passes the risk gate and then trades in the same books as the
+    // feed, so their fills come back through the trade callback.
+    StrategyHost<MarketMaker> strategies{ MarketMaker() };
+    RiskGate risk;
+    {
+        SymbolRiskLimits defaults;
+        defaults.maxOrderQty = 1000;
+        defaults.maxPosition = 5000;
+        defaults.maxNotional = 1000000.0;
+        auto limits = std::make_unique<RiskLimitTable>(4096, defaults);
+        limits->maxGrossExposure = 50000000.0;
+        limits->maxOrdersPerSecond = 100000;
+        limits->rateBurst = 1000;
+        risk.setLimits(std::move(limits));
+    }
+    LatencyHistogram& decisionLatency = exporter.addStage("decision");
+
+    auto ownFill = [&](const Trade& t, uint64_t orderId, OrderSide side, bool passive) {
+        Fill f;
+        f.symbolId = t.symbolId;
+        f.orderId = orderId;
+        f.side = side;
+        f.price = t.price;
+        f.qty = t.qty;
+        f.passive = passive;
+        positions.onFill(t.symbolId, side, t.qty, toFixedPrice(t.price));
+        risk.onFill(t.symbolId, side, t.qty, t.price);
+        strategies.onFill(f);
+    };
+
+    // Every match passes this sink, so trades reach the strategies as a
+    // direct call the compiler can inline. Also stamps the first fill of
+    // the order being matched.
+    Order* inFlight = nullptr;
+    auto onTrade = [&](const Trade& t) {
+        const uint64_t now = TscClock::now();
+        const int64_t price = toFixedPrice(t.price);
+        positions.setMark(t.symbolId, price);
+        analytics.onTrade(t.symbolId, price, t.qty, TscClock::toNanos(now));
+        if (marketMaker) {
+            risk.onTrade(t.symbolId, t.price);
+            // Only strategy ids have the top bit; the handler drops feed
+            // orders that set it
+            if (isStrategyOrder(t.makerId)) {
+                ownFill(t, t.makerId, t.aggressorSide == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY, true);
+            }
+            if (isStrategyOrder(t.takerId)) ownFill(t, t.takerId, t.aggressorSide, false);
+            strategies.onTrade(t);
+        }
+        if (inFlight && !inFlight->stamps.filled) {
+            inFlight->stamps.filled = inFlight->stamps.since(now);
+        }
+    };
+
+    // Fills while these match can queue more requests; they go out in the
+    // same pass, bounded by the buffer's capacity
+    auto sendRequests = [&]() {
+        OrderBuffer& out = strategies.outbound();
+        for (size_t i = 0; i < out.size(); ++i) {
+            const OrderRequest& r = out[i];
+            if (r.action == RequestAction::Cancel) {
+                // What was still working stops counting against the limits
+                const auto* book = books.find(r.symbolId);
+                OrderSide side;
+                uint32_t open = 0;
+                if (book && book->restingOrder(r.orderId, side, open) && books.cancel(r.symbolId, r.orderId)) {
+                    risk.onOrderClosed(r.symbolId, side, open);
+                }
+                continue;
+            }
+            Order o(books.symbols().name(r.symbolId), r.price, static_cast<int>(r.qty), r.type, r.side, r.orderId);
+            o.symbolId = r.symbolId;
+            if (risk.check(o) != RiskReject::None) {
+                strategies.onReject(r);
+                continue;
+            }
+            const uint32_t filled = books.match(o, onTrade);
+            // The remainder works only if it rests; market remainders and
+            // orders the book refused are done
+            const auto* book = books.find(r.symbolId);
+            OrderSide side;
+            uint32_t open = 0;
+            if (filled < r.qty && !(book && book->restingOrder(r.orderId, side, open))) {
+                risk.onOrderClosed(r.symbolId, r.side, r.qty - filled);
+            }
+        }
+        out.clear();
+    };
 
     int processed = 0;
-    double running_sum = 0.0, pnl = 0.0, prev_price = 100.0;
+    double running_sum = 0.0, last_price = 0.0;
+    double min_price = 0.0, max_price = 0.0, total_volume = 0.0;
 
     // Processing thread
     std::cout << "[Main] Starting order processing thread..." << std::endl;
@@ -55,18 +371,40 @@ int main() {
 
         auto start_time = std::chrono::steady_clock::now();
 
+        Order batch[64];
         while (processed < MAX_ORDERS) {
-            Order order;
-            if (queue.dequeue(order)) {
+            size_t n = queue->popBulk(batch, (std::min)(sizeof(batch) / sizeof(batch[0]),
+                static_cast<size_t>(MAX_ORDERS - processed)));
+            uint64_t dequeued = TscClock::now();
+            for (size_t i = 0; i < n; ++i) {
+                Order& order = batch[i];
+                order.stamps.dequeued = order.stamps.since(dequeued);
+                inFlight = &order;
                 // High-precision timing for latency measurement
-                auto process_start = rdtsc();
+                auto process_start = TscClock::start();
 
-                // Process order through order book
-                book.submit(order);
-                book.processAll();
+                // Route order to its symbol's book
+                books.match(order, onTrade);
 
                 // Calculate processing latency
-                double latency_us = (rdtsc() - process_start) / 1000.0;
+                uint64_t process_end = TscClock::stop();
+                uint64_t latency_ns = TscClock::toNanos(process_end - process_start);
+                matchLatency.record(latency_ns);
+                inFlight = nullptr;
+                order.stamps.applied = order.stamps.since(process_end);
+                stageLatency.record(order.stamps);
+
+                // The strategies react to the book this order changed
+                if (marketMaker && order.symbolId != kInvalidSymbolId) {
+                    if (auto* book = books.find(order.symbolId)) {
+                        const BookUpdate u = topOfBook(*book, process_end);
+                        risk.onQuote(u.symbolId, u.bid, u.ask);
+                        strategies.onBookUpdate(u);
+                        decisionLatency.record(TscClock::toNanos(TscClock::now() - process_end));
+                        sendRequests();
+                    }
+                }
+                double latency_us = latency_ns * 1e-3;
                 exporter.recordLatency(latency_us);
                 exporter.recordThroughput(1e6 / latency_us);
 
@@ -74,21 +412,23 @@ int main() {
                 auto now = std::chrono::steady_clock::now();
                 auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time).count();
 
-                timestamps.push_back(elapsed / 1000.0); // Convert to seconds
-                prices.push_back(order.price);
                 running_sum += order.price;
-                moving_avg.push_back(running_sum / (processed + 1));
-
                 double this_volume = static_cast<double>(order.qty);
-                volume.push_back(this_volume);
+                total_volume += this_volume;
+                min_price = processed ? (std::min)(min_price, order.price) : order.price;
+                max_price = processed ? (std::max)(max_price, order.price) : order.price;
 
-                // Simplified P&L calculation (alternating buy/sell positions)
-                double position_pnl = (order.price - prev_price) *
-                    ((order.side == OrderSide::BUY) ? 1 : -1) * order.qty;
-                pnl += position_pnl;
-                cum_pnl.push_back(pnl);
+                TimeSeriesRow row;
+                row.time = elapsed / 1000.0; // Convert to seconds
+                row.values[0] = order.price;
+                // Rolling VWAP of the order's symbol; its own price until it trades
+                const double vwap = analytics.vwap(order.symbolId);
+                row.values[1] = vwap > 0.0 ? vwap : order.price;
+                row.values[2] = this_volume;
+                row.values[3] = positions.pnl();     // unrealized as of the previous batch
+                series.push(row);
 
-                prev_price = order.price;
+                last_price = order.price;
                 processed++;
 
                 // Progress logging
@@ -100,13 +440,17 @@ int main() {
                         << "), Latency: " << latency_us << "μs" << std::endl;
                 }
             }
-            else {
+            // One vectorized revaluation per batch rather than per order
+            if (n) positions.markToMarket();
+            if (n == 0) {
+                // A replayed journal can hold fewer orders than MAX_ORDERS
+                if (md.replayFinished() && queue->empty()) break;
                 // Brief sleep when no orders available
                 std::this_thread::sleep_for(std::chrono::microseconds(100));
             }
         }
 
-        std::cout << "[Worker] Finished processing " << MAX_ORDERS << " orders." << std::endl;
+        std::cout << "[Worker] Finished processing " << processed << " orders." << std::endl;
         });
 
     // Wait for processing to complete
@@ -115,42 +459,73 @@ int main() {
     // Stop market data handler
     std::cout << "[Main] Stopping MarketDataHandler..." << std::endl;
     md.stop();
+    if (!recordDir.empty()) {
+        journal.close();
+        std::cout << "[Main] Journaled " << journal.records() << " datagrams in " << journal.segments()
+            << " segment(s) to " << recordDir << " (" << journal.dropped() << " dropped)" << std::endl;
+    }
 
     // Generate analytics and exports
     std::cout << "[Main] Generating analytics and exports..." << std::endl;
 
-    if (!timestamps.empty()) {
-        // Export CSV files
-        CSVExporter::ExportToCSV(timestamps, prices, "price_series.csv", "Time", "Price");
-        CSVExporter::ExportMultiSeries(
-            timestamps,
-            { prices, moving_avg, volume, cum_pnl },
-            { "Price", "MovingAvg", "Volume", "CumPnL" },
-            "dashboard_timeseries.csv"
-        );
-
-        // Generate plots using SimplePlotter
-        SimplePlotter::LinePlot(timestamps, prices, "Real-Time Price Feed", "Time", "Price");
-        SimplePlotter::LinePlot(timestamps, moving_avg, "Moving Average", "Time", "Value");
-        SimplePlotter::LinePlot(timestamps, cum_pnl, "Cumulative PnL", "Time", "PnL");
-        SimplePlotter::ShowPlot();
+    series.stop();
 
+    if (processed > 0) {
         // Print summary statistics
         std::cout << std::endl << "=== Trading Session Summary ===" << std::endl;
         std::cout << "Orders Processed: " << processed << std::endl;
-        std::cout << "Final Price: $" << prices.back() << std::endl;
-        std::cout << "Price Range: $" << *std::min_element(prices.begin(), prices.end())
-            << " - $" << *std::max_element(prices.begin(), prices.end()) << std::endl;
-        std::cout << "Final P&L: $" << pnl << std::endl;
-        std::cout << "Total Volume: " << std::accumulate(volume.begin(), volume.end(), 0.0) << std::endl;
+        std::cout << "Orders Dropped (queue full): " << md.droppedOrders() << std::endl;
+        if (binaryFeed) {
+            std::cout << "Feed Gaps: " << md.gapMessages() << " messages lost, "
+                << md.duplicateMessages() << " duplicates" << std::endl;
+            if (md.arbitrated()) {
+                const LineArbiter& ab = md.arbiter();
+                std::cout << "A/B Lines: A first " << ab.wins(0) << ", B first " << ab.wins(1)
+                    << ", gaps filled " << ab.recovered() << std::endl;
+            }
+        }
+        std::cout << "Final Price: $" << last_price << std::endl;
+        std::cout << "Price Range: $" << min_price << " - $" << max_price << std::endl;
+        std::cout << "Final P&L: $" << positions.pnl() << " (realized "
+            << static_cast<double>(positions.totalRealized()) / kPriceScale << ", unrealized "
+            << static_cast<double>(positions.totalUnrealized()) / kPriceScale << ")" << std::endl;
+        if (marketMaker) {
+            for (size_t i = 0; i < strategies.kStrategyCount; ++i) {
+                const StrategyStats& st = strategies.stats(i);
+                std::cout << "Strategy " << strategies.name(i) << ": " << st.events << " events, avg "
+                    << st.averageNanos() << " ns, max " << st.maxNanos() << " ns, "
+                    << st.requests << " requests" << std::endl;
+            }
+            HistogramSnapshot decision = exporter.snapshot("decision");
+            std::cout << "Tick to Decision (ns): p50 " << decision.percentile(0.50)
+                << ", p99 " << decision.percentile(0.99) << "; " << risk.rejectedTotal()
+                << " orders refused by risk, " << strategies.outbound().dropped() << " dropped" << std::endl;
+        }
+        std::cout << "Trades Executed: " << books.tradeCount()
+            << " (" << books.tradedVolume() << " shares) across "
+            << books.activeBooks() << " symbols" << std::endl;
+        std::cout << "Total Volume: " << total_volume << std::endl;
         std::cout << "Average Price: $" << (running_sum / processed) << std::endl;
 
+        HistogramSnapshot match = exporter.snapshot("match");
+        std::cout << "Match Latency (ns): p50 " << match.percentile(0.50)
+            << ", p99 " << match.percentile(0.99)
+            << ", p99.9 " << match.percentile(0.999)
+            << ", max " << match.max() << std::endl;
+        std::cout << "Pipeline Stages:" << std::endl;
+        for (int stage = 0; stage < StageLatency::kStageCount; ++stage) {
+            HistogramSnapshot snap = exporter.snapshot(StageLatency::name(stage));
+            if (!snap.count()) continue;
+            std::cout << "  " << StageLatency::name(stage) << ": p50 " << snap.percentile(0.50)
+                << " ns, p99 " << snap.percentile(0.99) << " ns" << std::endl;
+        }
+        exporter.dumpCsv("latency_summary.csv", "latency_histograms.csv");
+
         std::cout << std::endl << "Files generated:" << std::endl;
-        std::cout << "  - price_series.csv" << std::endl;
-        std::cout << "  - dashboard_timeseries.csv" << std::endl;
-        std::cout << "  - Real-Time_Price_Feed_data.csv" << std::endl;
-        std::cout << "  - Moving_Average_data.csv" << std::endl;
-        std::cout << "  - Cumulative_PnL_data.csv" << std::endl;
+        std::cout << "  - " << series.currentPath() << " (" << series.written() << " rows in "
+            << series.files() << " file(s), " << series.dropped() << " dropped)" << std::endl;
+        std::cout << "  - latency_summary.csv" << std::endl;
+        std::cout << "  - latency_histograms.csv" << std::endl;
     }
     else {
         std::cout << "[Main] No data collected - check market data feed." << std::endl;
@@ -159,6 +534,7 @@ int main() {
     std::cout << std::endl << "=== Instructions for UDP Testing ===" << std::endl;
     std::cout << "1. Build and run the C++ market data generator:" << std::endl;
     std::cout << "   ./MarketDataGen.exe --rate 50 --duration 60" << std::endl;
+    std::cout << "   (add --binary to both programs for the binary packet format)" << std::endl;
     std::cout << "2. Then run this HFT engine to consume the UDP data" << std::endl;
     std::cout << "3. Or run both simultaneously for real-time processing" << std::endl;
 
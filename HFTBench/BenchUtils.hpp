@@ -0,0 +1,33 @@
+#pragma once
+#include "benchmark/benchmark.h"
+#include "../HFTCore/TscClock.hpp"
+
+// Reports TSC cycles per operation as the "cycles/op" counter, next to
+// Google Benchmark's ns/op. Start it right before the timed loop and call
+// report() right after; pass the item count when one iteration moves
+// several items. Benches that call PauseTiming() must call pause() and
+// resume() next to it, so untimed work stays out of the count. Cycles are
+// at the TSC's reference rate, which is what the rest of the engine
+// measures in. Without an invariant TSC there is no cycle count and
+// nothing is reported.
+class CycleTimer {
+    uint64_t start_;
+    uint64_t pausedAt_ = 0;
+    uint64_t paused_ = 0;       // ticks spent between pause() and resume()
+
+public:
+    CycleTimer() : start_(TscClock::start()) {}
+
+    void pause() { pausedAt_ = TscClock::stop(); }
+    void resume() { paused_ += TscClock::start() - pausedAt_; }
+
+    void report(benchmark::State& state) {
+        report(state, state.iterations());
+    }
+
+    void report(benchmark::State& state, int64_t items) {
+        uint64_t cycles = TscClock::stop() - start_ - paused_;
+        if (!TscClock::usingTsc() || items <= 0) return;
+        state.counters["cycles/op"] = benchmark::Counter(static_cast<double>(cycles) / static_cast<double>(items));
+    }
+};
@@ -0,0 +1,82 @@
+#include "benchmark/benchmark.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include "../HFTCore/DepthFeed.hpp"
+#include "../HFTCore/LatencyHistogram.hpp"
+#include "../HFTCore/TscClock.hpp"
+#include "BenchUtils.hpp"
+
+static void fillUpdate(DepthMessage& m, uint64_t n) {
+    m.type = static_cast<uint8_t>(DepthMessageType::LevelUpdate);
+    m.bidCount = 1;
+    m.askCount = 0;
+    m.symbolId = 0;
+    m.bookSequence = n;
+    m.publishTicks = TscClock::now();
+    m.bids[0] = DepthLevel{ 1500000 + static_cast<int64_t>(n & 63), 100, 1 };
+}
+
+// What the book thread pays per level update, with nobody reading
+static void BM_DepthPublishUpdate(benchmark::State& state) {
+    DepthPublisher publisher;
+    if (!publisher.open("/hft_depth_bench")) {
+        state.SkipWithError("cannot create shared memory");
+        return;
+    }
+    uint64_t n = 0;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        fillUpdate(publisher.begin(), ++n);
+        publisher.commit();
+    }
+    cycles.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DepthPublishUpdate);
+
+// One update at a time through the region to a reader thread, which acks
+// each one. Counters are the publish-to-read hop as the reader timed it
+// from publishTicks. Waits yield so the benchmark still finishes when both
+// threads share a core.
+static void BM_DepthPublishToRead(benchmark::State& state) {
+    DepthPublisher publisher;
+    if (!publisher.open("/hft_depth_bench")) {
+        state.SkipWithError("cannot create shared memory");
+        return;
+    }
+    DepthReader reader;
+    reader.open("/hft_depth_bench");
+    LatencyHistogram hop;
+    std::atomic<uint64_t> acked{ 0 };
+    std::atomic<bool> stop{ false };
+    std::thread follower([&] {
+        DepthMessage m;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (reader.poll(m)) {
+                hop.record(TscClock::toNanos(TscClock::now() - m.publishTicks));
+                acked.store(m.bookSequence, std::memory_order_release);
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint64_t n = 0;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        fillUpdate(publisher.begin(), ++n);
+        publisher.commit();
+        while (acked.load(std::memory_order_acquire) != n) {
+            std::this_thread::yield();
+        }
+    }
+    cycles.report(state);
+    stop.store(true);
+    follower.join();
+    HistogramSnapshot h(hop);
+    state.counters["hop_p50_ns"] = benchmark::Counter(static_cast<double>(h.percentile(0.50)));
+    state.counters["hop_p99_ns"] = benchmark::Counter(static_cast<double>(h.percentile(0.99)));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DepthPublishToRead)->UseRealTime();
@@ -0,0 +1,88 @@
+#include "benchmark/benchmark.h"
+#include <memory>
+#include <random>
+#include <vector>
+#include "../HFTCore/MemoryPool.hpp"
+#include "BenchUtils.hpp"
+
+// Allocate/free churn with range(0) percent of the pool already live. Each
+// iteration frees a random live object and allocates a replacement, the
+// pattern of a book whose resting orders fill and cancel out of order.
+constexpr size_t kChurnCapacity = 1 << 16;
+using ChurnPool = MemoryPool<Order, kChurnCapacity>;
+
+static std::vector<uint32_t> churnVictims(size_t count, size_t live) {
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(live - 1));
+    std::vector<uint32_t> v(count);
+    for (auto& x : v) x = pick(rng);
+    return v;
+}
+
+static size_t liveCount(const benchmark::State& state) {
+    size_t live = kChurnCapacity * static_cast<size_t>(state.range(0)) / 100;
+    return live ? live : 1;
+}
+
+static void BM_MemoryPoolChurn(benchmark::State& state) {
+    auto pool = std::make_unique<ChurnPool>();
+    const size_t live = liveCount(state);
+    std::vector<Order*> objects(live);
+    for (auto& p : objects) p = pool->allocate();
+    const std::vector<uint32_t> victims = churnVictims(1 << 16, live);
+    size_t i = 0;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        uint32_t v = victims[i++ & (victims.size() - 1)];
+        pool->deallocate(objects[v]);
+        objects[v] = pool->allocate();
+        benchmark::DoNotOptimize(objects[v]);
+    }
+    cycles.report(state);
+    for (auto p : objects) pool->deallocate(p);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryPoolChurn)->Arg(0)->Arg(50)->Arg(90)->Arg(99);
+
+static void BM_MemoryPoolLocalCacheChurn(benchmark::State& state) {
+    auto pool = std::make_unique<ChurnPool>();
+    const size_t live = liveCount(state);
+    std::vector<Order*> objects(live);
+    {
+        ChurnPool::LocalCache cache(*pool);
+        for (auto& p : objects) p = cache.allocate();
+        const std::vector<uint32_t> victims = churnVictims(1 << 16, live);
+        size_t i = 0;
+        CycleTimer cycles;
+        for (auto _ : state) {
+            uint32_t v = victims[i++ & (victims.size() - 1)];
+            cache.deallocate(objects[v]);
+            objects[v] = cache.allocate();
+            benchmark::DoNotOptimize(objects[v]);
+        }
+        cycles.report(state);
+        for (auto p : objects) cache.deallocate(p);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryPoolLocalCacheChurn)->Arg(0)->Arg(50)->Arg(90)->Arg(99);
+
+// Baseline: the general-purpose heap doing the same churn
+static void BM_NewDeleteChurn(benchmark::State& state) {
+    const size_t live = liveCount(state);
+    std::vector<Order*> objects(live);
+    for (auto& p : objects) p = new Order();
+    const std::vector<uint32_t> victims = churnVictims(1 << 16, live);
+    size_t i = 0;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        uint32_t v = victims[i++ & (victims.size() - 1)];
+        delete objects[v];
+        objects[v] = new Order();
+        benchmark::DoNotOptimize(objects[v]);
+    }
+    cycles.report(state);
+    for (auto p : objects) delete p;
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NewDeleteChurn)->Arg(0)->Arg(50)->Arg(90)->Arg(99);
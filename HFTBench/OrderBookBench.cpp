@@ -0,0 +1,167 @@
+#include "benchmark/benchmark.h"
+#include <random>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include "../HFTCore/OrderBook.hpp"
+#include "BenchUtils.hpp"
+
+// Limit order flow clustered around a slowly drifting mid, roughly half of it
+// marketable, so both resting inserts and sweeps are exercised.
+static std::vector<Order> makeOrderFlow(size_t count) {
+    std::mt19937 rng(42);
+    std::normal_distribution<double> offset(0.0, 0.05);
+    std::uniform_int_distribution<int> qty(1, 500);
+    std::vector<Order> flow;
+    flow.reserve(count);
+    double mid = 100.0;
+    for (size_t i = 0; i < count; ++i) {
+        mid += offset(rng) * 0.1;
+        OrderSide side = (rng() & 1) ? OrderSide::BUY : OrderSide::SELL;
+        double px = mid + offset(rng);
+        flow.emplace_back("SYM", std::round(px * 100.0) / 100.0, qty(rng), OrderType::Limit, side);
+    }
+    return flow;
+}
+
+template<typename Book>
+static void BM_OrderBookLimitFlow(benchmark::State& state) {
+    const std::vector<Order> flow = makeOrderFlow(1 << 16);
+    // Anonymous orders pile up over a long run; give them the full-size pool
+    OrderNodePool pool;
+    Book book(kDefaultTickSize, &pool);
+    size_t i = 0;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.match(flow[i]));
+        i = (i + 1) & (flow.size() - 1);
+    }
+    cycles.report(state);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["levels"] = static_cast<double>(book.bidLevels() + book.askLevels());
+}
+BENCHMARK_TEMPLATE(BM_OrderBookLimitFlow, OrderBook);
+BENCHMARK_TEMPLATE(BM_OrderBookLimitFlow, LadderOrderBook);
+
+template<typename Book>
+static void BM_OrderBookBestPrice(benchmark::State& state) {
+    const std::vector<Order> flow = makeOrderFlow(1 << 12);
+    Book book;
+    for (const Order& o : flow) book.match(o);
+    CycleTimer cycles;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.bestBid());
+        benchmark::DoNotOptimize(book.bestAsk());
+    }
+    cycles.report(state);
+}
+BENCHMARK_TEMPLATE(BM_OrderBookBestPrice, OrderBook);
+BENCHMARK_TEMPLATE(BM_OrderBookBestPrice, LadderOrderBook);
+
+// Steady state of add / cancel-replace churn on a deep resting book, the
+// shape of most real order flow.
+template<typename Book>
+static void BM_OrderBookCancelReplace(benchmark::State& state) {
+    const size_t resting = 4096;
+    Book book;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> ticks(1, 200);
+    for (uint64_t id = 1; id <= resting; ++id) {
+        OrderSide side = (id & 1) ? OrderSide::BUY : OrderSide::SELL;
+        double px = (side == OrderSide::BUY) ? 100.0 - ticks(rng) * 0.01 : 100.0 + ticks(rng) * 0.01;
+        book.match(Order("SYM", px, 100, OrderType::Limit, side, id));
+    }
+    uint64_t id = 1;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        double px = (id & 1) ? 100.0 - ticks(rng) * 0.01 : 100.0 + ticks(rng) * 0.01;
+        benchmark::DoNotOptimize(book.replace(id, px, 100));
+        id = id % resting + 1;
+    }
+    cycles.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_OrderBookCancelReplace, OrderBook);
+BENCHMARK_TEMPLATE(BM_OrderBookCancelReplace, LadderOrderBook);
+
+// Add / cancel / take mix shaped like a lit equity book: most messages are
+// passive adds a few ticks from the touch (geometric depth profile), about
+// a third are cancels of recent orders, and ~10% are marketable orders
+// that sweep one or more levels. The script replays on a fresh book each
+// pass so the book depth stays stationary.
+enum class FlowEvent : uint8_t { Add, Cancel };
+
+struct ScriptedEvent {
+    FlowEvent kind;
+    Order order;
+};
+
+static std::vector<ScriptedEvent> makeMixedFlow(size_t count) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::geometric_distribution<int> depth(0.35);
+    std::normal_distribution<double> drift(0.0, 0.3);
+    std::lognormal_distribution<double> size(4.5, 0.8);
+    std::vector<ScriptedEvent> events;
+    events.reserve(count);
+    std::vector<uint64_t> live;
+    long midTicks = 10000;
+    uint64_t nextId = 1;
+    while (events.size() < count) {
+        if (u(rng) < 0.05) midTicks += std::lround(drift(rng));
+        double r = u(rng);
+        if (r < 0.30 && !live.empty()) {
+            // Cancels skew towards recent orders
+            size_t back = (std::min)(live.size() - 1, static_cast<size_t>(depth(rng)) * 8);
+            size_t idx = live.size() - 1 - back;
+            Order o;
+            o.id = live[idx];
+            live[idx] = live.back();
+            live.pop_back();
+            events.push_back({ FlowEvent::Cancel, o });
+            continue;
+        }
+        OrderSide side = (rng() & 1) ? OrderSide::BUY : OrderSide::SELL;
+        int qty = (std::max)(1, static_cast<int>(size(rng)));
+        long px;
+        if (r > 0.90) {
+            // Marketable: crosses the touch by a few ticks
+            px = (side == OrderSide::BUY) ? midTicks + 1 + depth(rng) : midTicks - 1 - depth(rng);
+        }
+        else {
+            px = (side == OrderSide::BUY) ? midTicks - 1 - depth(rng) : midTicks + 1 + depth(rng);
+        }
+        uint64_t id = nextId++;
+        live.push_back(id);
+        events.push_back({ FlowEvent::Add, Order("SYM", px * 0.01, qty, OrderType::Limit, side, id) });
+    }
+    return events;
+}
+
+template<typename Book>
+static void BM_OrderBookMixedFlow(benchmark::State& state) {
+    static const std::vector<ScriptedEvent> script = makeMixedFlow(1 << 16);
+    OrderNodePool pool;
+    auto book = std::make_unique<Book>(kDefaultTickSize, &pool);
+    size_t i = 0;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        const ScriptedEvent& e = script[i];
+        if (e.kind == FlowEvent::Add) benchmark::DoNotOptimize(book->match(e.order));
+        else benchmark::DoNotOptimize(book->cancel(e.order.id));
+        if (++i == script.size()) {
+            state.PauseTiming();
+            cycles.pause();
+            book = std::make_unique<Book>(kDefaultTickSize, &pool);
+            i = 0;
+            cycles.resume();
+            state.ResumeTiming();
+        }
+    }
+    cycles.report(state);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["resting"] = static_cast<double>(book->restingOrders());
+}
+BENCHMARK_TEMPLATE(BM_OrderBookMixedFlow, OrderBook);
+BENCHMARK_TEMPLATE(BM_OrderBookMixedFlow, LadderOrderBook);
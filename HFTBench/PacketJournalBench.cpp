@@ -0,0 +1,34 @@
+#include "benchmark/benchmark.h"
+#include <filesystem>
+#include <vector>
+#include "../HFTCore/PacketJournal.hpp"
+#include "../HFTCore/TscClock.hpp"
+#include "BenchUtils.hpp"
+
+// One append() of a range(0)-byte datagram, as the receive thread pays
+// it. The iteration count keeps the run inside the first 64 MB segment,
+// so this is the copy into pages the writer prepared, not a rotation.
+static void BM_JournalAppend(benchmark::State& state) {
+    const auto dir = std::filesystem::temp_directory_path() / "hft_journal_bench";
+    std::filesystem::remove_all(dir);
+    std::vector<char> datagram(static_cast<size_t>(state.range(0)), 'x');
+    {
+        JournalWriter writer;
+        if (!writer.open(dir.string(), WireFormat::Ascii)) {
+            state.SkipWithError("could not open the journal");
+            return;
+        }
+        uint64_t ticks = TscClock::now();
+        CycleTimer cycles;
+        for (auto _ : state) {
+            writer.append(datagram.data(), static_cast<uint32_t>(datagram.size()), ++ticks);
+        }
+        cycles.report(state);
+        state.counters["dropped"] = benchmark::Counter(static_cast<double>(writer.dropped()));
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+        writer.close();
+    }
+    std::filesystem::remove_all(dir);
+}
+BENCHMARK(BM_JournalAppend)->Arg(64)->Iterations(500000);
+BENCHMARK(BM_JournalAppend)->Arg(1000)->Iterations(60000);
@@ -0,0 +1,70 @@
+#include "benchmark/benchmark.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include "../HFTCore/MarketDataParser.hpp"
+#include "../MarketDataGen/MarketDataGenerator.hpp"
+#include "BenchUtils.hpp"
+
+// Realistic corpus straight from the generator's message formatter
+static const std::vector<std::string>& corpus() {
+    static const std::vector<std::string> messages = [] {
+        MarketDataGenerator gen;
+        std::vector<std::string> v;
+        v.reserve(4096);
+        for (int i = 0; i < 4096; ++i) v.push_back(gen.generateMarketData());
+        return v;
+    }();
+    return messages;
+}
+
+// The previous MarketDataHandler::parseMarketData, kept as the baseline
+static Order legacyParse(const char* buffer, int length) {
+    std::string data(buffer, length);
+    std::stringstream ss(data);
+    std::string token;
+    Order order{};
+    int fieldIndex = 0;
+    while (std::getline(ss, token, ',') && fieldIndex < 4) {
+        switch (fieldIndex) {
+        case 0:
+            strncpy(order.symbol, token.c_str(), sizeof(order.symbol) - 1);
+            order.symbol[sizeof(order.symbol) - 1] = '\0';
+            break;
+        case 1: order.price = std::stod(token); break;
+        case 2: order.qty = std::stoi(token); break;
+        case 3: order.side = (token == "BUY") ? OrderSide::BUY : OrderSide::SELL; break;
+        }
+        fieldIndex++;
+    }
+    return order;
+}
+
+static void BM_ParseLegacyStringstream(benchmark::State& state) {
+    const auto& msgs = corpus();
+    size_t i = 0;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        const std::string& m = msgs[i++ & (msgs.size() - 1)];
+        benchmark::DoNotOptimize(legacyParse(m.data(), static_cast<int>(m.size())));
+    }
+    cycles.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseLegacyStringstream);
+
+static void BM_ParseSimd(benchmark::State& state) {
+    const auto& msgs = corpus();
+    Order o;
+    size_t i = 0;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        const std::string& m = msgs[i++ & (msgs.size() - 1)];
+        benchmark::DoNotOptimize(parseOrderMessage(m.data(), m.size(), o));
+        benchmark::DoNotOptimize(o);
+    }
+    cycles.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseSimd);
@@ -0,0 +1,56 @@
+#include "benchmark/benchmark.h"
+#include <random>
+#include <vector>
+#include "../HFTCore/PositionKeeper.hpp"
+#include "BenchUtils.hpp"
+
+struct BenchFill {
+    uint32_t symbolId;
+    OrderSide side;
+    uint32_t qty;
+    int64_t price;
+};
+
+// Fills spread over `symbols` ids in random order, both sides
+static std::vector<BenchFill> benchFills(size_t symbols) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(symbols - 1));
+    std::vector<BenchFill> fills(4096);
+    for (size_t i = 0; i < fills.size(); ++i) {
+        fills[i] = { pick(rng), (rng() & 1) ? OrderSide::BUY : OrderSide::SELL,
+            1 + static_cast<uint32_t>(i % 200), toFixedPrice(99.0 + (i % 200) * 0.01) };
+    }
+    return fills;
+}
+
+static void BM_PositionFill(benchmark::State& state) {
+    const size_t symbols = static_cast<size_t>(state.range(0));
+    PositionKeeper keeper(symbols);
+    std::vector<BenchFill> fills = benchFills(symbols);
+    size_t i = 0;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        const BenchFill& f = fills[i++ & 4095];
+        keeper.onFill(f.symbolId, f.side, f.qty, f.price);
+    }
+    cycles.report(state);
+    benchmark::DoNotOptimize(keeper.totalRealized());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PositionFill)->Arg(1)->Arg(256)->Arg(4096);
+
+// One revaluation of range(0) open positions; items are positions
+static void BM_PositionMarkToMarket(benchmark::State& state) {
+    const size_t symbols = static_cast<size_t>(state.range(0));
+    PositionKeeper keeper(symbols);
+    for (const BenchFill& f : benchFills(symbols)) keeper.onFill(f.symbolId, f.side, f.qty, f.price);
+    keeper.onFill(static_cast<uint32_t>(symbols - 1), OrderSide::BUY, 1, toFixedPrice(100.0));
+    for (uint32_t s = 0; s < symbols; ++s) keeper.setMark(s, toFixedPrice(100.0 + (s % 7) * 0.01));
+    CycleTimer cycles;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(keeper.markToMarket());
+    }
+    cycles.report(state);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(symbols));
+}
+BENCHMARK(BM_PositionMarkToMarket)->Arg(256)->Arg(4096)->Arg(65536);
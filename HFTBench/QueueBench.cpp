@@ -0,0 +1,146 @@
+#include "benchmark/benchmark.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "../HFTCore/Order.hpp"
+#include "../HFTCore/SpscRing.hpp"
+#include "../HFTCore/LockFreeQueue.hpp"
+#include "BenchUtils.hpp"
+
+static void BM_SpscRingPushPop(benchmark::State& state) {
+    auto ring = std::make_unique<SpscRing<Order, 1 << 12>>();
+    Order in("AAPL", 150.0, 100), out;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        ring->tryPush(in);
+        ring->tryPop(out);
+        benchmark::DoNotOptimize(out);
+    }
+    cycles.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpscRingPushPop);
+
+static void BM_LockFreeQueueEnqueueDequeue(benchmark::State& state) {
+    LockFreeQueue<Order> q;
+    Order in("AAPL", 150.0, 100), out;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        q.enqueue(in);
+        q.dequeue(out);
+        benchmark::DoNotOptimize(out);
+    }
+    cycles.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockFreeQueueEnqueueDequeue);
+
+// Producer thread streams orders in batches of range(0); the timed
+// consumer drains them. Measures the per-order cost of the thread hop.
+static void BM_SpscRingCrossThread(benchmark::State& state) {
+    const size_t batch = static_cast<size_t>(state.range(0));
+    auto ring = std::make_unique<SpscRing<Order, 1 << 12>>();
+    std::atomic<bool> stop{ false };
+    std::thread producer([&] {
+        Order items[64];
+        for (Order& o : items) o = Order("AAPL", 150.0, 100);
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (batch == 1) ring->tryPush(items[0]);
+            else ring->pushBulk(items, batch);
+        }
+    });
+    Order out[64];
+    size_t received = 0;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        size_t n = (batch == 1) ? (ring->tryPop(out[0]) ? 1 : 0) : ring->popBulk(out, batch);
+        received += n;
+        benchmark::DoNotOptimize(out[0]);
+    }
+    cycles.report(state, static_cast<int64_t>(received));
+    stop.store(true);
+    producer.join();
+    state.SetItemsProcessed(static_cast<int64_t>(received));
+}
+BENCHMARK(BM_SpscRingCrossThread)->Arg(1)->Arg(16)->Arg(64)->UseRealTime();
+
+// Round trip through two queues and an echo thread: one iteration is
+// request out, reply back, so half of it is the one-way hop latency
+// (cache-line transfer plus the waiting side noticing). Waits yield so the
+// benchmark still finishes when both threads share a core.
+static void BM_LockFreeQueuePingPong(benchmark::State& state) {
+    LockFreeQueue<Order> request(1024), reply(1024);
+    std::atomic<bool> stop{ false };
+    std::thread echo([&] {
+        Order o;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (request.dequeue(o)) {
+                while (!reply.enqueue(o)) std::this_thread::yield();
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    Order in("AAPL", 150.0, 100), out;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        request.enqueue(in);
+        while (!reply.dequeue(out)) std::this_thread::yield();
+        benchmark::DoNotOptimize(out);
+    }
+    cycles.report(state);
+    stop.store(true);
+    echo.join();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockFreeQueuePingPong)->UseRealTime();
+
+// Fan-in/fan-out scaling: range(0) producers and range(1) consumers move a
+// fixed number of orders through one queue per iteration, in bulk batches
+// of up to 16. Reported rate is orders per second of wall time.
+static void BM_LockFreeQueueMpmcScaling(benchmark::State& state) {
+    const int producers = static_cast<int>(state.range(0));
+    const int consumers = static_cast<int>(state.range(1));
+    const size_t perIteration = 1 << 16;
+    const size_t perProducer = perIteration / producers;
+    const size_t total = perProducer * producers;
+    LockFreeQueue<Order> q(1 << 14);
+
+    CycleTimer cycles;
+    for (auto _ : state) {
+        std::atomic<size_t> consumed{ 0 };
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&] {
+                Order batch[16];
+                for (Order& o : batch) o = Order("AAPL", 150.0, 100);
+                for (size_t sent = 0; sent < perProducer;) {
+                    size_t want = (std::min)(static_cast<size_t>(16), perProducer - sent);
+                    size_t n = q.enqueueBulk(batch, want);
+                    if (n == 0) std::this_thread::yield();
+                    sent += n;
+                }
+            });
+        }
+        for (int c = 0; c < consumers; ++c) {
+            threads.emplace_back([&] {
+                Order batch[16];
+                while (consumed.load(std::memory_order_relaxed) < total) {
+                    size_t n = q.dequeueBulk(batch, 16);
+                    if (n == 0) std::this_thread::yield();
+                    else consumed.fetch_add(n, std::memory_order_relaxed);
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+    }
+    cycles.report(state, static_cast<int64_t>(state.iterations() * total));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * total));
+}
+BENCHMARK(BM_LockFreeQueueMpmcScaling)
+    ->Args({ 1, 1 })->Args({ 2, 2 })->Args({ 4, 4 })->Args({ 8, 8 })->Args({ 16, 16 })
+    ->Args({ 4, 1 })->Args({ 1, 4 })
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
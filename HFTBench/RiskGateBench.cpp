@@ -0,0 +1,117 @@
+#include "benchmark/benchmark.h"
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../HFTCore/RiskGate.hpp"
+#include "../HFTCore/LatencyHistogram.hpp"
+#include "../HFTCore/TscClock.hpp"
+#include "BenchUtils.hpp"
+
+// Limits every generated order passes, so each check runs the full path.
+// Nothing fills or closes here, so working quantity only grows; the
+// position and exposure limits are set out of its reach.
+static std::unique_ptr<RiskLimitTable> benchLimits(size_t symbols) {
+    SymbolRiskLimits l;
+    l.maxOrderQty = 10000;
+    l.maxPosition = INT64_MAX / 2;
+    l.maxNotional = 1e9;
+    l.priceBand = 0.10;
+    auto t = std::make_unique<RiskLimitTable>(symbols, l);
+    t->maxGrossExposure = 1e30;
+    t->maxOrdersPerSecond = 1000000000;
+    t->rateBurst = 1000000;
+    return t;
+}
+
+// Orders spread over range(0) symbols in random order
+static std::vector<Order> benchOrders(RiskGate& gate, size_t symbols) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(symbols - 1));
+    for (uint32_t s = 0; s < symbols; ++s) gate.onQuote(s, 99.95, 100.05);
+    std::vector<Order> orders(4096);
+    for (size_t i = 0; i < orders.size(); ++i) {
+        orders[i] = Order("AAPL", 99.0 + (i % 200) * 0.01, 100 + static_cast<int>(i % 50), OrderType::Limit,
+            (i & 1) ? OrderSide::BUY : OrderSide::SELL);
+        orders[i].symbolId = pick(rng);
+    }
+    return orders;
+}
+
+// Includes the TscClock::now() the rate limit needs; a caller that
+// already holds a timestamp passes it to check() and saves that read
+static void BM_RiskGateCheck(benchmark::State& state) {
+    const size_t symbols = static_cast<size_t>(state.range(0));
+    RiskGate gate(symbols);
+    gate.setLimits(benchLimits(symbols));
+    std::vector<Order> orders = benchOrders(gate, symbols);
+    size_t i = 0;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        RiskReject r = gate.check(orders[i++ & 4095]);
+        benchmark::DoNotOptimize(r);
+    }
+    cycles.report(state);
+    state.SetItemsProcessed(state.iterations());
+    if (gate.rejectedTotal()) state.SkipWithError("bench orders were rejected");
+}
+BENCHMARK(BM_RiskGateCheck)->Arg(1)->Arg(256)->Arg(4096);
+
+// Ticks a start()/stop() pair costs with nothing between them; the
+// smallest of many tries, so it is the fixed cost rather than noise
+static uint64_t emptyTimerTicks() {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 10000; ++i) {
+        uint64_t start = TscClock::start();
+        uint64_t end = TscClock::stop();
+        if (end - start < best) best = end - start;
+    }
+    return best;
+}
+
+// Per-check latency distribution over 4096 symbols. A timer read costs
+// more than a check, so each sample times kBatch checks back to back and
+// records their mean, after taking off the cost of the timer itself.
+// With range(0) set, a control thread publishes a new limit table as
+// fast as it can while the checks run.
+static void BM_RiskGateCheckLatency(benchmark::State& state) {
+    constexpr size_t kBatch = 32;
+    const size_t symbols = 4096;
+    RiskGate gate(symbols);
+    gate.setLimits(benchLimits(symbols));
+    std::vector<Order> orders = benchOrders(gate, symbols);
+    const uint64_t timerTicks = emptyTimerTicks();
+    std::atomic<bool> stop{ false };
+    std::thread control;
+    if (state.range(0)) {
+        control = std::thread([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                gate.setLimits(gate.copyLimits());
+                std::this_thread::yield();
+            }
+        });
+    }
+    LatencyHistogram latency;
+    size_t i = 0;
+    for (auto _ : state) {
+        uint64_t start = TscClock::start();
+        for (size_t k = 0; k < kBatch; ++k) {
+            RiskReject r = gate.check(orders[i++ & 4095], start);
+            benchmark::DoNotOptimize(r);
+        }
+        uint64_t end = TscClock::stop();
+        const uint64_t ticks = end - start > timerTicks ? end - start - timerTicks : 0;
+        latency.record(TscClock::toNanos(ticks) / kBatch);
+    }
+    stop.store(true);
+    if (control.joinable()) control.join();
+    HistogramSnapshot h(latency);
+    state.counters["p50_ns"] = benchmark::Counter(static_cast<double>(h.percentile(0.50)));
+    state.counters["p99_ns"] = benchmark::Counter(static_cast<double>(h.percentile(0.99)));
+    state.counters["p99.9_ns"] = benchmark::Counter(static_cast<double>(h.percentile(0.999)));
+    state.counters["timer_ns"] = benchmark::Counter(static_cast<double>(TscClock::toNanos(timerTicks)));
+    state.SetItemsProcessed(state.iterations() * kBatch);
+    if (gate.rejectedTotal()) state.SkipWithError("bench orders were rejected");
+}
+BENCHMARK(BM_RiskGateCheckLatency)->Arg(0)->Arg(1)->UseRealTime();
@@ -0,0 +1,68 @@
+#include "benchmark/benchmark.h"
+#include <random>
+#include <vector>
+#include "../HFTCore/RollingAnalytics.hpp"
+#include "BenchUtils.hpp"
+
+struct BenchTrade {
+    uint32_t symbolId;
+    int64_t price;
+    uint32_t qty;
+};
+
+static std::vector<BenchTrade> benchTrades(size_t symbols) {
+    std::mt19937 rng(42);
+    std::vector<BenchTrade> trades(4096);
+    for (BenchTrade& t : trades) {
+        t = { static_cast<uint32_t>(rng() % symbols), toFixedPrice(100.0) + static_cast<int64_t>(rng() % 2000) - 1000,
+            1 + static_cast<uint32_t>(rng() % 500) };
+    }
+    return trades;
+}
+
+// One trade into a full window. range(0) is the window in trades,
+// range(1) set adds a time span (10 us of 50 ns trades) with its exp()
+// per EMA update.
+static void BM_RollingOnTrade(benchmark::State& state) {
+    const size_t symbols = 256;
+    RollingWindowConfig config;
+    config.maxTrades = static_cast<uint32_t>(state.range(0));
+    config.spanNs = state.range(1) ? 10000 : 0;
+    RollingAnalytics stats(symbols, config);
+    std::vector<BenchTrade> trades = benchTrades(symbols);
+    uint64_t now = 0;
+    size_t i = 0;
+    for (; i < 256 * 4096; ++i) {
+        const BenchTrade& t = trades[i & 4095];
+        stats.onTrade(t.symbolId, t.price, t.qty, now += 50);
+    }
+    CycleTimer cycles;
+    for (auto _ : state) {
+        const BenchTrade& t = trades[i++ & 4095];
+        stats.onTrade(t.symbolId, t.price, t.qty, now += 50);
+    }
+    cycles.report(state);
+    benchmark::DoNotOptimize(stats.vwap(0));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RollingOnTrade)->Args({ 16, 0 })->Args({ 256, 0 })->Args({ 256, 1 });
+
+// VWAP and volatility for range(0) symbols; items are symbols
+static void BM_RollingSignals(benchmark::State& state) {
+    const size_t symbols = static_cast<size_t>(state.range(0));
+    RollingAnalytics stats(symbols, RollingWindowConfig{ 16, 0 });
+    std::vector<BenchTrade> trades = benchTrades(symbols);
+    for (size_t i = 0; i < symbols * 8; ++i) {
+        const BenchTrade& t = trades[i & 4095];
+        stats.onTrade(static_cast<uint32_t>(i % symbols), t.price, t.qty, i);
+    }
+    std::vector<double> vwap(symbols), volatility(symbols);
+    CycleTimer cycles;
+    for (auto _ : state) {
+        stats.signals(0, symbols, vwap.data(), volatility.data());
+        benchmark::ClobberMemory();
+    }
+    cycles.report(state);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(symbols));
+}
+BENCHMARK(BM_RollingSignals)->Arg(256)->Arg(4096);
@@ -0,0 +1,132 @@
+#include "benchmark/benchmark.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "../HFTCore/MarketMaker.hpp"
+#include "../HFTCore/OrderBookManager.hpp"
+#include "../HFTCore/LatencyHistogram.hpp"
+#include "../HFTCore/TscClock.hpp"
+#include "BenchUtils.hpp"
+
+static constexpr uint32_t kBenchSymbols = 64;
+
+// Feed orders that keep moving the top of book: limits near the touch,
+// with every fourth one crossing
+static std::vector<Order> feedOrders(OrderBookManager& books) {
+    std::mt19937 rng(42);
+    std::vector<Order> orders(4096);
+    char names[kBenchSymbols][8];
+    for (uint32_t s = 0; s < kBenchSymbols; ++s) {
+        snprintf(names[s], sizeof(names[s]), "SYM%u", s);
+        books.symbols().intern(names[s]);
+    }
+    for (size_t i = 0; i < orders.size(); ++i) {
+        const uint32_t s = rng() % kBenchSymbols;
+        const OrderSide side = (rng() & 1) ? OrderSide::BUY : OrderSide::SELL;
+        double offset = 0.01 * static_cast<double>(1 + rng() % 5);
+        if (i % 4 == 0) offset = -offset;
+        const double price = side == OrderSide::BUY ? 100.0 - offset : 100.0 + offset;
+        orders[i] = Order(names[s], price, 100 + static_cast<int>(rng() % 100), OrderType::Limit, side);
+        orders[i].symbolId = s;
+    }
+    return orders;
+}
+
+// Sends strategy requests into the books, outside the timed section
+template<typename Host, typename OnTrade>
+static void sendRequests(Host& host, OrderBookManager& books, OnTrade& onTrade) {
+    OrderBuffer& out = host.outbound();
+    for (size_t i = 0; i < out.size(); ++i) {
+        const OrderRequest& r = out[i];
+        if (r.action == RequestAction::Cancel) {
+            books.cancel(r.symbolId, r.orderId);
+            continue;
+        }
+        Order o(books.symbols().name(r.symbolId), r.price, static_cast<int>(r.qty), r.type, r.side, r.orderId);
+        o.symbolId = r.symbolId;
+        books.match(o, onTrade);
+    }
+    out.clear();
+}
+
+// Tick to order decision: the book applies a feed order, then every
+// strategy sees the new top of book and queues its requests. Per-event
+// latency percentiles are the counters; sending the requests is outside
+// the measurement.
+template<typename Host>
+static void BM_TickToDecision(benchmark::State& state) {
+    OrderBookManager books(kBenchSymbols);
+    std::vector<Order> orders = feedOrders(books);
+    Host host;
+    // Trades reach the strategies straight from the sweep
+    auto onTrade = [&host](const Trade& t) {
+        if (isStrategyOrder(t.makerId)) {
+            Fill f;
+            f.symbolId = t.symbolId;
+            f.orderId = t.makerId;
+            f.side = t.aggressorSide == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY;
+            f.price = t.price;
+            f.qty = t.qty;
+            f.passive = true;
+            host.onFill(f);
+        }
+        host.onTrade(t);
+    };
+    LatencyHistogram latency;
+    uint64_t requests = 0;
+    size_t i = 0;
+    for (auto _ : state) {
+        const Order& o = orders[i++ & 4095];
+        const uint64_t start = TscClock::start();
+        books.match(o, onTrade);
+        host.onBookUpdate(topOfBook(*books.find(o.symbolId), start));
+        const uint64_t end = TscClock::stop();
+        latency.record(TscClock::toNanos(end - start));
+        requests += host.outbound().size();
+        sendRequests(host, books, onTrade);
+    }
+    HistogramSnapshot h(latency);
+    state.counters["p50_ns"] = benchmark::Counter(static_cast<double>(h.percentile(0.50)));
+    state.counters["p99_ns"] = benchmark::Counter(static_cast<double>(h.percentile(0.99)));
+    state.counters["p99.9_ns"] = benchmark::Counter(static_cast<double>(h.percentile(0.999)));
+    state.counters["requests/tick"] = benchmark::Counter(static_cast<double>(requests) / static_cast<double>(state.iterations()));
+    state.SetItemsProcessed(state.iterations());
+}
+
+// One market maker, then three side by side
+struct OneMaker : StrategyHost<MarketMaker> {
+    OneMaker() : StrategyHost<MarketMaker>(MarketMaker(kBenchSymbols)) {}
+};
+struct ThreeMakers : StrategyHost<MarketMaker, MarketMaker, MarketMaker> {
+    ThreeMakers() : StrategyHost<MarketMaker, MarketMaker, MarketMaker>(
+        MarketMaker(kBenchSymbols), MarketMaker(kBenchSymbols, wide()), MarketMaker(kBenchSymbols, wide(0.10))) {}
+    static MarketMakerConfig wide(double halfSpread = 0.05) {
+        MarketMakerConfig c;
+        c.halfSpread = halfSpread;
+        return c;
+    }
+};
+BENCHMARK_TEMPLATE(BM_TickToDecision, OneMaker)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_TickToDecision, ThreeMakers)->UseRealTime();
+
+// Dispatch and decision alone, on precomputed top-of-book updates
+static void BM_StrategyDispatch(benchmark::State& state) {
+    OneMaker host;
+    std::mt19937 rng(7);
+    std::vector<BookUpdate> updates(4096);
+    for (BookUpdate& u : updates) {
+        u.symbolId = rng() % kBenchSymbols;
+        u.bid = 100.0 - 0.01 * static_cast<double>(1 + rng() % 3);
+        u.ask = 100.0 + 0.01 * static_cast<double>(1 + rng() % 3);
+        u.bidQty = u.askQty = 100;
+    }
+    size_t i = 0;
+    CycleTimer cycles;
+    for (auto _ : state) {
+        host.onBookUpdate(updates[i++ & 4095]);
+        host.outbound().clear();
+    }
+    cycles.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StrategyDispatch);
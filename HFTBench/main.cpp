@@ -0,0 +1,31 @@
+#include "benchmark/benchmark.h"
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../HFTCore/TscClock.hpp"
+
+// BENCHMARK_MAIN, except results also go to hftbench.json unless the
+// command line picks its own --benchmark_out. Compare two runs with
+// Google Benchmark's tools/compare.py.
+int main(int argc, char** argv) {
+    std::vector<char*> args(argv, argv + argc);
+    bool hasOut = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--benchmark_out=", 16) == 0) hasOut = true;
+    }
+    static char outArg[] = "--benchmark_out=hftbench.json";
+    static char formatArg[] = "--benchmark_out_format=json";
+    if (!hasOut) {
+        args.push_back(outArg);
+        args.push_back(formatArg);
+    }
+    int count = static_cast<int>(args.size());
+
+    benchmark::AddCustomContext("tsc", TscClock::usingTsc()
+        ? "invariant, " + std::to_string(TscClock::ghz()) + " GHz" : "unavailable");
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,371 @@
+#include "pch.h"
+#include "Backtester.hpp"
+#include "MarketDataParser.hpp"
+#include "OrderBookManager.hpp"
+#include "SpscRing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+BacktestReader::BacktestReader(size_t maxSymbols) : symbols_(maxSymbols) {}
+
+BacktestReader::~BacktestReader() {
+    if (file_) fclose(file_);
+}
+
+bool BacktestReader::open(const std::string& path) {
+    std::error_code ec;
+    if (std::filesystem::is_directory(path, ec) || std::filesystem::path(path).extension() == ".jrnl") {
+        format_ = Format::Journal;
+        if (!journal_.open(path)) return false;
+        countJournalMessages(path);
+        return true;
+    }
+    format_ = Format::Csv;
+    file_ = fopen(path.c_str(), "rb");
+    if (!file_) return false;
+    block_.resize(kBlockSize);
+    return countCsvLines();
+}
+
+bool BacktestReader::countCsvLines() {
+    // One order per line at most; the last line may lack its newline
+    uint64_t lines = 1;
+    size_t n;
+    while ((n = fread(block_.data(), 1, block_.size(), file_)) > 0) {
+        const char* end = block_.data() + n;
+        for (const char* p = block_.data(); (p = static_cast<const char*>(memchr(p, '\n', end - p))) != nullptr; ++p) {
+            ++lines;
+        }
+    }
+    orderBound_ = lines;
+    return fseek(file_, 0, SEEK_SET) == 0;
+}
+
+void BacktestReader::countJournalMessages(const std::string& path) {
+    // A separate reader, so the one next() uses starts from the top
+    JournalReader scan;
+    if (!scan.open(path)) return;
+    JournalRecord rec;
+    uint64_t messages = 0;
+    while (scan.next(rec)) {
+        uint32_t magic = 0;
+        if (rec.length >= sizeof(magic)) memcpy(&magic, rec.data, sizeof(magic));
+        if (magic == kWireMagic && rec.length >= sizeof(PacketHeader)) {
+            messages += (std::min)((rec.length - sizeof(PacketHeader)) / sizeof(AddOrderMessage), kMaxPending);
+        }
+        else {
+            ++messages;
+        }
+    }
+    orderBound_ = messages;
+}
+
+bool BacktestReader::next(Order& out, uint64_t& timeNs) {
+    return format_ == Format::Csv ? nextCsv(out, timeNs) : nextJournal(out, timeNs);
+}
+
+void BacktestReader::finish(Order& out, uint64_t timeNs) {
+    out.timestamp = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(timeNs));
+    out.stamps = OrderStamps{};
+}
+
+void BacktestReader::fill() {
+    // Keep the partial line at the end of the block and read behind it
+    size_t left = end_ - begin_;
+    if (left && begin_) memmove(block_.data(), block_.data() + begin_, left);
+    begin_ = 0;
+    end_ = left;
+    if (end_ == block_.size()) {
+        // A single line longer than the block: it can't be a feed message.
+        // Drop it, and the rest of it still to come, as one bad line.
+        ++malformed_;
+        end_ = 0;
+        skipLine_ = true;
+    }
+    size_t n = fread(block_.data() + end_, 1, block_.size() - end_, file_);
+    end_ += n;
+    if (n == 0) eof_ = true;
+    while (skipLine_ && begin_ < end_) {
+        const char* nl = static_cast<const char*>(memchr(block_.data() + begin_, '\n', end_ - begin_));
+        if (nl) {
+            begin_ = static_cast<size_t>(nl - block_.data()) + 1;
+            skipLine_ = false;
+        }
+        else {
+            begin_ = end_ = 0;
+            n = fread(block_.data(), 1, block_.size(), file_);
+            end_ = n;
+            if (n == 0) {
+                eof_ = true;
+                skipLine_ = false;
+            }
+        }
+    }
+}
+
+bool BacktestReader::nextCsv(Order& out, uint64_t& timeNs) {
+    for (;;) {
+        char* p = block_.data() + begin_;
+        size_t avail = end_ - begin_;
+        char* nl = static_cast<char*>(memchr(p, '\n', avail));
+        size_t len;
+        if (nl) {
+            len = static_cast<size_t>(nl - p);
+            begin_ += len + 1;
+        }
+        else if (!eof_) {
+            fill();
+            continue;
+        }
+        else if (avail) {
+            // Last line without a newline
+            len = avail;
+            begin_ = end_;
+        }
+        else {
+            return false;
+        }
+
+        if (len && p[len - 1] == '\r') --len;
+        if (!len) continue;
+
+        uint64_t t = emitted_ ? lastTimeNs_ + kCsvDefaultSpacingNs : 0;
+        const char* msg = p;
+        if (*msg >= '0' && *msg <= '9') {
+            // Leading event time; symbols never start with a digit
+            uint64_t v = 0;
+            while (msg < p + len && *msg >= '0' && *msg <= '9') v = v * 10 + static_cast<uint64_t>(*msg++ - '0');
+            if (msg == p + len || *msg != ',') {
+                ++malformed_;
+                continue;
+            }
+            ++msg;
+            t = v;
+        }
+        if (parseOrderMessage(msg, static_cast<size_t>(p + len - msg), out) != ParseError::None) {
+            ++malformed_;
+            continue;
+        }
+        out.id = 0;
+        out.type = OrderType::Limit;
+        out.symbolId = symbols_.intern(out.symbol);
+        if (out.symbolId == kInvalidSymbolId) {
+            ++malformed_;
+            continue;
+        }
+        ++emitted_;
+        lastTimeNs_ = t;
+        timeNs = t;
+        finish(out, t);
+        return true;
+    }
+}
+
+bool BacktestReader::nextJournal(Order& out, uint64_t& timeNs) {
+    for (;;) {
+        if (pendingNext_ < pendingCount_) {
+            out = pending_[pendingNext_++];
+            timeNs = pendingTimeNs_;
+            finish(out, timeNs);
+            return true;
+        }
+
+        JournalRecord rec;
+        if (!journal_.next(rec)) return false;
+        if (!haveFirstTicks_) {
+            firstTicks_ = rec.rxTicks;
+            haveFirstTicks_ = true;
+        }
+        pendingTimeNs_ = rec.rxTicks > firstTicks_
+            ? static_cast<uint64_t>(static_cast<double>(rec.rxTicks - firstTicks_) * journal_.nsPerTick()) : 0;
+        pendingCount_ = 0;
+        pendingNext_ = 0;
+
+        uint32_t magic = 0;
+        if (rec.length >= sizeof(magic)) memcpy(&magic, rec.data, sizeof(magic));
+        if (magic == kWireMagic) {
+            const PacketHeader* header = nullptr;
+            DecodeResult result = decodePacket(rec.data, rec.length, header,
+                [&](const AddOrderMessage& m, uint64_t seq) {
+                    if (!arbiter_.accept(seq, 0) || pendingCount_ == kMaxPending) return;
+                    Order& order = pending_[pendingCount_];
+                    if (!toOrder(m, order)) {
+                        ++malformed_;
+                        return;
+                    }
+                    order.symbolId = symbols_.intern(order.symbol);
+                    if (order.symbolId != kInvalidSymbolId) ++pendingCount_;
+                });
+            if (result != DecodeResult::Ok) ++malformed_;
+        }
+        else {
+            Order& order = pending_[0];
+            if (parseOrderMessage(rec.data, rec.length, order) == ParseError::None) {
+                order.id = 0;
+                order.type = OrderType::Limit;
+                order.symbolId = symbols_.intern(order.symbol);
+                if (order.symbolId != kInvalidSymbolId) pendingCount_ = 1;
+            }
+            if (!pendingCount_) ++malformed_;
+        }
+    }
+}
+
+void BacktestResult::writeCsv(std::ostream& out) const {
+    out << "symbol,orders,trades,volume,rejected,pnl,last_price,digest\n";
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        const SymbolResult& r = perSymbol[i];
+        out << symbols[i] << ',' << r.orders << ',' << r.trades << ',' << r.volume << ','
+            << r.rejected << ',' << r.pnl() << ','
+            << static_cast<double>(r.lastPrice) / static_cast<double>(kPriceScale) << ','
+            << std::hex << r.digest << std::dec << '\n';
+    }
+}
+
+static constexpr uint64_t kFnvOffset = 0xCBF29CE484222325ull;
+static constexpr uint64_t kFnvPrime = 0x100000001B3ull;
+
+static uint64_t fnvMix(uint64_t h, uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        h ^= (v >> (i * 8)) & 0xFF;
+        h *= kFnvPrime;
+    }
+    return h;
+}
+
+namespace {
+
+constexpr size_t kBacktestRingSize = size_t(1) << 14;
+constexpr size_t kBacktestStageSize = 256;
+
+struct BacktestWorker {
+    SpscRing<Order, kBacktestRingSize> ring;
+    OrderBookManager books;
+    std::vector<SymbolResult> results;
+    // Reader-side staging, pushed to the ring in bulk
+    std::unique_ptr<Order[]> stage;
+    size_t staged = 0;
+    std::thread thread;
+
+    BacktestWorker(size_t maxSymbols, double tickSize, OrderNodePool* pool)
+        : books(maxSymbols, tickSize, pool), results(maxSymbols), stage(new Order[kBacktestStageSize]) {
+        for (SymbolResult& r : results) r.digest = kFnvOffset;
+    }
+
+    // Reader thread; waits for room rather than dropping
+    void flush() {
+        size_t sent = 0;
+        while (sent < staged) {
+            size_t n = ring.pushBulk(&stage[sent], staged - sent);
+            if (!n) std::this_thread::yield();
+            sent += n;
+        }
+        staged = 0;
+    }
+
+    void apply(const Order& o) {
+        SymbolResult& r = results[o.symbolId];
+        int64_t px = toFixedPrice(o.price);
+        if (r.orders) {
+            int64_t sign = o.side == OrderSide::BUY ? 1 : -1;
+            r.pnlFixed += (px - r.lastPrice) * sign * o.qty;
+        }
+        r.lastPrice = px;
+        ++r.orders;
+        books.match(o);
+    }
+
+    void loop(const std::atomic<bool>& done) {
+        books.setTradeCallback([this](const Trade& t) {
+            SymbolResult& r = results[t.symbolId];
+            ++r.trades;
+            r.volume += t.qty;
+            uint64_t h = fnvMix(r.digest, t.makerId);
+            h = fnvMix(h, t.takerId);
+            h = fnvMix(h, static_cast<uint64_t>(toFixedPrice(t.price)));
+            h = fnvMix(h, t.qty);
+            r.digest = fnvMix(h, t.aggressorSide == OrderSide::BUY ? 'B' : 'S');
+        });
+        Order batch[64];
+        for (;;) {
+            size_t n = ring.popBulk(batch, sizeof(batch) / sizeof(batch[0]));
+            for (size_t i = 0; i < n; ++i) apply(batch[i]);
+            if (n) continue;
+            // Everything was pushed before done was set, so one more empty
+            // pop after seeing it means the ring is drained
+            if (done.load(std::memory_order_acquire)) {
+                if (ring.empty()) break;
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    }
+};
+
+}
+
+Backtester::Backtester(unsigned workers, double tickSize)
+    : workers_(workers ? workers : 1), tickSize_(tickSize) {}
+
+BacktestResult Backtester::run(BacktestReader& reader) {
+    const size_t maxSymbols = reader.symbols().capacity();
+    // Every order could rest, so a pool of orderBound() nodes never runs
+    // dry. Node storage is only touched as it is handed out.
+    const uint64_t bound = (std::min)(reader.orderBound(), uint64_t(UINT32_MAX - 1));
+    OrderNodePool pool(static_cast<size_t>((std::max)(bound, uint64_t(1))));
+    std::vector<std::unique_ptr<BacktestWorker>> workers;
+    for (unsigned i = 0; i < workers_; ++i) {
+        workers.push_back(std::make_unique<BacktestWorker>(maxSymbols, tickSize_, &pool));
+    }
+    std::atomic<bool> done{ false };
+    for (auto& w : workers) {
+        BacktestWorker* worker = w.get();
+        worker->thread = std::thread([worker, &done]() { worker->loop(done); });
+    }
+
+    BacktestResult result;
+    auto wallStart = std::chrono::steady_clock::now();
+    Order order;
+    uint64_t timeNs = 0;
+    bool first = true;
+    while (reader.next(order, timeNs)) {
+        if (first) {
+            result.firstTimeNs = timeNs;
+            first = false;
+        }
+        result.lastTimeNs = timeNs;
+        BacktestWorker& w = *workers[order.symbolId % workers_];
+        w.stage[w.staged++] = order;
+        if (w.staged == kBacktestStageSize) w.flush();
+    }
+    for (auto& w : workers) w->flush();
+    done.store(true, std::memory_order_release);
+    for (auto& w : workers) w->thread.join();
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    // Fold in symbol id order, which is first-appearance order in the input
+    const SymbolTable& symbols = reader.symbols();
+    result.malformed = reader.malformed();
+    result.digest = kFnvOffset;
+    for (uint32_t id = 0; id < symbols.size(); ++id) {
+        BacktestWorker& w = *workers[id % workers_];
+        SymbolResult r = w.results[id];
+        if (const auto* book = w.books.find(id)) r.rejected = book->rejectedCount();
+        result.orders += r.orders;
+        result.trades += r.trades;
+        result.volume += r.volume;
+        result.rejected += r.rejected;
+        result.pnlFixed += r.pnlFixed;
+        result.digest = fnvMix(fnvMix(fnvMix(result.digest, id), r.digest), r.rejected);
+        result.symbols.push_back(symbols.name(id));
+        result.perSymbol.push_back(r);
+    }
+    return result;
+}
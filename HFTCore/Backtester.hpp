@@ -0,0 +1,149 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Order.hpp"
+#include "PacketJournal.hpp"
+#include "SymbolTable.hpp"
+#include "WireProtocol.hpp"
+
+// Streams recorded market data as orders stamped with simulated time.
+//
+// Two inputs are accepted:
+//  - CSV, one "SYMBOL,PRICE,QTY,SIDE" message per line, optionally preceded
+//    by an event time in nanoseconds ("TIME_NS,SYMBOL,PRICE,QTY,SIDE").
+//    Lines without a time are spaced kCsvDefaultSpacingNs apart. Lines that
+//    don't parse (a header row, say) are skipped and counted.
+//  - A PacketJournal file or directory. Each datagram is decoded as a binary
+//    packet when it carries the wire magic, as an ASCII message otherwise,
+//    and takes its receive time relative to the first record. Messages
+//    are run through a LineArbiter, so a capture of both lines of an A/B
+//    feed replays each message once, as the live handler took it.
+//
+// The file is read in large blocks and parsed in place; nothing allocates
+// per message. Symbols are interned into the reader's SymbolTable in order
+// of first appearance, so ids are the same on every run of the same input.
+class BacktestReader {
+public:
+    enum class Format {
+        Csv,
+        Journal
+    };
+
+    static constexpr uint64_t kCsvDefaultSpacingNs = 1000;
+
+    explicit BacktestReader(size_t maxSymbols = 4096);
+    ~BacktestReader();
+    BacktestReader(const BacktestReader&) = delete;
+    BacktestReader& operator=(const BacktestReader&) = delete;
+
+    // A directory or a *.jrnl file opens as a journal, anything else as CSV
+    bool open(const std::string& path);
+
+    // Next order, with symbolId set and timestamp on the simulated clock
+    // (steady_clock epoch + timeNs). False at the end of the input.
+    bool next(Order& out, uint64_t& timeNs);
+
+    Format format() const { return format_; }
+    SymbolTable& symbols() { return symbols_; }
+    const SymbolTable& symbols() const { return symbols_; }
+    uint64_t malformed() const { return malformed_; }
+    uint64_t gapMessages() const { return arbiter_.lostMessages(); }
+    // Most orders the input can hold: lines of a CSV, message slots of a
+    // journal's datagrams. Counted by a quick pass in open(); no book can
+    // ever have more resting than this.
+    uint64_t orderBound() const { return orderBound_; }
+
+private:
+    bool nextCsv(Order& out, uint64_t& timeNs);
+    bool nextJournal(Order& out, uint64_t& timeNs);
+    void fill();
+    bool countCsvLines();
+    void countJournalMessages(const std::string& path);
+    static void finish(Order& out, uint64_t timeNs);
+
+    static constexpr size_t kBlockSize = size_t(1) << 20;
+    static constexpr size_t kMaxPending = kMaxMessagesPerPacket;
+
+    Format format_ = Format::Csv;
+    SymbolTable symbols_;
+    uint64_t malformed_ = 0;
+    uint64_t orderBound_ = 0;
+
+    // CSV
+    FILE* file_ = nullptr;
+    std::vector<char> block_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    bool eof_ = false;
+    bool skipLine_ = false;     // discarding the tail of an overlong line
+    uint64_t lastTimeNs_ = 0;
+    uint64_t emitted_ = 0;
+
+    // Journal
+    JournalReader journal_;
+    LineArbiter arbiter_;
+    bool haveFirstTicks_ = false;
+    uint64_t firstTicks_ = 0;
+    Order pending_[kMaxPending];
+    size_t pendingCount_ = 0;
+    size_t pendingNext_ = 0;
+    uint64_t pendingTimeNs_ = 0;
+};
+
+// Per-symbol outcome. P&L is the engine's simplified mark-to-previous-price
+// P&L, kept in 1 / kPriceScale units so the sum is exact.
+struct SymbolResult {
+    uint64_t orders = 0;
+    uint64_t trades = 0;
+    uint64_t volume = 0;
+    uint64_t rejected = 0;          // refused by the book (duplicate id); part of the digest
+    int64_t pnlFixed = 0;
+    int64_t lastPrice = 0;          // 1 / kPriceScale units; 0 before the first order
+    uint64_t digest = 0;            // FNV-1a over the symbol's trades, in order
+
+    double pnl() const { return static_cast<double>(pnlFixed) / static_cast<double>(kPriceScale); }
+};
+
+struct BacktestResult {
+    uint64_t orders = 0;
+    uint64_t trades = 0;
+    uint64_t volume = 0;
+    uint64_t malformed = 0;         // input lines, datagrams or binary messages that failed to decode
+    uint64_t rejected = 0;
+    int64_t pnlFixed = 0;
+    uint64_t firstTimeNs = 0;
+    uint64_t lastTimeNs = 0;
+    double wallSeconds = 0.0;
+    // Combined digest of every symbol's trades; equal digests mean equal runs
+    uint64_t digest = 0;
+    std::vector<std::string> symbols;
+    std::vector<SymbolResult> perSymbol;    // indexed like symbols
+
+    double pnl() const { return static_cast<double>(pnlFixed) / static_cast<double>(kPriceScale); }
+    // symbol,orders,trades,volume,rejected,pnl,last_price,digest
+    void writeCsv(std::ostream& out) const;
+};
+
+// Replays a BacktestReader through per-symbol order books as fast as the
+// input can be parsed. The calling thread reads and routes each order to
+// worker symbolId % workers over an SPSC ring; each worker owns the books
+// and P&L for its symbols. A symbol is only ever touched by one worker,
+// in input order, so results don't depend on thread timing and are
+// bit-identical from run to run. All workers share one node pool sized
+// from BacktestReader::orderBound(), so it cannot run out and results don't
+// depend on the worker count either. Rings apply backpressure instead of
+// dropping.
+class Backtester {
+public:
+    explicit Backtester(unsigned workers = 1, double tickSize = kDefaultTickSize);
+
+    BacktestResult run(BacktestReader& reader);
+
+private:
+    unsigned workers_;
+    double tickSize_;
+};
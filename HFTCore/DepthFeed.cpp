@@ -0,0 +1,119 @@
+#include "pch.h"
+#include "DepthFeed.hpp"
+#include "TscClock.hpp"
+#include <iostream>
+
+static const char kDepthMagic[8] = { 'H', 'F', 'T', 'D', 'E', 'P', 'T', 'H' };
+static const uint32_t kDepthVersion = 1;
+
+static size_t namesOffset() {
+    return sizeof(DepthRegionHeader);
+}
+
+static size_t slotsOffset(uint32_t maxSymbols) {
+    size_t end = namesOffset() + size_t(maxSymbols) * kDepthSymbolNameSize;
+    return (end + alignof(DepthSlot) - 1) & ~(alignof(DepthSlot) - 1);
+}
+
+static size_t regionSize(uint32_t slots, uint32_t maxSymbols) {
+    return slotsOffset(maxSymbols) + size_t(slots) * sizeof(DepthSlot);
+}
+
+DepthPublisher::~DepthPublisher() {
+    close();
+}
+
+bool DepthPublisher::open(const std::string& name, uint32_t slots, uint32_t maxSymbols) {
+    close();
+    uint32_t count = 2;
+    while (count < slots) count <<= 1;
+    // Pre-faulted, so the book thread never takes a page fault
+    if (!region_.create(name, regionSize(count, maxSymbols))) {
+        std::cerr << "[DepthFeed] Cannot create shared memory " << name << std::endl;
+        return false;
+    }
+    char* base = region_.data();
+    header_ = reinterpret_cast<DepthRegionHeader*>(base);
+    names_ = base + namesOffset();
+    slots_ = reinterpret_cast<DepthSlot*>(base + slotsOffset(maxSymbols));
+    mask_ = count - 1;
+    next_ = 0;
+    maxSymbols_ = maxSymbols;
+
+    // The region starts zeroed. The magic goes in last, so a reader
+    // opening early sees either nothing or a complete header.
+    header_->version = kDepthVersion;
+    header_->slotCount = count;
+    header_->slotSize = sizeof(DepthSlot);
+    header_->depthLevels = kDepthLevels;
+    header_->maxSymbols = maxSymbols;
+    header_->symbolNameSize = kDepthSymbolNameSize;
+    header_->createdRealtimeNs = TscClock::realtimeNanos();
+    header_->writeIndex.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header_->magic, kDepthMagic, sizeof(kDepthMagic));
+    return true;
+}
+
+void DepthPublisher::close() {
+    region_.close();
+    header_ = nullptr;
+    names_ = nullptr;
+    slots_ = nullptr;
+}
+
+void DepthPublisher::nameSymbol(uint32_t symbolId, const char* name) {
+    if (!names_ || symbolId >= maxSymbols_) return;
+    char* slot = names_ + size_t(symbolId) * kDepthSymbolNameSize;
+    strncpy(slot, name, kDepthSymbolNameSize - 1);
+    slot[kDepthSymbolNameSize - 1] = '\0';
+}
+
+DepthReader::~DepthReader() {
+    close();
+}
+
+bool DepthReader::open(const std::string& name) {
+    close();
+    if (!region_.open(name, false)) return false;
+    const char* base = region_.data();
+    const auto* header = reinterpret_cast<const DepthRegionHeader*>(base);
+    if (region_.size() < sizeof(DepthRegionHeader) || memcmp(header->magic, kDepthMagic, sizeof(kDepthMagic)) != 0 ||
+        header->version != kDepthVersion || header->slotSize != sizeof(DepthSlot) ||
+        header->depthLevels != kDepthLevels || header->symbolNameSize != kDepthSymbolNameSize ||
+        region_.size() < regionSize(header->slotCount, header->maxSymbols)) {
+        std::cerr << "[DepthFeed] " << name << " is not a depth feed this build can read" << std::endl;
+        close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    header_ = header;
+    names_ = base + namesOffset();
+    slots_ = reinterpret_cast<const DepthSlot*>(base + slotsOffset(header->maxSymbols));
+    mask_ = header->slotCount - 1;
+    maxSymbols_ = header->maxSymbols;
+    next_ = header->writeIndex.load(std::memory_order_acquire);
+    received_ = 0;
+    overruns_ = 0;
+    return true;
+}
+
+void DepthReader::close() {
+    region_.close();
+    header_ = nullptr;
+    names_ = nullptr;
+    slots_ = nullptr;
+}
+
+const char* DepthReader::symbolName(uint32_t symbolId) const {
+    if (!names_ || symbolId >= maxSymbols_) return "";
+    return names_ + size_t(symbolId) * kDepthSymbolNameSize;
+}
+
+void DepthReader::skipAhead() {
+    uint64_t head = header_->writeIndex.load(std::memory_order_acquire);
+    if (head > next_) {
+        overruns_ += head - next_;
+        next_ = head;
+    }
+}
@@ -0,0 +1,188 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include "SharedMemory.hpp"
+
+// Shared-memory broadcast of book depth to other processes on the host.
+//
+// The book thread writes DepthMessages into a ring of fixed-size slots in
+// a named shared-memory region; any number of reader processes map it
+// read-only and follow along. Nothing is ever sent back: a reader that
+// falls a whole ring behind is lapped and skips ahead (counted as an
+// overrun), so a slow or stopped reader never holds up the book.
+//
+// Each slot is guarded by a seqlock. While message n is being written its
+// slot's sequence is 2n+1, and 2n+2 once complete. A reader expecting
+// message n copies the slot only when it reads 2n+2 both before and after
+// the copy, so a read never takes a lock or a syscall.
+//
+// Region layout: a DepthRegionHeader, then the symbol directory
+// (maxSymbols names of kDepthSymbolNameSize bytes, indexed by symbol id),
+// then slotCount DepthSlots.
+
+constexpr size_t kDepthLevels = 10;
+constexpr size_t kDepthSymbolNameSize = 16;
+
+struct DepthLevel {
+    int64_t price;          // 1 / kPriceScale units
+    uint32_t qty;           // total resting quantity; 0 in an update: the level is gone
+    uint32_t orders;
+};
+
+enum class DepthMessageType : uint8_t {
+    Snapshot = 1,           // top levels of both sides; replaces the symbol's view
+    LevelUpdate = 2         // one level changed: it is bids[0] or asks[0]
+};
+
+struct DepthMessage {
+    uint8_t type;
+    uint8_t bidCount;
+    uint8_t askCount;
+    uint8_t reserved;
+    uint32_t symbolId;
+    // Per symbol, one per message; a jump means this reader missed updates
+    // for the symbol and should wait for the next snapshot
+    uint64_t bookSequence;
+    // TscClock::now() at publish. Every process on the host reads the same
+    // counter, so a reader can time the hop.
+    uint64_t publishTicks;
+    DepthLevel bids[kDepthLevels];      // best first
+    DepthLevel asks[kDepthLevels];
+};
+
+struct alignas(64) DepthSlot {
+    std::atomic<uint64_t> sequence;
+    DepthMessage message;
+};
+
+struct DepthRegionHeader {
+    char magic[8];                  // "HFTDEPTH"
+    uint32_t version;
+    uint32_t slotCount;             // power of two
+    uint32_t slotSize;
+    uint32_t depthLevels;
+    uint32_t maxSymbols;
+    uint32_t symbolNameSize;
+    uint64_t createdRealtimeNs;
+    // Number of the next message to be published; new readers start here
+    alignas(64) std::atomic<uint64_t> writeIndex;
+};
+
+static_assert(sizeof(DepthMessage) == 24 + 2 * kDepthLevels * sizeof(DepthLevel), "DepthMessage layout changed");
+static_assert(sizeof(DepthRegionHeader) == 128, "DepthRegionHeader layout changed");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory sequences must be lock-free");
+
+// Writer side. One thread publishes; open() and close() belong to it too.
+class DepthPublisher {
+public:
+    static constexpr uint32_t kDefaultSlots = 1 << 14;
+    static constexpr uint32_t kDefaultMaxSymbols = 4096;
+
+    DepthPublisher() = default;
+    ~DepthPublisher();
+    DepthPublisher(const DepthPublisher&) = delete;
+    DepthPublisher& operator=(const DepthPublisher&) = delete;
+
+    // Creates the region, replacing any left over under the same name.
+    // name is a POSIX shared-memory name such as "/hft_depth" (a named
+    // mapping on Windows). slots is rounded up to a power of two.
+    bool open(const std::string& name, uint32_t slots = kDefaultSlots, uint32_t maxSymbols = kDefaultMaxSymbols);
+    // Unmaps and removes the name; readers still mapped keep what they have
+    void close();
+    bool isOpen() const { return region_.isOpen(); }
+
+    // Readers look names up by the ids in the messages. Set a name before
+    // the first message that uses its id.
+    void nameSymbol(uint32_t symbolId, const char* name);
+
+    // Claims the next slot. Fill in the message, then commit().
+    DepthMessage& begin() {
+        DepthSlot& slot = slots_[next_ & mask_];
+        slot.sequence.store(2 * next_ + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return slot.message;
+    }
+
+    void commit() {
+        slots_[next_ & mask_].sequence.store(2 * next_ + 2, std::memory_order_release);
+        header_->writeIndex.store(++next_, std::memory_order_release);
+    }
+
+    uint64_t published() const { return next_; }
+    uint32_t maxSymbols() const { return maxSymbols_; }
+
+private:
+    SharedRegion region_;
+    DepthRegionHeader* header_ = nullptr;
+    char* names_ = nullptr;
+    DepthSlot* slots_ = nullptr;
+    uint64_t mask_ = 0;
+    uint64_t next_ = 0;
+    uint32_t maxSymbols_ = 0;
+};
+
+// Reader side, in any process. The mapping is read-only.
+class DepthReader {
+public:
+    DepthReader() = default;
+    ~DepthReader();
+    DepthReader(const DepthReader&) = delete;
+    DepthReader& operator=(const DepthReader&) = delete;
+
+    // False if no publisher has created the region. Reading starts with
+    // the next message published.
+    bool open(const std::string& name);
+    void close();
+    bool isOpen() const { return region_.isOpen(); }
+
+    // Copies the next message into out; false if there is none yet
+    bool poll(DepthMessage& out) {
+        const DepthSlot& slot = slots_[next_ & mask_];
+        const uint64_t complete = 2 * next_ + 2;
+        const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before != complete) {
+            // Below: not published yet. Above: the slot was reused.
+            if (before > complete) skipAhead();
+            return false;
+        }
+        // Counts come from the copy and may be torn; clamp before using them
+        memcpy(&out, &slot.message, offsetof(DepthMessage, bids));
+        const size_t bids = out.bidCount < kDepthLevels ? out.bidCount : kDepthLevels;
+        const size_t asks = out.askCount < kDepthLevels ? out.askCount : kDepthLevels;
+        memcpy(out.bids, slot.message.bids, bids * sizeof(DepthLevel));
+        memcpy(out.asks, slot.message.asks, asks * sizeof(DepthLevel));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != complete) {
+            skipAhead();
+            return false;
+        }
+        ++next_;
+        ++received_;
+        return true;
+    }
+
+    // Empty if the id has no name yet
+    const char* symbolName(uint32_t symbolId) const;
+    uint64_t received() const { return received_; }
+    // Messages overwritten before this reader got to them
+    uint64_t overruns() const { return overruns_; }
+    // Messages published but not yet read
+    uint64_t backlog() const { return header_->writeIndex.load(std::memory_order_acquire) - next_; }
+
+private:
+    // Lapped: resume at the newest message and let snapshots resync
+    void skipAhead();
+
+    SharedRegion region_;
+    const DepthRegionHeader* header_ = nullptr;
+    const char* names_ = nullptr;
+    const DepthSlot* slots_ = nullptr;
+    uint64_t mask_ = 0;
+    uint64_t next_ = 0;
+    uint32_t maxSymbols_ = 0;
+    uint64_t received_ = 0;
+    uint64_t overruns_ = 0;
+};
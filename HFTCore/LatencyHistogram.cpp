@@ -0,0 +1,81 @@
+#include "pch.h"
+#include "LatencyHistogram.hpp"
+#include <cmath>
+
+void LatencyHistogram::reset() {
+    for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+void HistogramSnapshot::merge(const LatencyHistogram& h) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+        uint64_t c = h.counts_[i].load(std::memory_order_relaxed);
+        counts_[i] += c;
+        total += c;
+    }
+    // Derive the count from the buckets so percentiles stay consistent
+    // even if the writer was mid-record
+    count_ += total;
+    sum_ += h.sum_.load(std::memory_order_relaxed);
+    uint64_t lo = h.min_.load(std::memory_order_relaxed);
+    uint64_t hi = h.max_.load(std::memory_order_relaxed);
+    if (lo < min_) min_ = lo;
+    if (hi > max_) max_ = hi;
+}
+
+void HistogramSnapshot::merge(const HistogramSnapshot& other) {
+    for (size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    if (other.min_ < min_) min_ = other.min_;
+    if (other.max_ > max_) max_ = other.max_;
+}
+
+uint64_t HistogramSnapshot::percentile(double q) const {
+    if (count_ == 0) return 0;
+    if (q < 0.0) q = 0.0;
+    if (q > 1.0) q = 1.0;
+    // Rank of the sample at quantile q (1-based, rounded up)
+    uint64_t rank = static_cast<uint64_t>(std::ceil(q * double(count_)));
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            uint64_t v = LatencyHistogram::bucketHigh(i);
+            return v < max_ ? v : max_;
+        }
+    }
+    return max_;
+}
+
+void HistogramSnapshot::writeSummaryHeader(std::ostream& out) {
+    out << "stage,count,min_ns,mean_ns,p50_ns,p90_ns,p99_ns,p99.9_ns,p99.99_ns,max_ns\n";
+}
+
+void HistogramSnapshot::writeSummaryRow(std::ostream& out, const std::string& name) const {
+    out << name << ',' << count() << ',' << min() << ',' << static_cast<uint64_t>(mean()) << ','
+        << percentile(0.50) << ',' << percentile(0.90) << ',' << percentile(0.99) << ','
+        << percentile(0.999) << ',' << percentile(0.9999) << ',' << max() << '\n';
+}
+
+void HistogramSnapshot::writeBucketsHeader(std::ostream& out) {
+    out << "stage,low_ns,high_ns,count,cumulative_fraction\n";
+}
+
+void HistogramSnapshot::writeBuckets(std::ostream& out, const std::string& name) const {
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+        if (!counts_[i]) continue;
+        seen += counts_[i];
+        out << name << ',' << LatencyHistogram::bucketLow(i) << ',' << LatencyHistogram::bucketHigh(i) << ','
+            << counts_[i] << ',' << double(seen) / double(count_) << '\n';
+    }
+}
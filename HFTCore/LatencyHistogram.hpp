@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Utils.hpp"
+
+// HDR-style log-linear histogram of nanosecond latencies. Values below 128
+// get exact buckets. Above that, each power of two is split into 64
+// buckets, so any recorded value is off by at most 1/64 (~1.6%). Values
+// past 2^41 ns (~36 minutes) land in the last bucket.
+//
+// One thread records. record() is a relaxed load and store per counter,
+// which is a plain mov on x86: no locked instructions and no fences.
+// Other threads read through HistogramSnapshot, which may see a recording
+// half done (count bumped but not yet max). That error is one sample, and
+// it is fine for monitoring.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 7;
+    static constexpr int kMaxExponent = 40;
+    static constexpr size_t kHalf = size_t(1) << (kSubBucketBits - 1);
+    static constexpr size_t kBucketCount = (kMaxExponent - kSubBucketBits + 3) * kHalf;
+
+    LatencyHistogram() { reset(); }
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t ns) {
+        bump(counts_[bucketIndex(ns)], 1);
+        bump(count_, 1);
+        bump(sum_, ns);
+        if (ns > max_.load(std::memory_order_relaxed)) max_.store(ns, std::memory_order_relaxed);
+        if (ns < min_.load(std::memory_order_relaxed)) min_.store(ns, std::memory_order_relaxed);
+    }
+
+    // Writer only
+    void reset();
+
+    static size_t bucketIndex(uint64_t ns) {
+        if (ns < (uint64_t(1) << kSubBucketBits)) return static_cast<size_t>(ns);
+        int shift = static_cast<int>(highestSetBit(ns)) - kSubBucketBits + 1;
+        if (shift > kMaxExponent - kSubBucketBits + 1) return kBucketCount - 1;
+        return shift * kHalf + static_cast<size_t>(ns >> shift);
+    }
+    // Smallest and largest value mapping to a bucket
+    static uint64_t bucketLow(size_t idx) {
+        if (idx < 2 * kHalf) return idx;
+        size_t shift = idx / kHalf - 1;
+        return uint64_t(idx - shift * kHalf) << shift;
+    }
+    static uint64_t bucketHigh(size_t idx) {
+        if (idx < 2 * kHalf) return idx;
+        size_t shift = idx / kHalf - 1;
+        return ((uint64_t(idx - shift * kHalf) + 1) << shift) - 1;
+    }
+
+private:
+    friend class HistogramSnapshot;
+
+    static void bump(std::atomic<uint64_t>& c, uint64_t by) {
+        c.store(c.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> counts_[kBucketCount];
+    alignas(64) std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+};
+
+// Plain copy of one or more histograms, for readers. Merging several
+// per-thread histograms gives the combined distribution.
+class HistogramSnapshot {
+public:
+    HistogramSnapshot() : counts_(LatencyHistogram::kBucketCount, 0) {}
+    explicit HistogramSnapshot(const LatencyHistogram& h) : HistogramSnapshot() { merge(h); }
+
+    void merge(const LatencyHistogram& h);
+    void merge(const HistogramSnapshot& other);
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? double(sum_) / double(count_) : 0.0; }
+    // Value at quantile q in [0, 1], reported as the top of its bucket and
+    // clamped to the recorded max; 0 when empty
+    uint64_t percentile(double q) const;
+
+    // One row: name,count,min,mean,p50,p90,p99,p99.9,p99.99,max
+    static void writeSummaryHeader(std::ostream& out);
+    void writeSummaryRow(std::ostream& out, const std::string& name) const;
+    // Non-empty buckets: name,low_ns,high_ns,count,cumulative_fraction
+    static void writeBucketsHeader(std::ostream& out);
+    void writeBuckets(std::ostream& out, const std::string& name) const;
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
@@ -1,50 +1,156 @@
 #pragma once
 #include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
 #include "Order.hpp"
 
+// Bounded multi-producer/multi-consumer queue (Vyukov). Every slot carries
+// a sequence number telling producers and consumers whose turn it is, so
+// each operation is one CAS on the shared position plus one release store
+// on the slot. Capacity is rounded up to a power of two and allocated once.
+// enqueue returns false when the queue is full, dequeue when it is empty.
 template<typename T>
 class LockFreeQueue {
-    struct Node { T value; std::atomic<Node*> next; };
-    std::atomic<Node*> head_, tail_;
+    struct Slot {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> enqueuePos_{ 0 };
+    alignas(64) std::atomic<size_t> dequeuePos_{ 0 };
+
 public:
-    LockFreeQueue();
-    ~LockFreeQueue();
-    void enqueue(const T& item);
+    explicit LockFreeQueue(size_t capacity = 1 << 16);
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    bool enqueue(const T& item);
     bool dequeue(T& result);
+
+    // Claim up to count consecutive slots with a single CAS. Returns how many
+    // items were transferred (0 when full / empty).
+    size_t enqueueBulk(const T* items, size_t count);
+    size_t dequeueBulk(T* out, size_t maxCount);
+
+    size_t capacity() const { return mask_ + 1; }
+    // Approximate when called concurrently
+    size_t size() const {
+        return enqueuePos_.load(std::memory_order_relaxed) - dequeuePos_.load(std::memory_order_relaxed);
+    }
 };
 
 template<typename T>
-LockFreeQueue<T>::LockFreeQueue() {
-    Node* dummy = new Node{ T(), nullptr };
-    head_.store(dummy); tail_.store(dummy);
+LockFreeQueue<T>::LockFreeQueue(size_t capacity) {
+    size_t cap = 2;
+    while (cap < capacity) cap <<= 1;
+    slots_.reset(new Slot[cap]);
+    mask_ = cap - 1;
+    for (size_t i = 0; i < cap; ++i) {
+        slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
 }
 
 template<typename T>
-LockFreeQueue<T>::~LockFreeQueue() {
-    Node* node = head_.load();
-    while (node) {
-        Node* next = node->next.load();
-        delete node;
-        node = next;
+bool LockFreeQueue<T>::enqueue(const T& item) {
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots_[pos & mask_];
+        size_t seq = slot.seq.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.value = item;
+                slot.seq.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0) {
+            return false;
+        }
+        else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
     }
 }
 
 template<typename T>
-void LockFreeQueue<T>::enqueue(const T& item) {
-    Node* node = new Node{ item, nullptr };
-    Node* prev = tail_.exchange(node);
-    prev->next.store(node, std::memory_order_release);
+bool LockFreeQueue<T>::dequeue(T& result) {
+    size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots_[pos & mask_];
+        size_t seq = slot.seq.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                result = slot.value;
+                slot.seq.store(pos + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0) {
+            return false;
+        }
+        else {
+            pos = dequeuePos_.load(std::memory_order_relaxed);
+        }
+    }
 }
 
 template<typename T>
-bool LockFreeQueue<T>::dequeue(T& result) {
-    Node* head = head_.load();
-    Node* next = head->next.load(std::memory_order_acquire);
-    if (!next) return false;
-    result = next->value;
-    head_.store(next);
-    delete head;
-    return true;
+size_t LockFreeQueue<T>::enqueueBulk(const T* items, size_t count) {
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        // Count the consecutive slots that are free for this lap. Once the
+        // CAS succeeds nobody else can claim them, so the scan stays valid.
+        size_t n = 0;
+        while (n < count && n <= mask_ &&
+            slots_[(pos + n) & mask_].seq.load(std::memory_order_acquire) == pos + n) {
+            ++n;
+        }
+        if (n == 0) {
+            size_t seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos) < 0) return 0;
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (enqueuePos_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+            for (size_t i = 0; i < n; ++i) {
+                Slot& slot = slots_[(pos + i) & mask_];
+                slot.value = items[i];
+                slot.seq.store(pos + i + 1, std::memory_order_release);
+            }
+            return n;
+        }
+    }
+}
+
+template<typename T>
+size_t LockFreeQueue<T>::dequeueBulk(T* out, size_t maxCount) {
+    size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        size_t n = 0;
+        while (n < maxCount && n <= mask_ &&
+            slots_[(pos + n) & mask_].seq.load(std::memory_order_acquire) == pos + n + 1) {
+            ++n;
+        }
+        if (n == 0) {
+            size_t seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) return 0;
+            pos = dequeuePos_.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (dequeuePos_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+            for (size_t i = 0; i < n; ++i) {
+                Slot& slot = slots_[(pos + i) & mask_];
+                out[i] = slot.value;
+                slot.seq.store(pos + i + mask_ + 1, std::memory_order_release);
+            }
+            return n;
+        }
+    }
 }
 
 // Explicit instantiation for Order
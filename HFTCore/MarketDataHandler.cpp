@@ -1,15 +1,27 @@
 #include "pch.h"
 #include "MarketDataHandler.hpp"
 #include "Utils.hpp"
+#include "TscClock.hpp"
 #include <iostream>
-#include <sstream>
 #include <string>
+#include <cstring>
 #include <algorithm>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/uio.h>
+#endif
+#ifdef __linux__
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+#endif
 
-MarketDataHandler::MarketDataHandler(LockFreeQueue<Order>& q, int port, bool enableSynthetic, int syntheticRate)
+MarketDataHandler::MarketDataHandler(OrderRing& q, int port, bool enableSynthetic, int syntheticRate)
     : orderQueue_(q), udpPort_(port), enableSyntheticData_(enableSynthetic), syntheticDataRate_(syntheticRate),
-    sock_(INVALID_SOCKET), priceDistribution_(90.0, 110.0), qtyDistribution_(10, 1000)
+    priceDistribution_(90.0, 110.0), qtyDistribution_(10, 1000)
 {
+    for (SOCKET& s : socks_) s = INVALID_SOCKET;
+    lines_[0].port = port;
     uint64_t seed64 = std::chrono::steady_clock::now().time_since_epoch().count();
     uint32_t seed32 = static_cast<uint32_t>(seed64 ^ (seed64 >> 32));
     rng_ = std::mt19937(seed32);
@@ -29,6 +41,14 @@ MarketDataHandler::~MarketDataHandler() {
 #endif
 }
 
+void MarketDataHandler::setFeedLines(const FeedLine& a, const FeedLine& b, const std::string& iface) {
+    lines_[0] = a;
+    lines_[1] = b;
+    lineCount_ = b.port ? 2 : 1;
+    multicastInterface_ = iface;
+    udpPort_ = a.port;
+}
+
 #ifdef _WIN32
 bool MarketDataHandler::initializeWinsock() {
     WSADATA wsadata;
@@ -45,7 +65,23 @@ void MarketDataHandler::start() {
         std::cout << "[MarketDataHandler] Already running" << std::endl;
         return;
     }
-    if (!initializeSocket()) {
+    if (replay_) {
+        // Replay replaces the socket entirely, and decodes the datagrams
+        // the way they were captured
+        if (replay_->wireFormat() != wireFormat_) {
+            std::cerr << "[MarketDataHandler] Journal holds "
+                << (replay_->wireFormat() == WireFormat::Binary ? "binary" : "ASCII")
+                << " datagrams but the handler decodes "
+                << (wireFormat_ == WireFormat::Binary ? "binary" : "ASCII") << std::endl;
+            return;
+        }
+        replayFinished_.store(false);
+    }
+    else if (!shmFeedName_.empty()) {
+        if (!shmFeed_.create(shmFeedName_)) return;
+        shmWriterAlive_ = false;
+    }
+    else if (!initializeSocket()) {
         std::cerr << "[MarketDataHandler] Failed to initialize UDP socket" << std::endl;
         if (enableSyntheticData_) {
             std::cout << "[MarketDataHandler] Falling back to synthetic data generation" << std::endl;
@@ -56,7 +92,22 @@ void MarketDataHandler::start() {
     }
     running_.store(true);
     recvThread_ = std::thread(&MarketDataHandler::recvLoop, this);
-    std::cout << "[MarketDataHandler] Started on UDP port " << udpPort_ << std::endl;
+    if (replay_) {
+        std::cout << "[MarketDataHandler] Started replaying journal" << std::endl;
+    }
+    else if (shmFeed_.isOpen()) {
+        std::cout << "[MarketDataHandler] Reading shared-memory feed " << shmFeedName_ << std::endl;
+    }
+    else if (!lines_[0].group.empty()) {
+        std::cout << "[MarketDataHandler] Joined";
+        for (int i = 0; i < lineCount_; ++i) {
+            std::cout << (i ? ", " : " ") << lines_[i].group << ":" << lines_[i].port << " (line " << char('A' + i) << ")";
+        }
+        std::cout << std::endl;
+    }
+    else {
+        std::cout << "[MarketDataHandler] Started on UDP port " << udpPort_ << std::endl;
+    }
 }
 
 void MarketDataHandler::stop() {
@@ -66,103 +117,345 @@ void MarketDataHandler::stop() {
         recvThread_.join();
     }
     cleanupSocket();
+    shmFeed_.close();
     std::cout << "[MarketDataHandler] Stopped" << std::endl;
 }
 
 bool MarketDataHandler::initializeSocket() {
-    sock_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (sock_ == INVALID_SOCKET) {
+    if (lineCount_ > 1 && wireFormat_ != WireFormat::Binary) {
+        // ASCII messages carry no sequence number to arbitrate on
+        std::cerr << "[MarketDataHandler] A/B arbitration needs the binary wire format; using line A only" << std::endl;
+        lineCount_ = 1;
+    }
+    for (int i = 0; i < lineCount_; ++i) {
+        socks_[i] = openLine(lines_[i]);
+        if (socks_[i] == INVALID_SOCKET) {
+            cleanupSocket();
+            return false;
+        }
+    }
+    return true;
+}
+
+SOCKET MarketDataHandler::openLine(const FeedLine& line) {
+    SOCKET sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == INVALID_SOCKET) {
 #ifdef _WIN32
         std::cerr << "[MarketDataHandler] Socket creation failed: " << WSAGetLastError() << std::endl;
 #else
         std::cerr << "[MarketDataHandler] Socket creation failed: " << errno << std::endl;
 #endif
-        return false;
+        return INVALID_SOCKET;
     }
     // Set non-blocking
 #ifdef _WIN32
     u_long mode = 1;
-    if (ioctlsocket(sock_, FIONBIO, &mode) != NO_ERROR) {
-        closesocket(sock_);
-        sock_ = INVALID_SOCKET;
-        return false;
+    if (ioctlsocket(sock, FIONBIO, &mode) != NO_ERROR) {
+        closesocket(sock);
+        return INVALID_SOCKET;
     }
 #else
-    int flags = fcntl(sock_, F_GETFL, 0);
-    fcntl(sock_, F_SETFL, flags | O_NONBLOCK);
+    int flags = fcntl(sock, F_GETFL, 0);
+    fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+#endif
+#ifdef SO_BUSY_POLL
+    if (busyPollMicros_ > 0 &&
+        setsockopt(sock, SOL_SOCKET, SO_BUSY_POLL, &busyPollMicros_, sizeof(busyPollMicros_)) != 0) {
+        std::cerr << "[MarketDataHandler] SO_BUSY_POLL not applied: " << errno << std::endl;
+    }
+#endif
+#ifdef SO_TIMESTAMPING
+    // Software receive timestamps: when the kernel took the datagram off the
+    // NIC, delivered as a cmsg alongside each datagram
+    int tsFlags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPING, &tsFlags, sizeof(tsFlags)) != 0) {
+        std::cerr << "[MarketDataHandler] SO_TIMESTAMPING not applied: " << errno << std::endl;
+    }
+#endif
+    if (receiveBufferBytes_ > 0) {
+        bool applied = false;
+#ifdef SO_RCVBUFFORCE
+        // Goes past net.core.rmem_max when the process has CAP_NET_ADMIN
+        applied = setsockopt(sock, SOL_SOCKET, SO_RCVBUFFORCE, &receiveBufferBytes_, sizeof(receiveBufferBytes_)) == 0;
 #endif
+        if (!applied) {
+            setsockopt(sock, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&receiveBufferBytes_),
+                sizeof(receiveBufferBytes_));
+        }
+        int granted = 0;
+        socklen_t len = sizeof(granted);
+        if (getsockopt(sock, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<char*>(&granted), &len) == 0) {
+#ifdef __linux__
+            granted /= 2;   // Linux reports twice the size, to cover its bookkeeping
+#endif
+            if (granted < receiveBufferBytes_) {
+                std::cerr << "[MarketDataHandler] SO_RCVBUF capped at " << granted
+                    << " bytes; raise net.core.rmem_max for " << receiveBufferBytes_ << std::endl;
+            }
+        }
+    }
 
-    serverAddr_.sin_family = AF_INET;
-    serverAddr_.sin_port = htons(udpPort_);
-    serverAddr_.sin_addr.s_addr = INADDR_ANY;
-    if (bind(sock_, (sockaddr*)&serverAddr_, sizeof(serverAddr_)) == SOCKET_ERROR) {
-        closesocket(sock_);
-        sock_ = INVALID_SOCKET;
-        return false;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(line.port));
+    addr.sin_addr.s_addr = INADDR_ANY;
+    ip_mreq membership{};
+    const bool multicast = !line.group.empty();
+    if (multicast) {
+        if (inet_pton(AF_INET, line.group.c_str(), &membership.imr_multiaddr) <= 0 ||
+            !IN_MULTICAST(ntohl(membership.imr_multiaddr.s_addr))) {
+            std::cerr << "[MarketDataHandler] Not a multicast group: " << line.group << std::endl;
+            closesocket(sock);
+            return INVALID_SOCKET;
+        }
+        membership.imr_interface.s_addr = INADDR_ANY;
+        if (!multicastInterface_.empty() &&
+            inet_pton(AF_INET, multicastInterface_.c_str(), &membership.imr_interface) <= 0) {
+            std::cerr << "[MarketDataHandler] Invalid interface address: " << multicastInterface_ << std::endl;
+            closesocket(sock);
+            return INVALID_SOCKET;
+        }
+        // Other subscribers on this host can join the same group and port
+        int reuse = 1;
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+#ifdef __linux__
+        // Bound to the group, and with IP_MULTICAST_ALL off, the socket only
+        // sees its own line even when A and B share a port. Elsewhere give
+        // the lines distinct ports.
+        addr.sin_addr = membership.imr_multiaddr;
+        int all = 0;
+        setsockopt(sock, IPPROTO_IP, IP_MULTICAST_ALL, &all, sizeof(all));
+#endif
     }
-    return true;
+    if (bind(sock, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR) {
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    if (multicast && setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP,
+        reinterpret_cast<const char*>(&membership), sizeof(membership)) != 0) {
+        std::cerr << "[MarketDataHandler] Joining " << line.group << " failed: " << errno << std::endl;
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    return sock;
 }
 
 void MarketDataHandler::cleanupSocket() {
-    if (sock_ != INVALID_SOCKET) {
-        closesocket(sock_);
-        sock_ = INVALID_SOCKET;
+    for (SOCKET& s : socks_) {
+        if (s != INVALID_SOCKET) {
+            closesocket(s);
+            s = INVALID_SOCKET;
+        }
     }
 }
 
 void MarketDataHandler::recvLoop() {
     pinThread(3);
-    char buffer[1500];
-    sockaddr_in clientAddr;
-#ifdef _WIN32
-    int clientAddrLen = sizeof(clientAddr);
-#else
-    socklen_t clientAddrLen = sizeof(clientAddr);
+
+    // Preallocated receive buffers and decode staging: nothing on the
+    // receive path allocates, and each batch reaches the ring in one pushBulk
+    constexpr size_t kRxBufferSize = 2048;
+    const size_t batch = (receiveMode_ == ReceiveMode::Batched) ? static_cast<size_t>(batchSize_) : 1;
+    // A binary datagram can hold no more adds than fit its receive buffer
+    const size_t ordersPerDatagram = (wireFormat_ == WireFormat::Binary) ? kRxBufferSize / sizeof(AddOrderMessage) : 1;
+    const size_t stagingCapacity = batch * ordersPerDatagram;
+    std::vector<char> rxBuffers(batch * kRxBufferSize);
+    std::unique_ptr<Order[]> staging(new Order[stagingCapacity]);
+#ifdef __linux__
+    constexpr size_t kControlSize = CMSG_SPACE(sizeof(scm_timestamping));
+    std::vector<mmsghdr> msgs(batch);
+    std::vector<iovec> iovs(batch);
+    std::vector<char> control(batch * kControlSize);
+    for (size_t i = 0; i < batch; ++i) {
+        iovs[i].iov_base = &rxBuffers[i * kRxBufferSize];
+        iovs[i].iov_len = kRxBufferSize;
+        msgs[i] = mmsghdr{};
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
 #endif
+
     int syntheticCount = 0;
     auto lastSyntheticTime = std::chrono::steady_clock::now();
+    // Wire and kernel stamps are CLOCK_REALTIME; re-anchoring keeps them
+    // mapped right across wall-clock steps
+    const uint64_t reanchorTicks = TscClock::fromNanos(1000000000);
+    uint64_t lastAnchor = TscClock::now();
 
-    while (running_.load()) {
-        bool receivedUdpData = false;
-        if (sock_ != INVALID_SOCKET) {
-            int bytesReceived = recvfrom(sock_, buffer, sizeof(buffer), 0,
-                (sockaddr*)&clientAddr, &clientAddrLen);
-            if (bytesReceived > 0) {
-                try {
-                    Order order = parseMarketData(buffer, bytesReceived);
-                    orderQueue_.enqueue(order);
-                    std::cout << "[MarketDataHandler] Received UDP order: "
-                        << order.symbol << " $" << order.price
-                        << " x" << order.qty << std::endl;
-                    receivedUdpData = true;
+    while (running_.load(std::memory_order_relaxed)) {
+        const uint64_t loopTicks = TscClock::now();
+        if (loopTicks - lastAnchor >= reanchorTicks) {
+            TscClock::reanchor();
+            lastAnchor = loopTicks;
+        }
+        int datagrams = 0;
+        if (replay_) {
+            size_t staged = 0;
+            bool eof = false;
+            datagrams = replayBatch(staging.get(), stagingCapacity, batch, staged, eof);
+            if (staged) publishBulk(staging.get(), staged);
+            // Only once the last batch is in the ring, so a consumer that
+            // sees the flag and an empty ring has seen every record
+            if (eof) replayFinished_.store(true, std::memory_order_release);
+        }
+        else if (shmFeed_.isOpen()) {
+            size_t staged = 0;
+            datagrams = shmBatch(staging.get(), stagingCapacity, batch, staged);
+            if (staged) publishBulk(staging.get(), staged);
+        }
+        else {
+            // A/B lines are polled in turn; the arbiter sorts out which copy is first
+            for (int line = 0; line < lineCount_; ++line) {
+                if (socks_[line] == INVALID_SOCKET) continue;
+                size_t staged = 0;
+#ifdef __linux__
+                for (size_t i = 0; i < batch; ++i) {
+                    // The kernel shrinks msg_controllen to what it wrote
+                    msgs[i].msg_hdr.msg_control = &control[i * kControlSize];
+                    msgs[i].msg_hdr.msg_controllen = kControlSize;
                 }
-                catch (const std::exception& e) {
-                    std::cerr << "[MarketDataHandler] Error parsing UDP data: " << e.what() << std::endl;
+                int received = recvmmsg(socks_[line], msgs.data(), static_cast<unsigned>(batch), MSG_DONTWAIT, nullptr);
+                if (received > 0) {
+                    datagrams += received;
+                    RxInfo rx{ std::chrono::steady_clock::now(), TscClock::now(), line };
+                    for (int i = 0; i < received; ++i) {
+                        RxInfo msgRx = rx;
+                        uint64_t kernelTicks = kernelRxTicks(&msgs[i].msg_hdr);
+                        if (kernelTicks && kernelTicks < rx.ticks) msgRx.ticks = kernelTicks;
+                        if (journal_) {
+                            journal_->append(&rxBuffers[i * kRxBufferSize], msgs[i].msg_len, msgRx.ticks);
+                        }
+                        staged += decodeDatagram(&rxBuffers[i * kRxBufferSize], static_cast<int>(msgs[i].msg_len),
+                            &staging[staged], stagingCapacity - staged, msgRx);
+                    }
+                }
+#else
+                int bytesReceived = recvfrom(socks_[line], rxBuffers.data(), static_cast<int>(kRxBufferSize), 0,
+                    nullptr, nullptr);
+                if (bytesReceived > 0) {
+                    ++datagrams;
+                    RxInfo rx{ std::chrono::steady_clock::now(), TscClock::now(), line };
+                    if (journal_) {
+                        journal_->append(rxBuffers.data(), static_cast<uint32_t>(bytesReceived), rx.ticks);
+                    }
+                    staged = decodeDatagram(rxBuffers.data(), bytesReceived, &staging[0], stagingCapacity, rx);
                 }
+#endif
+                if (staged) publishBulk(staging.get(), staged);
             }
         }
 
-        if (enableSyntheticData_ && !receivedUdpData) {
+        if (datagrams > 0) continue;
+
+        if (enableSyntheticData_ && !replay_ && !shmFeed_.isOpen()) {
             auto now = std::chrono::steady_clock::now();
             auto timeSinceLastSynthetic = std::chrono::duration_cast<std::chrono::milliseconds>(
                 now - lastSyntheticTime).count();
             if (timeSinceLastSynthetic >= (1000 / syntheticDataRate_)) {
-                Order syntheticOrder = generateSyntheticOrder();
-                orderQueue_.enqueue(syntheticOrder);
-                if (syntheticCount < 10) {
-                    std::cout << "[MarketDataHandler] Generated synthetic order " << (syntheticCount + 1)
-                        << ": " << syntheticOrder.symbol
-                        << " $" << syntheticOrder.price
-                        << " x" << syntheticOrder.qty << std::endl;
-                }
+                Order synthetic = generateSyntheticOrder();
+                synthetic.stamps.enqueued = synthetic.stamps.since(TscClock::now());
+                publish(synthetic);
                 syntheticCount++;
                 lastSyntheticTime = now;
             }
         }
-        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        idle();
     }
     std::cout << "[MarketDataHandler] Receive loop finished. Generated "
-        << syntheticCount << " synthetic orders." << std::endl;
+        << syntheticCount << " synthetic orders, " << parseErrors() << " parse errors." << std::endl;
+    if (arbitrated()) {
+        std::cout << "[MarketDataHandler] A/B arbitration: line A first " << arbiter_.wins(0)
+            << ", line B first " << arbiter_.wins(1) << ", gaps filled " << arbiter_.recovered()
+            << ", duplicates dropped " << arbiter_.duplicates() << ", late " << arbiter_.late()
+            << ", lost " << arbiter_.lostMessages() << std::endl;
+    }
+}
+
+int MarketDataHandler::replayBatch(Order* out, size_t capacity, size_t maxRecords, size_t& staged, bool& eof) {
+    if (replayFinished_.load(std::memory_order_relaxed)) return 0;
+    int consumed = 0;
+    while (static_cast<size_t>(consumed) < maxRecords) {
+        if (!replayHasPending_) {
+            if (!replay_->next(replayPending_)) {
+                replayHasPending_ = false;
+                replayFirstRecorded_ = replayFirstLocal_ = 0;
+                eof = true;
+                break;
+            }
+            replayHasPending_ = true;
+        }
+        uint64_t now = TscClock::now();
+        if (replayPacing_ == ReplayPacing::AsRecorded) {
+            if (!replayFirstLocal_) {
+                replayFirstRecorded_ = replayPending_.rxTicks;
+                replayFirstLocal_ = now;
+            }
+            uint64_t recordedTicks = replayPending_.rxTicks > replayFirstRecorded_
+                ? replayPending_.rxTicks - replayFirstRecorded_ : 0;
+            double dueNs = static_cast<double>(recordedTicks) * replay_->nsPerTick();
+            if (static_cast<double>(TscClock::toNanos(now - replayFirstLocal_)) < dueNs) break;
+        }
+        // Records are re-stamped on replay, so stage latencies describe this run
+        RxInfo rx{ std::chrono::steady_clock::now(), now };
+        staged += decodeDatagram(replayPending_.data, static_cast<int>(replayPending_.length), &out[staged],
+            capacity - staged, rx);
+        replayHasPending_ = false;
+        ++consumed;
+    }
+    return consumed;
+}
+
+int MarketDataHandler::shmBatch(Order* out, size_t capacity, size_t maxDatagrams, size_t& staged) {
+    shmFeed_.heartbeat();
+    if (shmFeed_.peerAlive() != shmWriterAlive_) {
+        shmWriterAlive_ = shmFeed_.peerAlive();
+        std::cout << "[MarketDataHandler] Shared-memory feed writer "
+            << (shmWriterAlive_ ? "attached" : "went silent") << std::endl;
+    }
+    uint32_t length = 0;
+    const char* data = shmFeed_.peek(0, length);
+    if (!data) return 0;
+    // Decoded straight out of the ring; the slots go back in one store
+    RxInfo rx{ std::chrono::steady_clock::now(), TscClock::now() };
+    size_t count = 0;
+    do {
+        if (journal_) journal_->append(data, length, rx.ticks);
+        staged += decodeDatagram(data, static_cast<int>(length), &out[staged], capacity - staged, rx);
+        ++count;
+    } while (count < maxDatagrams && (data = shmFeed_.peek(count, length)) != nullptr);
+    shmFeed_.release(count);
+    return static_cast<int>(count);
+}
+
+void MarketDataHandler::idle() {
+    switch (idlePolicy_) {
+    case IdlePolicy::Sleep:
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        break;
+    case IdlePolicy::Yield:
+        std::this_thread::yield();
+        break;
+    case IdlePolicy::Spin:
+        cpuRelax();
+        break;
+    }
+}
+
+void MarketDataHandler::publish(const Order& order) {
+    if (!orderQueue_.tryPush(order)) {
+        droppedOrders_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void MarketDataHandler::publishBulk(Order* orders, size_t count) {
+    uint64_t now = TscClock::now();
+    for (size_t i = 0; i < count; ++i) {
+        orders[i].stamps.enqueued = orders[i].stamps.since(now);
+    }
+    size_t pushed = orderQueue_.pushBulk(orders, count);
+    if (pushed < count) {
+        droppedOrders_.fetch_add(count - pushed, std::memory_order_relaxed);
+    }
 }
 
 // check later
@@ -183,50 +476,92 @@ Order MarketDataHandler::generateSyntheticOrder() {
 #else
     snprintf(order.symbol, sizeof(order.symbol), "SYN%03d", orderCount % 1000);
 #endif
+    if (symbols_) order.symbolId = symbols_->intern(order.symbol);
+    order.stamps.rx = TscClock::now();
+    order.stamps.parsed = order.stamps.since(TscClock::now());
     orderCount++;
     return order;
 }
 
-Order MarketDataHandler::parseMarketData(const char* buffer, int length) {
-    std::string data(buffer, length);
-    std::stringstream ss(data);
-    std::string token;
-    Order order{};
-    int fieldIndex = 0;
-    while (std::getline(ss, token, ',') && fieldIndex < 4) {
-        switch (fieldIndex) {
-        case 0:
-#ifdef _WIN32
-            strncpy_s(order.symbol, sizeof(order.symbol), token.c_str(), _TRUNCATE);
-#else
-            strncpy(order.symbol, token.c_str(), sizeof(order.symbol) - 1);
-            order.symbol[sizeof(order.symbol) - 1] = '\0';
-#endif
-            break;
-        case 1:
-            order.price = std::stod(token);
-            break;
-        case 2:
-            order.qty = std::stoi(token);
-            break;
-        case 3:
-            order.side = (token == "BUY") ? OrderSide::BUY : OrderSide::SELL;
-            break;
-        }
-        fieldIndex++;
-    }
-    if (fieldIndex < 4) {
-        if (strlen(order.symbol) == 0) {
-#ifdef _WIN32
-            strcpy_s(order.symbol, "DEFAULT");
-#else
-            strcpy(order.symbol, "DEFAULT");
-#endif
+ParseError MarketDataHandler::parseMarketData(const char* buffer, int length, Order& order) {
+    ParseError err = parseOrderMessage(buffer, static_cast<size_t>(length), order);
+    if (err != ParseError::None) return err;
+    if (symbols_) order.symbolId = symbols_->intern(order.symbol);
+    // Text messages carry no id; clear whatever the reused slot held so a
+    // feed order can never look like a strategy's
+    order.id = 0;
+    // Feed messages carry a price, so they rest on the book when they don't cross
+    order.type = OrderType::Limit;
+    return ParseError::None;
+}
+
+size_t MarketDataHandler::decodeDatagram(const char* buffer, int length, Order* out, size_t capacity, const RxInfo& rx) {
+    if (wireFormat_ == WireFormat::Binary) {
+        return decodeBinaryPacket(buffer, length, out, capacity, rx);
+    }
+    if (!capacity) {
+        parseErrors_.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    if (parseMarketData(buffer, length, *out) != ParseError::None) {
+        parseErrors_.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    out->timestamp = rx.time;
+    out->stamps = OrderStamps{};
+    out->stamps.rx = rx.ticks;
+    out->stamps.parsed = out->stamps.since(TscClock::now());
+    return 1;
+}
+
+size_t MarketDataHandler::decodeBinaryPacket(const char* buffer, int length, Order* out, size_t capacity,
+    const RxInfo& rx) {
+    size_t decoded = 0;
+    bool overflowed = false;
+    const PacketHeader* header = nullptr;
+    uint64_t sentTicks = 0;
+    DecodeResult result = decodePacket(buffer, static_cast<size_t>(length), header,
+        [&](const AddOrderMessage& m, uint64_t seq) {
+            // Past the staging space the rest are dropped before the sequence
+            // check, so the next packet reports them as a gap
+            if (decoded == capacity) {
+                overflowed = true;
+                return;
+            }
+            if (!arbiter_.accept(seq, rx.line)) return;
+            Order& order = out[decoded];
+            // Delivered, so it counts for sequencing, but not an order
+            if (!toOrder(m, order)) {
+                parseErrors_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            ++decoded;
+            if (!sentTicks) sentTicks = TscClock::fromRealtimeNanos(header->sendTimestamp);
+            order.timestamp = rx.time;
+            order.symbolId = symbols_ ? symbols_->intern(order.symbol) : kInvalidSymbolId;
+            order.stamps = OrderStamps{};
+            order.stamps.rx = rx.ticks;
+            order.stamps.markSent(sentTicks);
+            order.stamps.parsed = order.stamps.since(TscClock::now());
+        });
+    if (result != DecodeResult::Ok || overflowed) {
+        parseErrors_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return decoded;
+}
+
+#ifdef __linux__
+uint64_t MarketDataHandler::kernelRxTicks(msghdr* msg) {
+    for (cmsghdr* c = CMSG_FIRSTHDR(msg); c; c = CMSG_NXTHDR(msg, c)) {
+        if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPING) {
+            scm_timestamping ts;
+            memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+            // ts[0] is the software stamp, in CLOCK_REALTIME
+            if (ts.ts[0].tv_sec == 0 && ts.ts[0].tv_nsec == 0) return 0;
+            uint64_t ns = uint64_t(ts.ts[0].tv_sec) * 1000000000ull + uint64_t(ts.ts[0].tv_nsec);
+            return TscClock::fromRealtimeNanos(ns);
         }
-        if (order.price <= 0) order.price = 100.0;
-        if (order.qty <= 0) order.qty = 100;
     }
-    order.type = OrderType::Market;
-    order.timestamp = std::chrono::steady_clock::now();
-    return order;
+    return 0;
 }
+#endif
@@ -3,7 +3,10 @@
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <algorithm>
 #include <random>
+#include <memory>
+#include <string>
 
 #ifdef _WIN32
 #ifndef NOMINMAX
@@ -23,39 +26,185 @@
 #define closesocket close
 #endif
 
-#include "LockFreeQueue.hpp"
+#include "SpscRing.hpp"
 #include "Order.hpp"
+#include "SymbolTable.hpp"
+#include "MarketDataParser.hpp"
+#include "WireProtocol.hpp"
+#include "PacketJournal.hpp"
+#include "ShmFeed.hpp"
+
+// Hop from the receive thread to the order-processing worker
+using OrderRing = SpscRing<Order, 1 << 16>;
+
+enum class ReceiveMode {
+    Simple,     // one datagram per receive call
+    Batched     // up to batchSize datagrams per recvmmsg (Linux; Simple elsewhere)
+};
+
+enum class ReplayPacing {
+    AsRecorded,         // reproduce the recorded inter-arrival gaps
+    AsFastAsPossible
+};
+
+// What the receive thread does when the socket has nothing for it
+enum class IdlePolicy {
+    Sleep,      // 100us nap: cheap on CPU, adds up to 100us of latency
+    Yield,
+    Spin        // busy-poll; give the thread a dedicated core
+};
+
+// One feed line: a multicast group and port, or a unicast port when group
+// is empty
+struct FeedLine {
+    std::string group;
+    int port = 0;
+};
 
 class MarketDataHandler {
 private:
-    SOCKET sock_;
+    // One socket per line; only [0] in the usual single-line setup
+    SOCKET socks_[LineArbiter::kMaxLines];
     std::thread recvThread_;
     std::atomic<bool> running_{ false };
-    LockFreeQueue<Order>& orderQueue_;
+    OrderRing& orderQueue_;
+    std::atomic<uint64_t> droppedOrders_{ 0 };
+    std::atomic<uint64_t> parseErrors_{ 0 };
+    SymbolTable* symbols_ = nullptr;
 
     int udpPort_;
+    WireFormat wireFormat_ = WireFormat::Ascii;
+    FeedLine lines_[LineArbiter::kMaxLines];
+    int lineCount_ = 1;
+    std::string multicastInterface_;
+    int receiveBufferBytes_ = kDefaultReceiveBuffer;
+    // Binary feed sequence check. Used for a single line too, so datagrams
+    // reordered in flight (one generator, several sender threads) are
+    // taken rather than dropped as duplicates.
+    LineArbiter arbiter_;
+    ReceiveMode receiveMode_ = ReceiveMode::Simple;
+    IdlePolicy idlePolicy_ = IdlePolicy::Sleep;
+    int batchSize_ = 32;
+    int busyPollMicros_ = 0;
+    JournalWriter* journal_ = nullptr;
+    JournalReader* replay_ = nullptr;
+    // Shared-memory ring in place of the sockets when a name is set
+    std::string shmFeedName_;
+    ShmFeedReader shmFeed_;
+    bool shmWriterAlive_ = false;
+    ReplayPacing replayPacing_ = ReplayPacing::AsFastAsPossible;
+    std::atomic<bool> replayFinished_{ false };
+    // Replay pacing: the record that wasn't due yet, and the recorded and
+    // local times of the first record
+    JournalRecord replayPending_{};
+    bool replayHasPending_ = false;
+    uint64_t replayFirstRecorded_ = 0;
+    uint64_t replayFirstLocal_ = 0;
     bool enableSyntheticData_;
     int syntheticDataRate_;
 
-    sockaddr_in serverAddr_;
-
     std::mt19937 rng_;
     std::uniform_real_distribution<double> priceDistribution_;
     std::uniform_int_distribution<int> qtyDistribution_;
 
 public:
-    MarketDataHandler(LockFreeQueue<Order>& q, int port = 8080, bool enableSynthetic = true, int syntheticRate = 100);
+    MarketDataHandler(OrderRing& q, int port = 8080, bool enableSynthetic = true, int syntheticRate = 100);
     ~MarketDataHandler();
 
     void start();
     void stop();
 
+    // Orders are tagged with their interned symbol id before being queued.
+    // The table must only be written from this handler once started.
+    void setSymbolTable(SymbolTable* symbols) { symbols_ = symbols; }
+
+    // Orders discarded because the worker fell behind and the ring was full
+    uint64_t droppedOrders() const { return droppedOrders_.load(std::memory_order_relaxed); }
+    // Datagrams rejected by the parser, or cut short because they held
+    // more orders than the receive staging has room for, plus binary
+    // messages refused for invalid fields (see toOrder)
+    uint64_t parseErrors() const { return parseErrors_.load(std::memory_order_relaxed); }
+
+    // Must match the generator; set before start()
+    void setWireFormat(WireFormat format) { wireFormat_ = format; }
+    // Binary feed only: sequence numbers not (yet) delivered, and duplicates
+    // dropped
+    uint64_t gapMessages() const { return arbiter_.missing(); }
+    uint64_t duplicateMessages() const { return arbiter_.duplicates(); }
+
+    // Multicast feed: join line A's group, and line B's when given, instead
+    // of listening on the unicast port. Both lines carry the same packets;
+    // the first copy of each message is taken and the other dropped
+    // (LineArbiter), which needs the binary wire format. iface is the local
+    // address to join on; empty lets the kernel pick. Set before start().
+    void setFeedLines(const FeedLine& a, const FeedLine& b = FeedLine{}, const std::string& iface = "");
+    bool arbitrated() const { return lineCount_ > 1; }
+    // Per-line wins, recoveries and losses when two lines are configured
+    const LineArbiter& arbiter() const { return arbiter_; }
+    // SO_RCVBUF for the feed sockets. Large, so a burst or a stall in the
+    // receive thread is absorbed by the kernel rather than dropped.
+    static constexpr int kDefaultReceiveBuffer = 8 << 20;
+    void setReceiveBuffer(int bytes) { receiveBufferBytes_ = bytes; }
+
+    // Receive tuning; set before start()
+    static constexpr int kMaxRecvBatch = 64;
+    void setReceiveMode(ReceiveMode mode, int batchSize = 32) {
+        receiveMode_ = mode;
+        batchSize_ = (std::max)(1, (std::min)(batchSize, kMaxRecvBatch));
+    }
+    void setIdlePolicy(IdlePolicy policy) { idlePolicy_ = policy; }
+    // SO_BUSY_POLL budget in microseconds (Linux, 0 = off); lets the kernel
+    // poll the NIC queue instead of waiting for an interrupt
+    void setBusyPoll(int micros) { busyPollMicros_ = micros; }
+
+    // Capture every raw datagram with its receive time. The writer must be
+    // open before start() and closed after stop().
+    void setJournal(JournalWriter* journal) { journal_ = journal; }
+    // Read datagrams from a journal instead of the UDP socket. They go
+    // through the same decode and enqueue path. Set before start(), which
+    // refuses a journal captured in another wire format.
+    void setReplaySource(JournalReader* reader, ReplayPacing pacing = ReplayPacing::AsFastAsPossible) {
+        replay_ = reader;
+        replayPacing_ = pacing;
+    }
+    bool replayFinished() const { return replayFinished_.load(std::memory_order_acquire); }
+
+    // Read datagrams from a shared-memory ring that MarketDataGen writes
+    // (ShmFeed) instead of from UDP. The handler creates the ring under
+    // this name at start(). Set before start().
+    void setShmFeed(const std::string& name) { shmFeedName_ = name; }
+
 private:
     void recvLoop();
     bool initializeSocket();
+    SOCKET openLine(const FeedLine& line);
     void cleanupSocket();
-    Order parseMarketData(const char* buffer, int length);
+    ParseError parseMarketData(const char* buffer, int length, Order& order);
+    struct RxInfo {
+        std::chrono::steady_clock::time_point time;
+        uint64_t ticks;         // TscClock ticks: kernel receive stamp if available
+        int line = 0;
+    };
+    // Decodes one datagram into at most capacity slots of out[] and
+    // returns how many orders it held
+    size_t decodeDatagram(const char* buffer, int length, Order* out, size_t capacity, const RxInfo& rx);
+    size_t decodeBinaryPacket(const char* buffer, int length, Order* out, size_t capacity, const RxInfo& rx);
+#ifdef __linux__
+    // SO_TIMESTAMPING receive time of a datagram, or 0 if absent
+    static uint64_t kernelRxTicks(msghdr* msg);
+#endif
+    void idle();
+    // Decodes the next due journal records into out[], which holds
+    // capacity orders; returns how many records were consumed. eof is set
+    // when the journal is exhausted; the caller publishes the batch before
+    // marking the replay finished.
+    int replayBatch(Order* out, size_t capacity, size_t maxRecords, size_t& staged, bool& eof);
+    // Decodes up to maxDatagrams from the shared-memory ring into out[];
+    // returns how many datagrams were consumed
+    int shmBatch(Order* out, size_t capacity, size_t maxDatagrams, size_t& staged);
     Order generateSyntheticOrder();
+    void publish(const Order& order);
+    void publishBulk(Order* orders, size_t count);
 
 #ifdef _WIN32
     bool initializeWinsock();
@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "MarketDataParser.hpp"
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HFT_HAVE_SSE2 1
+#endif
+
+const char* toString(ParseError e) {
+    switch (e) {
+    case ParseError::None: return "none";
+    case ParseError::TooLong: return "message too long";
+    case ParseError::MissingField: return "missing field";
+    case ParseError::BadSymbol: return "bad symbol";
+    case ParseError::BadPrice: return "bad price";
+    case ParseError::BadQty: return "bad quantity";
+    case ParseError::BadSide: return "bad side";
+    }
+    return "unknown";
+}
+
+uint64_t findCommas(const char* p, size_t len) {
+    uint64_t mask = 0;
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i comma = _mm256_set1_epi8(',');
+    for (; i + 32 <= len; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, comma)));
+        mask |= uint64_t(bits) << i;
+    }
+#endif
+#if defined(__AVX2__) || defined(HFT_HAVE_SSE2)
+    const __m128i comma16 = _mm_set1_epi8(',');
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, comma16)));
+        mask |= uint64_t(bits) << i;
+    }
+#endif
+    for (; i < len; ++i) {
+        if (p[i] == ',') mask |= uint64_t(1) << i;
+    }
+    return mask;
+}
+
+static inline unsigned nextBit(uint64_t& mask) {
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward64(&idx, mask);
+#else
+    unsigned idx = static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+    mask &= mask - 1;
+    return static_cast<unsigned>(idx);
+}
+
+bool parseFixedPrice(const char* p, size_t len, int64_t& out) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < len && p[i] == '-') {
+        negative = true;
+        ++i;
+    }
+    int64_t whole = 0;
+    size_t digits = 0;
+    for (; i < len && p[i] >= '0' && p[i] <= '9'; ++i) {
+        // Bail before the multiply could overflow; 14 digits leave room for the scale
+        if (++digits > 14) return false;
+        whole = whole * 10 + (p[i] - '0');
+    }
+
+    int64_t frac = 0;
+    int fracDigits = 0;
+    if (i < len && p[i] == '.') {
+        ++i;
+        for (; i < len && p[i] >= '0' && p[i] <= '9'; ++i) {
+            // Digits beyond the fixed-point precision are truncated
+            if (fracDigits < kPriceDecimals) {
+                frac = frac * 10 + (p[i] - '0');
+                ++fracDigits;
+            }
+        }
+    }
+    if (i != len || (digits == 0 && fracDigits == 0)) return false;
+    for (; fracDigits < kPriceDecimals; ++fracDigits) frac *= 10;
+
+    int64_t value = whole * kPriceScale + frac;
+    out = negative ? -value : value;
+    return true;
+}
+
+static inline bool parseUnsigned(const char* p, size_t len, int& out) {
+    if (len == 0 || len > 9) return false;
+    int value = 0;
+    for (size_t i = 0; i < len; ++i) {
+        unsigned d = static_cast<unsigned>(p[i] - '0');
+        if (d > 9) return false;
+        value = value * 10 + static_cast<int>(d);
+    }
+    out = value;
+    return true;
+}
+
+ParseError parseOrderMessage(const char* buffer, size_t length, Order& out) {
+    // Tolerate a trailing line ending
+    while (length > 0 && (buffer[length - 1] == '\n' || buffer[length - 1] == '\r')) --length;
+    if (length > kMaxMessageLength) return ParseError::TooLong;
+
+    uint64_t commas = findCommas(buffer, length);
+    if (!commas) return ParseError::MissingField;
+    const size_t c0 = nextBit(commas);
+    if (!commas) return ParseError::MissingField;
+    const size_t c1 = nextBit(commas);
+    if (!commas) return ParseError::MissingField;
+    const size_t c2 = nextBit(commas);
+    // Anything after a fourth comma is ignored, as before
+    const size_t end = commas ? nextBit(commas) : length;
+
+    if (c0 == 0 || c0 >= sizeof(out.symbol)) return ParseError::BadSymbol;
+    memcpy(out.symbol, buffer, c0);
+    memset(out.symbol + c0, 0, sizeof(out.symbol) - c0);
+
+    int64_t fixedPrice;
+    if (!parseFixedPrice(buffer + c0 + 1, c1 - c0 - 1, fixedPrice) || fixedPrice <= 0) {
+        return ParseError::BadPrice;
+    }
+    int qty;
+    if (!parseUnsigned(buffer + c1 + 1, c2 - c1 - 1, qty) || qty == 0) return ParseError::BadQty;
+
+    const size_t sideLen = end - c2 - 1;
+    if (sideLen < 3 || sideLen > 4) return ParseError::BadSide;
+    uint32_t side = 0;
+    memcpy(&side, buffer + c2 + 1, sideLen);
+    // Little-endian images of "BUY\0" and "SELL"
+    constexpr uint32_t kBuy = 'B' | ('U' << 8) | ('Y' << 16);
+    constexpr uint32_t kSell = 'S' | ('E' << 8) | ('L' << 16) | (uint32_t('L') << 24);
+    if (side == kBuy) out.side = OrderSide::BUY;
+    else if (side == kSell) out.side = OrderSide::SELL;
+    else return ParseError::BadSide;
+
+    out.price = static_cast<double>(fixedPrice) * (1.0 / kPriceScale);
+    out.qty = qty;
+    return ParseError::None;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Order.hpp"
+#include "Price.hpp"
+
+// Allocation-free parser for ASCII feed messages "SYMBOL,PRICE,QTY,SIDE".
+// Works directly on the receive buffer: comma positions come from one
+// SIMD byte-compare pass (AVX2/SSE2, scalar fallback), the price is parsed
+// as fixed point with up to kPriceDecimals fraction digits, and the side is
+// matched with a single 4-byte compare. Malformed input is reported through
+// the return code; nothing throws.
+
+enum class ParseError {
+    None,
+    TooLong,
+    MissingField,
+    BadSymbol,
+    BadPrice,
+    BadQty,
+    BadSide
+};
+
+constexpr size_t kMaxMessageLength = 64;
+
+const char* toString(ParseError e);
+
+// Bitmask of ',' positions in p[0..len), len <= kMaxMessageLength
+uint64_t findCommas(const char* p, size_t len);
+
+// Parses "[-]digits[.digits]" into units of 1 / kPriceScale
+bool parseFixedPrice(const char* p, size_t len, int64_t& out);
+
+// Fills symbol, price, qty and side of `out`; other fields are untouched
+ParseError parseOrderMessage(const char* buffer, size_t length, Order& out);
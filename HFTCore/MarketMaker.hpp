@@ -0,0 +1,98 @@
+#pragma once
+#include <cmath>
+#include <vector>
+#include "Strategy.hpp"
+
+struct MarketMakerConfig {
+    double halfSpread = 0.02;           // quote this far either side of the mid
+    uint32_t quoteQty = 100;
+    int64_t maxPosition = 1000;         // stop quoting the side that would add past this
+    double skewPerShare = 0.00002;      // both quotes move against inventory by this per share
+    double requoteDistance = 0.01;      // replace a quote once its target is this far away
+    double tickSize = kDefaultTickSize;
+};
+
+// Sample strategy: keeps one bid and one ask around each symbol's mid,
+// leaning both against its inventory and pulling the side that would
+// take the position past maxPosition. A quote is only replaced when its
+// target has moved by requoteDistance, so a quiet book costs nothing
+// but the comparison. Per-symbol state is sized up front.
+class MarketMaker : public StrategyBase<MarketMaker> {
+public:
+    explicit MarketMaker(size_t maxSymbols = 4096, MarketMakerConfig config = MarketMakerConfig{})
+        : config_(config), quotes_(maxSymbols) {}
+
+    static const char* name() { return "market maker"; }
+
+    void onBookUpdate(const BookUpdate& u, OrderBuffer& out) {
+        if (u.symbolId >= quotes_.size() || u.bid <= 0.0 || u.ask <= 0.0) return;
+        SymbolQuotes& q = quotes_[u.symbolId];
+        const double fair = (u.bid + u.ask) * 0.5 - static_cast<double>(q.position) * config_.skewPerShare;
+        const double tick = config_.tickSize;
+        const double bid = std::floor((fair - config_.halfSpread) / tick + 1e-9) * tick;
+        const double ask = std::ceil((fair + config_.halfSpread) / tick - 1e-9) * tick;
+        // A side only quotes while a full fill of it stays within maxPosition
+        const int64_t qty = static_cast<int64_t>(config_.quoteQty);
+        update(out, u.symbolId, q.bid, OrderSide::BUY, bid, q.position + qty <= config_.maxPosition);
+        update(out, u.symbolId, q.ask, OrderSide::SELL, ask, q.position - qty >= -config_.maxPosition);
+    }
+
+    void onFill(const Fill& f, OrderBuffer&) {
+        if (f.symbolId >= quotes_.size()) return;
+        SymbolQuotes& q = quotes_[f.symbolId];
+        q.position += f.side == OrderSide::BUY ? static_cast<int64_t>(f.qty) : -static_cast<int64_t>(f.qty);
+        Quote& quote = f.side == OrderSide::BUY ? q.bid : q.ask;
+        if (quote.id != f.orderId) return;
+        // Fully filled quotes are gone; the next update places a new one
+        quote.remaining = f.qty < quote.remaining ? quote.remaining - f.qty : 0;
+        if (!quote.remaining) quote.id = 0;
+    }
+
+    // A refused quote never rested: forget it so the next update replaces
+    // it, rather than waiting for the target to move and cancelling nothing
+    void onReject(const OrderRequest& r, OrderBuffer&) {
+        if (r.symbolId >= quotes_.size()) return;
+        Quote& quote = r.side == OrderSide::BUY ? quotes_[r.symbolId].bid : quotes_[r.symbolId].ask;
+        if (quote.id == r.orderId) quote.id = 0;
+    }
+
+    int64_t position(uint32_t symbolId) const { return symbolId < quotes_.size() ? quotes_[symbolId].position : 0; }
+    // Id and price of the working quote on a side; id 0 when there is none
+    uint64_t quoteId(uint32_t symbolId, OrderSide side) const {
+        return symbolId < quotes_.size() ? quoteOf(symbolId, side).id : 0;
+    }
+    double quotePrice(uint32_t symbolId, OrderSide side) const {
+        return symbolId < quotes_.size() ? quoteOf(symbolId, side).price : 0.0;
+    }
+
+private:
+    struct Quote {
+        uint64_t id = 0;
+        double price = 0.0;
+        uint32_t remaining = 0;
+    };
+    struct SymbolQuotes {
+        Quote bid;
+        Quote ask;
+        int64_t position = 0;
+    };
+
+    const Quote& quoteOf(uint32_t symbolId, OrderSide side) const {
+        return side == OrderSide::BUY ? quotes_[symbolId].bid : quotes_[symbolId].ask;
+    }
+
+    void update(OrderBuffer& out, uint32_t symbolId, Quote& quote, OrderSide side, double target, bool allowed) {
+        if (quote.id) {
+            if (allowed && std::fabs(quote.price - target) < config_.requoteDistance - 1e-9) return;
+            sendCancel(out, symbolId, quote.id);
+            quote.id = 0;
+        }
+        if (!allowed) return;
+        quote.id = sendLimit(out, symbolId, side, target, config_.quoteQty);
+        quote.price = target;
+        quote.remaining = config_.quoteQty;
+    }
+
+    MarketMakerConfig config_;
+    std::vector<SymbolQuotes> quotes_;
+};
@@ -1,40 +1,210 @@
 #pragma once
-#include <bitset>
 #include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
 #include <cstddef>
+#include <cstdint>
 #include <cassert>
 #include "Order.hpp"
 
+// Fixed-capacity object pool. Free slots form an intrusive Treiber stack
+// whose head packs a 32-bit slot index with a 32-bit tag bumped on every
+// update, so a stale CAS can never succeed (no ABA) and no node is ever
+// dereferenced after being handed out. allocate()/deallocate() are O(1)
+// and lock-free from any thread.
+//
+// Threads that churn many objects can hold a LocalCache: it keeps a small
+// magazine of free slots with no atomics on the fast path and moves
+// slots to and from the shared stack in batches.
+//
+// allocate() returns raw storage; construct()/destroy() run the
+// constructor and destructor around it. N is the default capacity; a
+// pool can be given a different one at construction.
 template<typename T, size_t N>
 class MemoryPool {
-    alignas(64) T pool_[N];
-    std::bitset<N> free_;
-    std::atomic<size_t> cursor_{ 0 };
+    static_assert(N > 0 && N < UINT32_MAX, "MemoryPool capacity must fit a 32-bit index");
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct alignas(alignof(T)) Slot {
+        unsigned char bytes[sizeof(T)];
+    };
+
+    size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::unique_ptr<std::atomic<uint32_t>[]> next_;
+    alignas(64) std::atomic<uint64_t> head_;
+    alignas(64) std::atomic<size_t> inUse_{ 0 };
+    std::atomic<size_t> peakInUse_{ 0 };
+
+    static uint64_t pack(uint32_t index, uint32_t tag) { return (uint64_t(tag) << 32) | index; }
+    static uint32_t indexOf(uint64_t head) { return static_cast<uint32_t>(head); }
+    static uint32_t tagOf(uint64_t head) { return static_cast<uint32_t>(head >> 32); }
+
+    T* slotPtr(uint32_t i) { return reinterpret_cast<T*>(&slots_[i]); }
+    uint32_t slotIndex(const T* p) const {
+        ptrdiff_t idx = reinterpret_cast<const Slot*>(p) - &slots_[0];
+        assert(idx >= 0 && idx < static_cast<ptrdiff_t>(capacity_));
+        return static_cast<uint32_t>(idx);
+    }
+
+    size_t popBatch(uint32_t* out, size_t maxCount);
+    void pushChain(uint32_t first, uint32_t last, size_t count);
+    void notePeak(size_t inUse);
+
 public:
-    MemoryPool();
+    class LocalCache;
+
+    explicit MemoryPool(size_t capacity = N);
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    // nullptr when the pool is exhausted
     T* allocate();
     void deallocate(T* ptr);
+
+    template<typename... Args>
+    T* construct(Args&&... args) {
+        T* p = allocate();
+        return p ? new (p) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    void destroy(T* ptr) {
+        ptr->~T();
+        deallocate(ptr);
+    }
+
+    size_t capacity() const { return capacity_; }
+    // Slots not on the shared free list, including those parked in LocalCaches
+    size_t inUse() const { return inUse_.load(std::memory_order_relaxed); }
+    size_t peakInUse() const { return peakInUse_.load(std::memory_order_relaxed); }
+    size_t available() const { return capacity_ - inUse(); }
 };
 
+// Per-thread magazine in front of a shared MemoryPool. Not thread-safe
+// itself: each thread owns its cache. Returns its slots on destruction.
 template<typename T, size_t N>
-MemoryPool<T, N>::MemoryPool() { free_.set(); }
+class MemoryPool<T, N>::LocalCache {
+    static constexpr size_t kSize = 64;
+
+    MemoryPool& pool_;
+    uint32_t items_[kSize];
+    size_t count_ = 0;
+
+    void flush(size_t count) {
+        // Link the top `count` cached slots into a chain and push it with one CAS
+        uint32_t first = items_[count_ - 1];
+        uint32_t last = first;
+        for (size_t i = 1; i < count; ++i) {
+            uint32_t idx = items_[count_ - 1 - i];
+            pool_.next_[last].store(idx, std::memory_order_relaxed);
+            last = idx;
+        }
+        count_ -= count;
+        pool_.pushChain(first, last, count);
+    }
+
+public:
+    explicit LocalCache(MemoryPool& pool) : pool_(pool) {}
+    LocalCache(const LocalCache&) = delete;
+    LocalCache& operator=(const LocalCache&) = delete;
+    ~LocalCache() {
+        if (count_) flush(count_);
+    }
+
+    T* allocate() {
+        if (count_ == 0) {
+            count_ = pool_.popBatch(items_, kSize / 2);
+            if (count_ == 0) return nullptr;
+        }
+        return pool_.slotPtr(items_[--count_]);
+    }
+
+    void deallocate(T* ptr) {
+        if (count_ == kSize) flush(kSize / 2);
+        items_[count_++] = pool_.slotIndex(ptr);
+    }
+
+    template<typename... Args>
+    T* construct(Args&&... args) {
+        T* p = allocate();
+        return p ? new (p) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    void destroy(T* ptr) {
+        ptr->~T();
+        deallocate(ptr);
+    }
+
+    size_t cached() const { return count_; }
+};
+
+template<typename T, size_t N>
+MemoryPool<T, N>::MemoryPool(size_t capacity)
+    : capacity_(capacity), slots_(new Slot[capacity]), next_(new std::atomic<uint32_t>[capacity]) {
+    assert(capacity > 0 && capacity < UINT32_MAX);
+    for (size_t i = 0; i < capacity_; ++i) {
+        next_[i].store(i + 1 < capacity_ ? static_cast<uint32_t>(i + 1) : kNil, std::memory_order_relaxed);
+    }
+    head_.store(pack(0, 0), std::memory_order_release);
+}
 
 template<typename T, size_t N>
 T* MemoryPool<T, N>::allocate() {
-    for (size_t i = cursor_.fetch_add(1) % N, cnt = 0; cnt < N; ++cnt) {
-        if (free_.test(i) && free_.test_and_reset(i)) {
-            return &pool_[i];
+    uint32_t idx;
+    return popBatch(&idx, 1) ? slotPtr(idx) : nullptr;
+}
+
+template<typename T, size_t N>
+void MemoryPool<T, N>::deallocate(T* ptr) {
+    uint32_t idx = slotIndex(ptr);
+    pushChain(idx, idx, 1);
+}
+
+template<typename T, size_t N>
+size_t MemoryPool<T, N>::popBatch(uint32_t* out, size_t maxCount) {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    for (;;) {
+        uint32_t first = indexOf(head);
+        if (first == kNil) return 0;
+        // Walk up to maxCount links. The walk may read links that are being
+        // rewritten concurrently, but then the head tag has moved and the
+        // CAS below fails.
+        size_t n = 0;
+        uint32_t cur = first;
+        out[n++] = cur;
+        uint32_t nextIdx = next_[cur].load(std::memory_order_relaxed);
+        while (n < maxCount && nextIdx != kNil && nextIdx < capacity_) {
+            cur = nextIdx;
+            out[n++] = cur;
+            nextIdx = next_[cur].load(std::memory_order_relaxed);
+        }
+        if (head_.compare_exchange_weak(head, pack(nextIdx, tagOf(head) + 1),
+            std::memory_order_acquire, std::memory_order_acquire)) {
+            notePeak(inUse_.fetch_add(n, std::memory_order_relaxed) + n);
+            return n;
         }
-        i = (i + 1) % N;
     }
-    return nullptr;
 }
 
 template<typename T, size_t N>
-void MemoryPool<T, N>::deallocate(T* ptr) {
-    ptrdiff_t idx = ptr - &pool_[0];
-    assert(idx >= 0 && idx < static_cast<ptrdiff_t>(N));
-    free_.set(static_cast<size_t>(idx));
+void MemoryPool<T, N>::pushChain(uint32_t first, uint32_t last, size_t count) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    for (;;) {
+        next_[last].store(indexOf(head), std::memory_order_relaxed);
+        if (head_.compare_exchange_weak(head, pack(first, tagOf(head) + 1),
+            std::memory_order_release, std::memory_order_relaxed)) {
+            inUse_.fetch_sub(count, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+template<typename T, size_t N>
+void MemoryPool<T, N>::notePeak(size_t inUse) {
+    size_t peak = peakInUse_.load(std::memory_order_relaxed);
+    while (inUse > peak && !peakInUse_.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {
+    }
 }
 
 // Explicit instantiation for Order
@@ -1,6 +1,7 @@
 #pragma once
 #include <chrono>
 #include <cstring>
+#include <cstdint>
 
 enum class OrderType {
     Market,
@@ -14,18 +15,52 @@ enum class OrderSide {
     SELL
 };
 
+constexpr uint32_t kInvalidSymbolId = UINT32_MAX;
+
+// Order ids with the top bit set belong to in-process strategies (see
+// Strategy.hpp); ids taken from a feed must keep it clear
+constexpr uint64_t kStrategyOrderBit = 1ull << 63;
+
+// Pipeline timestamps in TscClock ticks. rx is absolute; the later stamps
+// are 32-bit offsets from it (about a second at 3 GHz, saturating) so the
+// whole set adds 32 bytes to an Order. An offset of 0 means "not taken".
+struct OrderStamps {
+    uint64_t rx = 0;                // kernel receive (SO_TIMESTAMPING), else when read
+    uint32_t sentBefore = 0;        // rx - generator send
+    uint32_t parsed = 0;
+    uint32_t enqueued = 0;
+    uint32_t dequeued = 0;
+    uint32_t applied = 0;           // book finished with the order
+    uint32_t filled = 0;            // first fill emitted
+
+    static uint32_t offset(uint64_t from, uint64_t to) {
+        if (to <= from) return 1;
+        uint64_t d = to - from;
+        return d >= UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(d);
+    }
+    // Offset of `now` from rx, for assigning to one of the stamps
+    uint32_t since(uint64_t now) const { return offset(rx, now); }
+    void markSent(uint64_t sent) {
+        sentBefore = (sent && sent < rx) ? offset(sent, rx) : 0;
+    }
+};
+
 struct Order {
     char symbol[16] = "DEFAULT";
+    uint64_t id = 0;                // 0 = anonymous, cannot be cancelled/modified
+    uint32_t symbolId = kInvalidSymbolId;   // dense id assigned by SymbolTable at ingest
     double price = 0.0;
     int qty = 0;
     OrderType type = OrderType::Market;
     OrderSide side = OrderSide::BUY;
     std::chrono::steady_clock::time_point timestamp;
+    OrderStamps stamps;
 
     Order() : timestamp(std::chrono::steady_clock::now()) {}
 
-    Order(const char* sym, double p, int q, OrderType t = OrderType::Market, OrderSide s = OrderSide::BUY)
-        : price(p), qty(q), type(t), side(s), timestamp(std::chrono::steady_clock::now()) {
+    Order(const char* sym, double p, int q, OrderType t = OrderType::Market, OrderSide s = OrderSide::BUY,
+        uint64_t orderId = 0)
+        : id(orderId), price(p), qty(q), type(t), side(s), timestamp(std::chrono::steady_clock::now()) {
 #ifdef _WIN32
         strncpy_s(symbol, sizeof(symbol), sym, _TRUNCATE);
 #else
@@ -1,13 +1,460 @@
 #pragma once
-#include <map>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
 #include "Order.hpp"
+#include "Price.hpp"
+#include "DepthFeed.hpp"
+#include "PriceLevels.hpp"
+#include "OrderIndex.hpp"
+#include "MemoryPool.hpp"
 #include "LockFreeQueue.hpp"
+#include "TscClock.hpp"
 
-class OrderBook {
-    std::map<double, uint32_t, std::greater<double>> bids_;
-    std::map<double, uint32_t> asks_;
-    LockFreeQueue<Order> inbound_;
+// Execution emitted whenever an incoming order crosses resting liquidity.
+// Trades are reported at the resting (maker) price.
+struct Trade {
+    uint32_t symbolId = kInvalidSymbolId;
+    uint64_t makerId = 0;
+    uint64_t takerId = 0;
+    double price = 0.0;
+    uint32_t qty = 0;
+    OrderSide aggressorSide = OrderSide::BUY;
+    std::chrono::steady_clock::time_point makerTimestamp;
+    std::chrono::steady_clock::time_point takerTimestamp;
+};
+
+// Resting order. Nodes form an intrusive FIFO per price level and carry
+// their own price and side, so a level never has to be pointed back to and
+// the level backends are free to move levels around.
+struct OrderNode {
+    uint64_t id;
+    Price price;
+    uint32_t qty;
+    OrderSide side;
+    std::chrono::steady_clock::time_point timestamp;
+    OrderNode* prev;
+    OrderNode* next;
+};
+
+// Node storage; lock-free, so it may be shared between books on any thread
+using OrderNodePool = MemoryPool<OrderNode, 1 << 20>;
+
+// Level storage selectors for BasicOrderBook
+struct MapBackend {
+    template<typename Level, bool Ascending>
+    using Side = MapLevels<Level, Ascending>;
+};
+
+struct LadderBackend {
+    template<typename Level, bool Ascending>
+    using Side = TickLadder<Level, Ascending>;
+};
+
+template<typename Backend>
+class BasicOrderBook {
 public:
-    void submit(const Order& o);
+    using TradeCallback = std::function<void(const Trade&)>;
+
+    // Without a shared pool the book owns one of ownedPoolCapacity nodes,
+    // which also caps how many orders it can hold resting
+    static constexpr size_t kDefaultOwnedPoolCapacity = 1 << 14;
+
+    explicit BasicOrderBook(double tickSize = kDefaultTickSize, OrderNodePool* pool = nullptr,
+        size_t expectedOrders = 1 << 12, size_t ownedPoolCapacity = kDefaultOwnedPoolCapacity);
+    ~BasicOrderBook();
+    BasicOrderBook(const BasicOrderBook&) = delete;
+    BasicOrderBook& operator=(const BasicOrderBook&) = delete;
+
+    // Queues an order for the next processAll(); false if the inbound queue is full
+    bool submit(const Order& o);
     void processAll();
+
+    // Matches a single order immediately, bypassing the inbound queue.
+    // Returns the quantity that was filled.
+    uint32_t match(const Order& o);
+    // The same, but each trade goes to onTrade(const Trade&) instead of the
+    // trade callback. The sink's type is known here, so a hot consumer
+    // (the strategy path) inlines into the sweep rather than going through
+    // std::function.
+    template<typename OnTrade>
+    uint32_t match(const Order& o, OnTrade&& onTrade);
+
+    // O(1) order-level operations by id. Each returns false if the id is not
+    // resting on the book.
+    bool cancel(uint64_t id);
+    // Reducing quantity keeps time priority; increasing it sends the order
+    // to the back of its level.
+    bool modify(uint64_t id, uint32_t newQty);
+    // Cancel/replace: re-enters the book with new priority and may trade
+    bool replace(uint64_t id, double newPrice, uint32_t newQty);
+
+    void setTradeCallback(TradeCallback cb) { onTrade_ = std::move(cb); }
+    // Stamped on every Trade emitted by this book
+    void setSymbolId(uint32_t id) { symbolId_ = id; }
+    uint32_t symbolId() const { return symbolId_; }
+
+    // Publishes every level change to a shared-memory depth feed, plus a
+    // snapshot of the top kDepthLevels a side after every snapshotEvery
+    // changes so readers that join late or miss updates can resync. The
+    // publisher must only be written from this book's thread.
+    void setDepthPublisher(DepthPublisher* publisher, uint32_t snapshotEvery = 64) {
+        depth_ = publisher;
+        snapshotEvery_ = snapshotEvery ? snapshotEvery : 1;
+        sinceSnapshot_ = snapshotEvery_;
+    }
+    void publishSnapshot();
+
+    bool hasBid() const { return !bids_.empty(); }
+    bool hasAsk() const { return !asks_.empty(); }
+    double bestBid() const { return bids_.empty() ? 0.0 : fromTicks(bids_.bestPrice(), tickSize_); }
+    double bestAsk() const { return asks_.empty() ? 0.0 : fromTicks(asks_.bestPrice(), tickSize_); }
+    // Resting quantity at the best price; 0 when the side is empty
+    uint32_t bestBidQty() const { return bids_.empty() ? 0 : bids_.bestLevel().totalQty; }
+    uint32_t bestAskQty() const { return asks_.empty() ? 0 : asks_.bestLevel().totalQty; }
+    uint32_t volumeAt(OrderSide side, double price) const;
+    // Side and unfilled quantity of a resting order; false if the id is
+    // not resting
+    bool restingOrder(uint64_t id, OrderSide& side, uint32_t& qty) const {
+        const OrderNode* n = id ? index_.find(id) : nullptr;
+        if (!n) return false;
+        side = n->side;
+        qty = n->qty;
+        return true;
+    }
+    size_t bidLevels() const { return bids_.size(); }
+    size_t askLevels() const { return asks_.size(); }
+    size_t restingOrders() const { return index_.size() + anonymousResting_; }
+    double tickSize() const { return tickSize_; }
+
+    uint64_t tradeCount() const { return tradeCount_; }
+    uint64_t tradedVolume() const { return tradedVolume_; }
+    uint64_t rejectedCount() const { return rejectedCount_; }
+
+private:
+    // Kept small: most books are driven through match() directly
+    static constexpr size_t kInboundCapacity = 256;
+
+    struct PriceLevel {
+        uint32_t totalQty = 0;
+        uint32_t orderCount = 0;
+        OrderNode* head = nullptr;
+        OrderNode* tail = nullptr;
+
+        void pushBack(OrderNode* n) {
+            n->prev = tail;
+            n->next = nullptr;
+            if (tail) tail->next = n; else head = n;
+            tail = n;
+            totalQty += n->qty;
+            ++orderCount;
+        }
+
+        void unlink(OrderNode* n) {
+            if (n->prev) n->prev->next = n->next; else head = n->next;
+            if (n->next) n->next->prev = n->prev; else tail = n->prev;
+            totalQty -= n->qty;
+            --orderCount;
+        }
+    };
+
+    using Bids = typename Backend::template Side<PriceLevel, false>;
+    using Asks = typename Backend::template Side<PriceLevel, true>;
+
+    template<typename Levels, typename Crosses, typename OnTrade>
+    uint32_t sweep(Levels& levels, const Order& o, uint32_t remaining, Crosses crosses, OnTrade& onTrade);
+    void rest(uint64_t id, OrderSide side, Price px, uint32_t qty, std::chrono::steady_clock::time_point ts);
+    PriceLevel* levelOf(const OrderNode* n);
+    void removeNode(OrderNode* n, PriceLevel& level);
+    // Depth feed; both are no-ops without a publisher
+    void publishLevel(OrderSide side, Price px, const PriceLevel* level) {
+        if (depth_) publishUpdate(side, px, level);
+    }
+    void publishUpdate(OrderSide side, Price px, const PriceLevel* level);
+    void snapshotIfDue() {
+        if (depth_ && sinceSnapshot_ >= snapshotEvery_) publishSnapshot();
+    }
+    DepthLevel depthLevel(Price px, const PriceLevel* level) const;
+
+    Bids bids_;
+    Asks asks_;
+    std::unique_ptr<OrderNodePool> ownedPool_;
+    OrderNodePool* pool_;
+    OrderIndex<OrderNode> index_;
+    LockFreeQueue<Order> inbound_;
+    TradeCallback onTrade_;
+    double tickSize_;
+    uint32_t symbolId_ = kInvalidSymbolId;
+    size_t anonymousResting_ = 0;
+    uint64_t tradeCount_ = 0;
+    uint64_t tradedVolume_ = 0;
+    uint64_t rejectedCount_ = 0;
+    DepthPublisher* depth_ = nullptr;
+    uint32_t snapshotEvery_ = 64;
+    uint32_t sinceSnapshot_ = 0;
+    uint64_t depthSequence_ = 0;
 };
+
+// std::map levels keyed by tick price
+using OrderBook = BasicOrderBook<MapBackend>;
+// Flat tick-indexed ladder with bitmap best-price search
+using LadderOrderBook = BasicOrderBook<LadderBackend>;
+
+template<typename Backend>
+BasicOrderBook<Backend>::BasicOrderBook(double tickSize, OrderNodePool* pool, size_t expectedOrders,
+    size_t ownedPoolCapacity)
+    : ownedPool_(pool ? nullptr : new OrderNodePool(ownedPoolCapacity)), pool_(pool ? pool : ownedPool_.get()),
+    index_(expectedOrders * 2), inbound_(kInboundCapacity), tickSize_(tickSize) {}
+
+template<typename Backend>
+BasicOrderBook<Backend>::~BasicOrderBook() {
+    // Hand resting nodes back when the pool outlives this book
+    if (ownedPool_) return;
+    auto release = [this](Price, PriceLevel& level) {
+        for (OrderNode* n = level.head; n;) {
+            OrderNode* next = n->next;
+            pool_->deallocate(n);
+            n = next;
+        }
+        return true;
+    };
+    bids_.forEachLevel(release);
+    asks_.forEachLevel(release);
+}
+
+template<typename Backend>
+bool BasicOrderBook<Backend>::submit(const Order& o) {
+    return inbound_.enqueue(o);
+}
+
+template<typename Backend>
+void BasicOrderBook<Backend>::processAll() {
+    Order o;
+    while (inbound_.dequeue(o)) {
+        match(o);
+    }
+}
+
+template<typename Backend>
+uint32_t BasicOrderBook<Backend>::match(const Order& o) {
+    return match(o, [this](const Trade& t) {
+        if (onTrade_) onTrade_(t);
+    });
+}
+
+template<typename Backend>
+template<typename OnTrade>
+uint32_t BasicOrderBook<Backend>::match(const Order& o, OnTrade&& onTrade) {
+    if (o.qty <= 0) return 0;
+    // Stop orders need a trigger engine; they are not accepted yet
+    if (o.type == OrderType::Stop || o.type == OrderType::StopLimit) return 0;
+    // Duplicate ids would make cancels ambiguous
+    if (o.id != 0 && index_.find(o.id)) {
+        ++rejectedCount_;
+        return 0;
+    }
+
+    const bool isLimit = (o.type == OrderType::Limit);
+    const Price px = toTicks(o.price, tickSize_);
+    uint32_t remaining = static_cast<uint32_t>(o.qty);
+
+    if (o.side == OrderSide::BUY) {
+        remaining = sweep(asks_, o, remaining,
+            [&](Price ask) { return !isLimit || ask <= px; }, onTrade);
+    }
+    else {
+        remaining = sweep(bids_, o, remaining,
+            [&](Price bid) { return !isLimit || bid >= px; }, onTrade);
+    }
+
+    // Only the unfilled remainder of a limit order rests; market orders are IOC
+    if (remaining > 0 && isLimit) {
+        rest(o.id, o.side, px, remaining, o.timestamp);
+    }
+    snapshotIfDue();
+    return static_cast<uint32_t>(o.qty) - remaining;
+}
+
+template<typename Backend>
+template<typename Levels, typename Crosses, typename OnTrade>
+uint32_t BasicOrderBook<Backend>::sweep(Levels& levels, const Order& o, uint32_t remaining, Crosses crosses,
+    OnTrade& onTrade) {
+    while (remaining > 0 && !levels.empty()) {
+        Price bestPx = levels.bestPrice();
+        if (!crosses(bestPx)) break;
+
+        PriceLevel& level = levels.bestLevel();
+        while (remaining > 0 && level.head) {
+            OrderNode* maker = level.head;
+            uint32_t fillQty = (std::min)(remaining, maker->qty);
+
+            Trade t;
+            t.symbolId = symbolId_;
+            t.makerId = maker->id;
+            t.takerId = o.id;
+            t.price = fromTicks(bestPx, tickSize_);
+            t.qty = fillQty;
+            t.aggressorSide = o.side;
+            t.makerTimestamp = maker->timestamp;
+            t.takerTimestamp = o.timestamp;
+
+            maker->qty -= fillQty;
+            level.totalQty -= fillQty;
+            remaining -= fillQty;
+            ++tradeCount_;
+            tradedVolume_ += fillQty;
+            if (maker->qty == 0) removeNode(maker, level);
+            onTrade(t);
+        }
+        // One update per level swept, not per fill
+        publishLevel(o.side == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY, bestPx, level.head ? &level : nullptr);
+        if (!level.head) levels.erase(bestPx);
+    }
+    return remaining;
+}
+
+template<typename Backend>
+void BasicOrderBook<Backend>::rest(uint64_t id, OrderSide side, Price px, uint32_t qty,
+    std::chrono::steady_clock::time_point ts) {
+    OrderNode* n = pool_->allocate();
+    if (!n) {
+        ++rejectedCount_;
+        return;
+    }
+    n->id = id;
+    n->price = px;
+    n->qty = qty;
+    n->side = side;
+    n->timestamp = ts;
+    if (id != 0) index_.insert(id, n);
+    else ++anonymousResting_;
+    PriceLevel& level = (side == OrderSide::BUY) ? bids_.insert(px) : asks_.insert(px);
+    level.pushBack(n);
+    publishLevel(side, px, &level);
+}
+
+template<typename Backend>
+typename BasicOrderBook<Backend>::PriceLevel* BasicOrderBook<Backend>::levelOf(const OrderNode* n) {
+    return (n->side == OrderSide::BUY) ? bids_.find(n->price) : asks_.find(n->price);
+}
+
+template<typename Backend>
+void BasicOrderBook<Backend>::removeNode(OrderNode* n, PriceLevel& level) {
+    level.unlink(n);
+    if (n->id != 0) index_.erase(n->id);
+    else --anonymousResting_;
+    pool_->deallocate(n);
+}
+
+template<typename Backend>
+bool BasicOrderBook<Backend>::cancel(uint64_t id) {
+    OrderNode* n = id ? index_.find(id) : nullptr;
+    if (!n) return false;
+    PriceLevel* level = levelOf(n);
+    const OrderSide side = n->side;
+    const Price px = n->price;
+    removeNode(n, *level);
+    publishLevel(side, px, level->head ? level : nullptr);
+    if (!level->head) {
+        if (side == OrderSide::BUY) bids_.erase(px); else asks_.erase(px);
+    }
+    snapshotIfDue();
+    return true;
+}
+
+template<typename Backend>
+bool BasicOrderBook<Backend>::modify(uint64_t id, uint32_t newQty) {
+    if (newQty == 0) return cancel(id);
+    OrderNode* n = id ? index_.find(id) : nullptr;
+    if (!n) return false;
+    PriceLevel* level = levelOf(n);
+    if (newQty <= n->qty) {
+        level->totalQty -= n->qty - newQty;
+        n->qty = newQty;
+    }
+    else {
+        level->unlink(n);
+        n->qty = newQty;
+        n->timestamp = std::chrono::steady_clock::now();
+        level->pushBack(n);
+    }
+    publishLevel(n->side, n->price, level);
+    snapshotIfDue();
+    return true;
+}
+
+template<typename Backend>
+bool BasicOrderBook<Backend>::replace(uint64_t id, double newPrice, uint32_t newQty) {
+    OrderNode* n = id ? index_.find(id) : nullptr;
+    if (!n) return false;
+    const OrderSide side = n->side;
+    cancel(id);
+    if (newQty > 0) {
+        Order o;
+        o.id = id;
+        o.price = newPrice;
+        o.qty = static_cast<int>(newQty);
+        o.type = OrderType::Limit;
+        o.side = side;
+        match(o);
+    }
+    return true;
+}
+
+template<typename Backend>
+uint32_t BasicOrderBook<Backend>::volumeAt(OrderSide side, double price) const {
+    const Price px = toTicks(price, tickSize_);
+    const PriceLevel* level = (side == OrderSide::BUY) ? bids_.find(px) : asks_.find(px);
+    return level ? level->totalQty : 0;
+}
+
+template<typename Backend>
+DepthLevel BasicOrderBook<Backend>::depthLevel(Price px, const PriceLevel* level) const {
+    DepthLevel d;
+    d.price = static_cast<int64_t>(std::llround(fromTicks(px, tickSize_) * static_cast<double>(kPriceScale)));
+    d.qty = level ? level->totalQty : 0;
+    d.orders = level ? level->orderCount : 0;
+    return d;
+}
+
+template<typename Backend>
+void BasicOrderBook<Backend>::publishUpdate(OrderSide side, Price px, const PriceLevel* level) {
+    DepthMessage& m = depth_->begin();
+    m.type = static_cast<uint8_t>(DepthMessageType::LevelUpdate);
+    m.bidCount = side == OrderSide::BUY ? 1 : 0;
+    m.askCount = side == OrderSide::BUY ? 0 : 1;
+    m.symbolId = symbolId_;
+    m.bookSequence = ++depthSequence_;
+    m.publishTicks = TscClock::now();
+    (side == OrderSide::BUY ? m.bids[0] : m.asks[0]) = depthLevel(px, level);
+    depth_->commit();
+    ++sinceSnapshot_;
+}
+
+template<typename Backend>
+void BasicOrderBook<Backend>::publishSnapshot() {
+    if (!depth_) return;
+    DepthMessage& m = depth_->begin();
+    m.type = static_cast<uint8_t>(DepthMessageType::Snapshot);
+    size_t count = 0;
+    bids_.forEachLevel([&](Price px, PriceLevel& level) {
+        m.bids[count] = depthLevel(px, &level);
+        return ++count < kDepthLevels;
+    });
+    m.bidCount = static_cast<uint8_t>(count);
+    count = 0;
+    asks_.forEachLevel([&](Price px, PriceLevel& level) {
+        m.asks[count] = depthLevel(px, &level);
+        return ++count < kDepthLevels;
+    });
+    m.askCount = static_cast<uint8_t>(count);
+    m.symbolId = symbolId_;
+    m.bookSequence = ++depthSequence_;
+    m.publishTicks = TscClock::now();
+    depth_->commit();
+    sinceSnapshot_ = 0;
+}
+
+extern template class BasicOrderBook<MapBackend>;
+extern template class BasicOrderBook<LadderBackend>;
@@ -0,0 +1,6 @@
+#include "pch.h"
+#include "OrderBookManager.hpp"
+
+// Explicit instantiation for both level backends
+template class BasicOrderBookManager<MapBackend>;
+template class BasicOrderBookManager<LadderBackend>;
@@ -0,0 +1,172 @@
+#pragma once
+#include <memory>
+#include <optional>
+#include <functional>
+#include "OrderBook.hpp"
+#include "SymbolTable.hpp"
+
+// Owns one book per interned symbol in a contiguous array indexed by
+// symbol id. Books are created on the first order for their symbol and
+// share a single node pool, so configuring thousands of instruments costs
+// only the array slots until they trade. The pool is the manager's own
+// unless one is passed in, which must outlive the manager.
+template<typename Backend>
+class BasicOrderBookManager {
+public:
+    using Book = BasicOrderBook<Backend>;
+    using TradeCallback = typename Book::TradeCallback;
+
+    explicit BasicOrderBookManager(size_t maxSymbols = 4096, double tickSize = kDefaultTickSize,
+        OrderNodePool* pool = nullptr);
+
+    SymbolTable& symbols() { return symbols_; }
+    const SymbolTable& symbols() const { return symbols_; }
+
+    // Routes by o.symbolId; orders that were not interned at ingest are
+    // interned here as a slow path. Returns the filled quantity.
+    uint32_t match(const Order& o);
+    // Trades go to onTrade instead of the trade callback; see Book::match
+    template<typename OnTrade>
+    uint32_t match(const Order& o, OnTrade&& onTrade);
+    bool cancel(uint32_t symbolId, uint64_t id);
+    bool modify(uint32_t symbolId, uint64_t id, uint32_t newQty);
+    bool replace(uint32_t symbolId, uint64_t id, double newPrice, uint32_t newQty);
+
+    // Book for a symbol id, created on demand
+    Book& book(uint32_t symbolId);
+    // nullptr if no order has reached this symbol yet, or the id is not
+    // one this manager can hold (kInvalidSymbolId included)
+    Book* find(uint32_t symbolId) {
+        return symbolId < symbols_.capacity() && books_[symbolId] ? &*books_[symbolId] : nullptr;
+    }
+    const Book* find(uint32_t symbolId) const {
+        return symbolId < symbols_.capacity() && books_[symbolId] ? &*books_[symbolId] : nullptr;
+    }
+
+    // Receives trades from every book; Trade::symbolId identifies the book
+    void setTradeCallback(TradeCallback cb);
+    // Every book, current and future, publishes its depth here and names
+    // its symbol in the feed's directory (see Book::setDepthPublisher)
+    void setDepthPublisher(DepthPublisher* publisher, uint32_t snapshotEvery = 64);
+
+    size_t activeBooks() const { return activeBooks_; }
+    uint64_t tradeCount() const;
+    uint64_t tradedVolume() const;
+
+private:
+    // Book slot for an order, interning its symbol on the slow path;
+    // kInvalidSymbolId when the table is full or the id is out of range
+    uint32_t routeOf(const Order& o);
+
+    SymbolTable symbols_;
+    std::unique_ptr<OrderNodePool> ownedPool_;
+    OrderNodePool* pool_;
+    std::unique_ptr<std::optional<Book>[]> books_;
+    TradeCallback onTrade_;
+    DepthPublisher* depth_ = nullptr;
+    uint32_t snapshotEvery_ = 64;
+    double tickSize_;
+    size_t activeBooks_ = 0;
+};
+
+using OrderBookManager = BasicOrderBookManager<MapBackend>;
+
+template<typename Backend>
+BasicOrderBookManager<Backend>::BasicOrderBookManager(size_t maxSymbols, double tickSize, OrderNodePool* pool)
+    : symbols_(maxSymbols), ownedPool_(pool ? nullptr : new OrderNodePool()), pool_(pool ? pool : ownedPool_.get()),
+    books_(new std::optional<Book>[maxSymbols]), tickSize_(tickSize) {}
+
+template<typename Backend>
+typename BasicOrderBookManager<Backend>::Book& BasicOrderBookManager<Backend>::book(uint32_t symbolId) {
+    std::optional<Book>& slot = books_[symbolId];
+    if (!slot) {
+        // Small initial index; it grows with the book instead of reserving
+        // worst-case space for every instrument
+        slot.emplace(tickSize_, pool_, 64);
+        slot->setSymbolId(symbolId);
+        if (onTrade_) slot->setTradeCallback(onTrade_);
+        if (depth_) {
+            depth_->nameSymbol(symbolId, symbols_.name(symbolId));
+            slot->setDepthPublisher(depth_, snapshotEvery_);
+        }
+        ++activeBooks_;
+    }
+    return *slot;
+}
+
+template<typename Backend>
+uint32_t BasicOrderBookManager<Backend>::routeOf(const Order& o) {
+    if (o.symbolId == kInvalidSymbolId) return symbols_.intern(o.symbol);
+    return o.symbolId < symbols_.capacity() ? o.symbolId : kInvalidSymbolId;
+}
+
+template<typename Backend>
+uint32_t BasicOrderBookManager<Backend>::match(const Order& o) {
+    const uint32_t symbolId = routeOf(o);
+    return symbolId == kInvalidSymbolId ? 0 : book(symbolId).match(o);
+}
+
+template<typename Backend>
+template<typename OnTrade>
+uint32_t BasicOrderBookManager<Backend>::match(const Order& o, OnTrade&& onTrade) {
+    const uint32_t symbolId = routeOf(o);
+    return symbolId == kInvalidSymbolId ? 0 : book(symbolId).match(o, onTrade);
+}
+
+template<typename Backend>
+bool BasicOrderBookManager<Backend>::cancel(uint32_t symbolId, uint64_t id) {
+    Book* b = find(symbolId);
+    return b && b->cancel(id);
+}
+
+template<typename Backend>
+bool BasicOrderBookManager<Backend>::modify(uint32_t symbolId, uint64_t id, uint32_t newQty) {
+    Book* b = find(symbolId);
+    return b && b->modify(id, newQty);
+}
+
+template<typename Backend>
+bool BasicOrderBookManager<Backend>::replace(uint32_t symbolId, uint64_t id, double newPrice, uint32_t newQty) {
+    Book* b = find(symbolId);
+    return b && b->replace(id, newPrice, newQty);
+}
+
+template<typename Backend>
+void BasicOrderBookManager<Backend>::setTradeCallback(TradeCallback cb) {
+    onTrade_ = std::move(cb);
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+        if (books_[i]) books_[i]->setTradeCallback(onTrade_);
+    }
+}
+
+template<typename Backend>
+void BasicOrderBookManager<Backend>::setDepthPublisher(DepthPublisher* publisher, uint32_t snapshotEvery) {
+    depth_ = publisher;
+    snapshotEvery_ = snapshotEvery;
+    for (uint32_t i = 0; i < symbols_.size(); ++i) {
+        if (!books_[i]) continue;
+        if (depth_) depth_->nameSymbol(i, symbols_.name(i));
+        books_[i]->setDepthPublisher(depth_, snapshotEvery_);
+    }
+}
+
+template<typename Backend>
+uint64_t BasicOrderBookManager<Backend>::tradeCount() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+        if (books_[i]) total += books_[i]->tradeCount();
+    }
+    return total;
+}
+
+template<typename Backend>
+uint64_t BasicOrderBookManager<Backend>::tradedVolume() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+        if (books_[i]) total += books_[i]->tradedVolume();
+    }
+    return total;
+}
+
+extern template class BasicOrderBookManager<MapBackend>;
+extern template class BasicOrderBookManager<LadderBackend>;
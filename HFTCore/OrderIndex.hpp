@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// Open-addressing (linear probing) map from order id to resting node.
+// Id 0 is reserved as the empty marker. Erase uses backward-shift deletion,
+// so there are no tombstones and probe chains stay short under heavy
+// cancel/replace churn. The table only grows (doubling) past 50% load;
+// presize it via the constructor to keep the steady state allocation-free.
+template<typename Node>
+class OrderIndex {
+    struct Slot {
+        uint64_t id;
+        Node* node;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    size_t size_ = 0;
+
+    size_t home(uint64_t id) const {
+        return static_cast<size_t>((id * 0x9E3779B97F4A7C15ull) >> 17) & mask_;
+    }
+
+public:
+    explicit OrderIndex(size_t capacity = 1 << 12) {
+        size_t cap = 16;
+        while (cap < capacity) cap <<= 1;
+        slots_.reset(new Slot[cap]());
+        mask_ = cap - 1;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return mask_ + 1; }
+
+    Node* find(uint64_t id) const {
+        for (size_t i = home(id);; i = (i + 1) & mask_) {
+            if (slots_[i].id == id) return slots_[i].node;
+            if (slots_[i].id == 0) return nullptr;
+        }
+    }
+
+    // Returns false if the id is already present
+    bool insert(uint64_t id, Node* node) {
+        if ((size_ + 1) * 2 > capacity()) grow();
+        for (size_t i = home(id);; i = (i + 1) & mask_) {
+            if (slots_[i].id == id) return false;
+            if (slots_[i].id == 0) {
+                slots_[i] = { id, node };
+                ++size_;
+                return true;
+            }
+        }
+    }
+
+    bool erase(uint64_t id) {
+        size_t i = home(id);
+        while (slots_[i].id != id) {
+            if (slots_[i].id == 0) return false;
+            i = (i + 1) & mask_;
+        }
+        // Shift back following entries that probed past the freed slot
+        for (size_t j = (i + 1) & mask_; slots_[j].id != 0; j = (j + 1) & mask_) {
+            size_t h = home(slots_[j].id);
+            if (((j - h) & mask_) >= ((j - i) & mask_)) {
+                slots_[i] = slots_[j];
+                i = j;
+            }
+        }
+        slots_[i] = { 0, nullptr };
+        --size_;
+        return true;
+    }
+
+private:
+    void grow() {
+        std::unique_ptr<Slot[]> old = std::move(slots_);
+        size_t oldCap = mask_ + 1;
+        slots_.reset(new Slot[oldCap * 2]());
+        mask_ = oldCap * 2 - 1;
+        size_ = 0;
+        for (size_t i = 0; i < oldCap; ++i) {
+            if (old[i].id != 0) insert(old[i].id, old[i].node);
+        }
+    }
+};
@@ -0,0 +1,264 @@
+#include "pch.h"
+#include "PacketJournal.hpp"
+#include "TscClock.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const char kJournalMagic[8] = { 'H', 'F', 'T', 'J', 'R', 'N', 'L', '1' };
+static const uint32_t kJournalVersion = 2;     // 2 added wireFormat
+
+struct JournalSegment {
+    char* base = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+    uint32_t index = 0;
+    std::string path;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+JournalWriter::~JournalWriter() {
+    close();
+}
+
+bool JournalWriter::open(const std::string& directory, WireFormat format, const std::string& prefix,
+    size_t segmentBytes) {
+    if (running_.load()) return false;
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    directory_ = directory;
+    prefix_ = prefix;
+    format_ = format;
+    segmentBytes_ = (std::max)(segmentBytes, size_t(1) << 16);
+    nextIndex_.store(0);
+
+    current_ = createSegment(nextIndex_.fetch_add(1));
+    if (!current_) return false;
+    running_.store(true);
+    segmentThread_ = std::thread(&JournalWriter::segmentLoop, this);
+    return true;
+}
+
+void JournalWriter::close() {
+    if (!running_.exchange(false)) return;
+    if (segmentThread_.joinable()) {
+        segmentThread_.join();
+    }
+    JournalSegment* seg;
+    while (retired_.tryPop(seg)) closeSegment(seg);
+    if (current_) {
+        closeSegment(current_);
+        current_ = nullptr;
+    }
+    // An unused spare holds no records; remove it rather than leave an empty segment
+    if (JournalSegment* spare = spare_.exchange(nullptr)) {
+        std::string path = spare->path;
+        spare->used = 0;
+        closeSegment(spare);
+        std::remove(path.c_str());
+        nextIndex_.fetch_sub(1);
+    }
+}
+
+bool JournalWriter::fits(const JournalSegment* seg, size_t need) {
+    return seg->used + need <= seg->capacity;
+}
+
+void JournalWriter::write(JournalSegment* seg, const char* data, uint32_t length, uint64_t rxTicks, size_t need) {
+    JournalRecordHeader h{ length, 0, rxTicks };
+    char* dst = seg->base + seg->used;
+    memcpy(dst, &h, sizeof(h));
+    memcpy(dst + sizeof(h), data, length);
+    seg->used += need;
+}
+
+JournalSegment* JournalWriter::rotate() {
+    JournalSegment* next = spare_.exchange(nullptr, std::memory_order_acquire);
+    if (!next) return nullptr;
+    if (current_ && !retired_.tryPush(current_)) {
+        // Segment thread is far behind; keep the spare for later
+        spare_.store(next, std::memory_order_release);
+        return nullptr;
+    }
+    current_ = next;
+    return current_;
+}
+
+void JournalWriter::segmentLoop() {
+    while (running_.load(std::memory_order_relaxed)) {
+        if (!spare_.load(std::memory_order_acquire)) {
+            JournalSegment* seg = createSegment(nextIndex_.fetch_add(1));
+            if (seg) spare_.store(seg, std::memory_order_release);
+        }
+        JournalSegment* seg;
+        while (retired_.tryPop(seg)) closeSegment(seg);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+JournalSegment* JournalWriter::createSegment(uint32_t index) {
+    char name[32];
+    snprintf(name, sizeof(name), "-%06u.jrnl", index);
+    auto seg = new JournalSegment();
+    seg->path = (std::filesystem::path(directory_) / (prefix_ + name)).string();
+    seg->capacity = segmentBytes_;
+    seg->index = index;
+
+#ifdef _WIN32
+    seg->file = CreateFileA(seg->path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (seg->file != INVALID_HANDLE_VALUE) {
+        seg->mapping = CreateFileMappingA(seg->file, nullptr, PAGE_READWRITE,
+            static_cast<DWORD>(uint64_t(seg->capacity) >> 32), static_cast<DWORD>(seg->capacity), nullptr);
+        if (seg->mapping) {
+            seg->base = static_cast<char*>(MapViewOfFile(seg->mapping, FILE_MAP_WRITE, 0, 0, seg->capacity));
+        }
+    }
+#else
+    seg->fd = ::open(seg->path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (seg->fd >= 0 && posix_fallocate(seg->fd, 0, static_cast<off_t>(seg->capacity)) == 0) {
+        void* p = mmap(nullptr, seg->capacity, PROT_READ | PROT_WRITE, MAP_SHARED, seg->fd, 0);
+        if (p != MAP_FAILED) seg->base = static_cast<char*>(p);
+    }
+#endif
+    if (!seg->base) {
+        std::cerr << "[PacketJournal] Failed to create segment " << seg->path << std::endl;
+        closeSegment(seg);
+        return nullptr;
+    }
+    // Dirty every page here so the receive thread doesn't take the faults.
+    // Reading them in is not enough: MAP_POPULATE leaves a shared file
+    // mapping write-protected, and the first store to each page faults.
+    for (size_t off = 0; off < seg->capacity; off += 4096) seg->base[off] = 0;
+
+    JournalFileHeader h{};
+    memcpy(h.magic, kJournalMagic, sizeof(h.magic));
+    h.version = kJournalVersion;
+    h.segmentIndex = index;
+    h.createdRealtimeNs = TscClock::realtimeNanos();
+    h.createdTicks = TscClock::now();
+    h.nsPerTick = static_cast<double>(TscClock::toNanos(uint64_t(1) << 32)) / 4294967296.0;
+    h.wireFormat = static_cast<uint8_t>(format_);
+    memcpy(seg->base, &h, sizeof(h));
+    seg->used = sizeof(h);
+    return seg;
+}
+
+void JournalWriter::closeSegment(JournalSegment* seg) {
+#ifdef _WIN32
+    if (seg->base) {
+        FlushViewOfFile(seg->base, seg->used);
+        UnmapViewOfFile(seg->base);
+    }
+    if (seg->mapping) CloseHandle(seg->mapping);
+    if (seg->file != INVALID_HANDLE_VALUE) {
+        // Trim the preallocated tail
+        LARGE_INTEGER size;
+        size.QuadPart = static_cast<LONGLONG>(seg->used);
+        SetFilePointerEx(seg->file, size, nullptr, FILE_BEGIN);
+        SetEndOfFile(seg->file);
+        CloseHandle(seg->file);
+    }
+#else
+    if (seg->base) munmap(seg->base, seg->capacity);
+    if (seg->fd >= 0) {
+        // Trim the preallocated tail
+        if (ftruncate(seg->fd, static_cast<off_t>(seg->used)) != 0) {
+            std::cerr << "[PacketJournal] Failed to trim " << seg->path << std::endl;
+        }
+        ::close(seg->fd);
+    }
+#endif
+    delete seg;
+}
+
+bool JournalReader::open(const std::string& path) {
+    files_.clear();
+    fileIndex_ = 0;
+    records_ = 0;
+    std::error_code ec;
+    if (std::filesystem::is_directory(path, ec)) {
+        for (const auto& entry : std::filesystem::directory_iterator(path, ec)) {
+            if (entry.path().extension() == ".jrnl") files_.push_back(entry.path().string());
+        }
+        // Zero-padded indices sort in segment order
+        std::sort(files_.begin(), files_.end());
+    }
+    else {
+        files_.push_back(path);
+    }
+    return !files_.empty() && loadSegment(0);
+}
+
+bool JournalReader::loadSegment(size_t i) {
+    fileIndex_ = i;
+    buffer_.clear();
+    offset_ = 0;
+    std::ifstream in(files_[i], std::ios::binary);
+    if (!in.is_open()) return false;
+    buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+    JournalFileHeader h;
+    if (buffer_.size() < sizeof(h)) return false;
+    memcpy(&h, buffer_.data(), sizeof(h));
+    if (memcmp(h.magic, kJournalMagic, sizeof(h.magic)) != 0 || h.version != kJournalVersion) {
+        std::cerr << "[PacketJournal] Not a journal segment: " << files_[i] << std::endl;
+        return false;
+    }
+    const WireFormat format = static_cast<WireFormat>(h.wireFormat);
+    if (format != WireFormat::Ascii && format != WireFormat::Binary) {
+        std::cerr << "[PacketJournal] Unknown wire format in " << files_[i] << std::endl;
+        return false;
+    }
+    if (i == 0) {
+        wireFormat_ = format;
+    }
+    else if (format != wireFormat_) {
+        std::cerr << "[PacketJournal] Wire format changes at " << files_[i] << std::endl;
+        return false;
+    }
+    nsPerTick_ = h.nsPerTick;
+    offset_ = sizeof(h);
+    return true;
+}
+
+bool JournalReader::next(JournalRecord& record) {
+    for (;;) {
+        JournalRecordHeader h;
+        if (offset_ + sizeof(h) <= buffer_.size()) {
+            memcpy(&h, buffer_.data() + offset_, sizeof(h));
+            size_t size = JournalWriter::recordSize(h.length);
+            if (h.length && offset_ + sizeof(h) + h.length <= buffer_.size()) {
+                record.data = buffer_.data() + offset_ + sizeof(h);
+                record.length = h.length;
+                record.rxTicks = h.rxTicks;
+                offset_ += size;
+                ++records_;
+                return true;
+            }
+        }
+        // End of this segment: move on to the next file
+        if (fileIndex_ + 1 >= files_.size()) return false;
+        if (!loadSegment(fileIndex_ + 1)) return false;
+    }
+}
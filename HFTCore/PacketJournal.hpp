@@ -0,0 +1,140 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SpscRing.hpp"
+#include "WireProtocol.hpp"
+
+// On-disk journal of raw feed datagrams, for reproducing a session.
+//
+// A journal is a sequence of segment files <prefix>-000000.jrnl,
+// <prefix>-000001.jrnl, ... Each starts with a JournalFileHeader followed
+// by records. A record is a JournalRecordHeader (payload length and
+// receive time in TscClock ticks) followed by the datagram, padded to 8
+// bytes. A zero length, or the end of the file, ends the segment. Every
+// segment of a journal records the same wire format.
+
+#pragma pack(push, 1)
+struct JournalFileHeader {
+    char magic[8];              // "HFTJRNL1"
+    uint32_t version;
+    uint32_t segmentIndex;
+    uint64_t createdRealtimeNs; // wall clock when the segment was created
+    uint64_t createdTicks;      // TscClock ticks at the same moment
+    double nsPerTick;           // converts record rxTicks deltas to time
+    uint8_t wireFormat;         // WireFormat of every datagram in the segment
+    uint8_t reserved[23];
+};
+
+struct JournalRecordHeader {
+    uint32_t length;
+    uint32_t reserved;
+    uint64_t rxTicks;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(JournalFileHeader) == 64, "JournalFileHeader layout changed");
+static_assert(sizeof(JournalRecordHeader) == 16, "JournalRecordHeader layout changed");
+
+struct JournalSegment;
+
+// Capture side. append() runs on the receive thread and only copies into
+// a segment that is already mapped and pre-faulted. A background thread
+// creates the next segment ahead of time and unmaps and trims full ones,
+// so the receive thread never waits on the filesystem. If the spare
+// segment isn't ready when the current one fills, records are dropped
+// and counted rather than blocking.
+class JournalWriter {
+public:
+    JournalWriter() = default;
+    ~JournalWriter();
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    // Maps the first segment and starts the segment thread. format is
+    // stored in each segment header so replay can check it.
+    bool open(const std::string& directory, WireFormat format, const std::string& prefix = "feed",
+        size_t segmentBytes = size_t(64) << 20);
+    // Flushes and closes everything. The receive thread must have stopped
+    // calling append().
+    void close();
+
+    // Receive thread only
+    bool append(const char* data, uint32_t length, uint64_t rxTicks) {
+        const size_t need = recordSize(length);
+        JournalSegment* seg = current_;
+        if (!seg || !fits(seg, need)) {
+            seg = rotate();
+            if (!seg || !fits(seg, need)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        write(seg, data, length, rxTicks, need);
+        records_.store(records_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    uint64_t records() const { return records_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint32_t segments() const { return nextIndex_.load(std::memory_order_relaxed); }
+
+    static size_t recordSize(uint32_t length) {
+        return (sizeof(JournalRecordHeader) + length + 7) & ~size_t(7);
+    }
+
+private:
+    static bool fits(const JournalSegment* seg, size_t need);
+    static void write(JournalSegment* seg, const char* data, uint32_t length, uint64_t rxTicks, size_t need);
+    JournalSegment* rotate();
+    void segmentLoop();
+    JournalSegment* createSegment(uint32_t index);
+    void closeSegment(JournalSegment* seg);
+
+    std::string directory_;
+    std::string prefix_;
+    WireFormat format_ = WireFormat::Ascii;
+    size_t segmentBytes_ = 0;
+    JournalSegment* current_ = nullptr;
+    std::atomic<JournalSegment*> spare_{ nullptr };
+    SpscRing<JournalSegment*, 64> retired_;
+    std::atomic<uint32_t> nextIndex_{ 0 };
+    std::atomic<bool> running_{ false };
+    std::thread segmentThread_;
+    std::atomic<uint64_t> records_{ 0 };
+    std::atomic<uint64_t> dropped_{ 0 };
+};
+
+struct JournalRecord {
+    const char* data;           // valid until the next call to next()
+    uint32_t length;
+    uint64_t rxTicks;
+};
+
+// Replay side: reads a single segment file, or every segment of a journal
+// directory in index order, one segment in memory at a time. A segment
+// whose wire format differs from the first one's ends the journal.
+class JournalReader {
+public:
+    bool open(const std::string& path);
+    bool next(JournalRecord& record);
+    // Of the segment the last record came from
+    double nsPerTick() const { return nsPerTick_; }
+    // Format of the datagrams, from the first segment's header
+    WireFormat wireFormat() const { return wireFormat_; }
+    uint64_t records() const { return records_; }
+
+private:
+    bool loadSegment(size_t i);
+
+    std::vector<std::string> files_;
+    size_t fileIndex_ = 0;
+    std::vector<char> buffer_;
+    size_t offset_ = 0;
+    double nsPerTick_ = 1.0;
+    WireFormat wireFormat_ = WireFormat::Ascii;
+    uint64_t records_ = 0;
+};
@@ -0,0 +1,61 @@
+#include "pch.h"
+#include "PositionKeeper.hpp"
+
+PositionKeeper::PositionKeeper(size_t maxSymbols)
+    : capacity_(maxSymbols), position_(maxSymbols), cost_(maxSymbols), marks_(maxSymbols),
+    realized_(maxSymbols), unrealized_(maxSymbols) {}
+
+void PositionKeeper::onFill(uint32_t symbolId, OrderSide side, uint32_t qty, int64_t price) {
+    if (symbolId >= capacity_ || qty == 0) return;
+    if (symbolId >= used_) used_ = symbolId + 1;
+    ++fills_;
+
+    int64_t& pos = position_[symbolId];
+    int64_t& cost = cost_[symbolId];
+    int64_t delta = side == OrderSide::BUY ? static_cast<int64_t>(qty) : -static_cast<int64_t>(qty);
+
+    if (pos != 0 && (pos > 0) != (delta > 0)) {
+        // Closing against the open position at its average cost. The cost
+        // share is split as quotient and remainder so cost * closed can't
+        // overflow; closing all of it takes the whole cost, so rounding
+        // never leaves a residue behind.
+        const int64_t open = pos > 0 ? pos : -pos;
+        const int64_t size = delta > 0 ? delta : -delta;
+        const int64_t closed = size < open ? size : open;
+        const int64_t removed = closed == open ? cost
+            : (cost / open) * closed + (cost % open) * closed / open;
+        const int64_t pnl = (pos > 0 ? price * closed : -price * closed) - removed;
+        realized_[symbolId] += pnl;
+        totalRealized_ += pnl;
+        cost -= removed;
+        const int64_t signedClosed = pos > 0 ? -closed : closed;
+        pos += signedClosed;
+        delta -= signedClosed;
+    }
+    // Whatever is left opens or adds at the fill price
+    pos += delta;
+    cost += price * delta;
+}
+
+int64_t PositionKeeper::markToMarket() {
+    const int64_t* pos = position_.data();
+    const int64_t* cost = cost_.data();
+    const int64_t* mark = marks_.data();
+    int64_t* out = unrealized_.data();
+    // A local count: stores through out could otherwise alias used_
+    const size_t n = used_;
+    int64_t total = 0;
+    // The mark test compiles to a select, so the loop vectorizes
+    for (size_t i = 0; i < n; ++i) {
+        const int64_t value = mark[i] * pos[i] - cost[i];
+        out[i] = mark[i] != 0 ? value : 0;
+        total += out[i];
+    }
+    totalUnrealized_ = total;
+    return total;
+}
+
+int64_t PositionKeeper::averageCost(uint32_t symbolId) const {
+    if (symbolId >= capacity_ || position_[symbolId] == 0) return 0;
+    return cost_[symbolId] / position_[symbolId];
+}
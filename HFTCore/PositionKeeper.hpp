@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "Order.hpp"
+#include "Price.hpp"
+
+// Per-symbol position, average cost and P&L, updated one fill at a time.
+// Prices are fixed point in 1 / kPriceScale units and every amount is an
+// int64 in the same units times shares, so realized P&L over a round trip
+// is exact and totals don't drift.
+//
+// State is kept as parallel arrays indexed by symbol id rather than one
+// struct per symbol: a fill touches one slot of each, and
+// markToMarket() is a straight loop over contiguous positions, costs and
+// marks that the compiler vectorizes. Everything is sized up front, so
+// nothing allocates after construction. One thread owns a keeper.
+class PositionKeeper {
+public:
+    explicit PositionKeeper(size_t maxSymbols = 4096);
+
+    // A fill of ours. Adding to a position moves the average cost;
+    // reducing it realizes P&L against the average cost, and crossing
+    // through flat opens the remainder at the fill price.
+    void onFill(uint32_t symbolId, OrderSide side, uint32_t qty, int64_t price);
+    // Price the position is valued at, e.g. the last trade. Symbols
+    // without a mark contribute no unrealized P&L.
+    void setMark(uint32_t symbolId, int64_t price) {
+        if (symbolId < capacity_) marks_[symbolId] = price;
+    }
+    // Revalues every position at its mark and returns total unrealized P&L
+    int64_t markToMarket();
+
+    int64_t position(uint32_t symbolId) const { return symbolId < capacity_ ? position_[symbolId] : 0; }
+    // Average entry price of the open position; 0 when flat
+    int64_t averageCost(uint32_t symbolId) const;
+    int64_t realized(uint32_t symbolId) const { return symbolId < capacity_ ? realized_[symbolId] : 0; }
+    // As of the last markToMarket()
+    int64_t unrealized(uint32_t symbolId) const { return symbolId < capacity_ ? unrealized_[symbolId] : 0; }
+    int64_t totalRealized() const { return totalRealized_; }
+    int64_t totalUnrealized() const { return totalUnrealized_; }
+    double pnl() const { return static_cast<double>(totalRealized_ + totalUnrealized_) / static_cast<double>(kPriceScale); }
+
+    uint64_t fills() const { return fills_; }
+    // Symbol ids below this have seen a fill; markToMarket() stops there
+    size_t symbols() const { return used_; }
+
+private:
+    size_t capacity_;
+    size_t used_ = 0;
+    std::vector<int64_t> position_;     // signed shares
+    std::vector<int64_t> cost_;         // signed price * shares of the open position
+    std::vector<int64_t> marks_;
+    std::vector<int64_t> realized_;
+    std::vector<int64_t> unrealized_;
+    int64_t totalRealized_ = 0;
+    int64_t totalUnrealized_ = 0;
+    uint64_t fills_ = 0;
+};
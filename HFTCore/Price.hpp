@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+
+// Prices inside the book are integer multiples of the instrument tick size,
+// so level keys compare exactly instead of relying on double equality.
+using Price = int64_t;
+
+constexpr double kDefaultTickSize = 0.01;
+
+inline Price toTicks(double price, double tickSize = kDefaultTickSize) {
+    return static_cast<Price>(std::llround(price / tickSize));
+}
+
+inline double fromTicks(Price ticks, double tickSize = kDefaultTickSize) {
+    return static_cast<double>(ticks) * tickSize;
+}
+
+// Fixed-point precision used on the wire and by the feed parser
+constexpr int kPriceDecimals = 4;
+constexpr int64_t kPriceScale = 10000;
+
+inline int64_t toFixedPrice(double price) {
+    return static_cast<int64_t>(std::llround(price * static_cast<double>(kPriceScale)));
+}
@@ -0,0 +1,227 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <functional>
+#include <type_traits>
+#include "Price.hpp"
+#include "Utils.hpp"
+
+// Level storage backends for one side of the book. Both expose the same
+// interface so the book can be instantiated over either:
+//   empty(), size(), bestPrice(), bestLevel(), find(p), insert(p), erase(p),
+//   forEachLevel(f) -- visits levels best-first until f(price, level) returns false
+// Ascending = true orders levels lowest-first (asks), false highest-first (bids).
+
+template<typename Level, bool Ascending>
+class MapLevels {
+    using Compare = typename std::conditional<Ascending, std::less<Price>, std::greater<Price>>::type;
+    std::map<Price, Level, Compare> levels_;
+public:
+    bool empty() const { return levels_.empty(); }
+    size_t size() const { return levels_.size(); }
+    Price bestPrice() const { return levels_.begin()->first; }
+    Level& bestLevel() { return levels_.begin()->second; }
+    const Level& bestLevel() const { return levels_.begin()->second; }
+
+    Level* find(Price p) {
+        auto it = levels_.find(p);
+        return it == levels_.end() ? nullptr : &it->second;
+    }
+    const Level* find(Price p) const {
+        auto it = levels_.find(p);
+        return it == levels_.end() ? nullptr : &it->second;
+    }
+    Level& insert(Price p) { return levels_[p]; }
+    void erase(Price p) { levels_.erase(p); }
+
+    template<typename F>
+    void forEachLevel(F f) {
+        for (auto& kv : levels_) {
+            if (!f(kv.first, kv.second)) return;
+        }
+    }
+};
+
+// Contiguous array of N tick levels starting at base_, with a two-level
+// occupancy bitmap. The best index is cached and only rescanned (two bit
+// scans) when the best level itself is removed.
+// The window is recentred when an insert lands outside it, and always
+// follows the best price; levels too far from the best to share its window
+// are parked in a small overflow map.
+template<typename Level, bool Ascending, size_t N = 1024>
+class TickLadder {
+    static_assert(N % 64 == 0 && N / 64 <= 64, "ladder size must be a multiple of 64 and at most 4096");
+    static constexpr size_t kWords = N / 64;
+
+    std::unique_ptr<Level[]> levels_;
+    uint64_t words_[kWords] = {};
+    uint64_t summary_ = 0;
+    Price base_ = 0;
+    size_t ladderCount_ = 0;
+    size_t bestIdx_ = 0;            // valid while ladderCount_ > 0
+    std::map<Price, Level> overflow_;
+
+public:
+    TickLadder() : levels_(new Level[N]) {}
+
+    bool empty() const { return ladderCount_ == 0 && overflow_.empty(); }
+    size_t size() const { return ladderCount_ + overflow_.size(); }
+    // Levels outside the window, each a std::map node
+    size_t overflowLevels() const { return overflow_.size(); }
+
+    Price bestPrice() const {
+        assert(!empty());
+        if (ladderCount_ == 0) return overflowBest();
+        Price best = base_ + static_cast<Price>(bestIdx_);
+        if (overflow_.empty()) return best;
+        Price ob = overflowBest();
+        return better(ob, best) ? ob : best;
+    }
+
+    Level& bestLevel() { return *find(bestPrice()); }
+    const Level& bestLevel() const { return *find(bestPrice()); }
+
+    Level* find(Price p) {
+        if (inWindow(p)) {
+            size_t i = static_cast<size_t>(p - base_);
+            return occupied(i) ? &levels_[i] : nullptr;
+        }
+        auto it = overflow_.find(p);
+        return it == overflow_.end() ? nullptr : &it->second;
+    }
+    const Level* find(Price p) const { return const_cast<TickLadder*>(this)->find(p); }
+
+    Level& insert(Price p) {
+        if (!inWindow(p)) recentre(p);
+        if (!inWindow(p)) return overflow_[p];
+        size_t i = static_cast<size_t>(p - base_);
+        if (!occupied(i)) {
+            setBit(i);
+            if (ladderCount_++ == 0 || better(p, base_ + static_cast<Price>(bestIdx_))) bestIdx_ = i;
+        }
+        return levels_[i];
+    }
+
+    void erase(Price p) {
+        if (inWindow(p)) {
+            size_t i = static_cast<size_t>(p - base_);
+            if (!occupied(i)) return;
+            clearBit(i);
+            levels_[i] = Level{};
+            if (--ladderCount_ > 0 && i == bestIdx_) bestIdx_ = scanBest();
+            return;
+        }
+        overflow_.erase(p);
+    }
+
+    template<typename F>
+    void forEachLevel(F f) {
+        // Overflow prices lie entirely on one side or the other of the window
+        const Price end = base_ + static_cast<Price>(N);
+        if (Ascending) {
+            auto it = overflow_.begin();
+            for (; it != overflow_.end() && it->first < base_; ++it) {
+                if (!f(it->first, it->second)) return;
+            }
+            for (size_t w = 0; w < kWords; ++w) {
+                for (uint64_t bits = words_[w]; bits; bits &= bits - 1) {
+                    size_t i = (w << 6) + lowestSetBit(bits);
+                    if (!f(base_ + static_cast<Price>(i), levels_[i])) return;
+                }
+            }
+            for (; it != overflow_.end(); ++it) {
+                if (!f(it->first, it->second)) return;
+            }
+        }
+        else {
+            auto it = overflow_.rbegin();
+            for (; it != overflow_.rend() && it->first >= end; ++it) {
+                if (!f(it->first, it->second)) return;
+            }
+            for (size_t w = kWords; w-- > 0;) {
+                for (uint64_t bits = words_[w]; bits; bits &= ~(uint64_t(1) << highestSetBit(bits))) {
+                    size_t i = (w << 6) + highestSetBit(bits);
+                    if (!f(base_ + static_cast<Price>(i), levels_[i])) return;
+                }
+            }
+            for (; it != overflow_.rend(); ++it) {
+                if (!f(it->first, it->second)) return;
+            }
+        }
+    }
+
+private:
+    static bool better(Price a, Price b) { return Ascending ? a < b : a > b; }
+
+    bool inWindow(Price p) const { return p >= base_ && p < base_ + static_cast<Price>(N); }
+    bool occupied(size_t i) const { return (words_[i >> 6] >> (i & 63)) & 1; }
+
+    void setBit(size_t i) {
+        words_[i >> 6] |= uint64_t(1) << (i & 63);
+        summary_ |= uint64_t(1) << (i >> 6);
+    }
+
+    void clearBit(size_t i) {
+        words_[i >> 6] &= ~(uint64_t(1) << (i & 63));
+        if (words_[i >> 6] == 0) summary_ &= ~(uint64_t(1) << (i >> 6));
+    }
+
+    size_t scanBest() const {
+        if (Ascending) {
+            size_t w = lowestSetBit(summary_);
+            return (w << 6) + lowestSetBit(words_[w]);
+        }
+        size_t w = highestSetBit(summary_);
+        return (w << 6) + highestSetBit(words_[w]);
+    }
+
+    Price overflowBest() const {
+        return Ascending ? overflow_.begin()->first : overflow_.rbegin()->first;
+    }
+
+    // Re-anchor the window for an insert at p. Near the best, centre between
+    // the two so both fit. Far from it, centre on whichever is better: after
+    // a price jump the new best takes the window and the stale levels spill,
+    // while a deep order alone leaves the window on the best. Rare, so it
+    // simply spills every level to the overflow map and pulls back whatever
+    // falls inside the new window.
+    void recentre(Price p) {
+        Price centre = p;
+        if (!empty()) {
+            const Price best = bestPrice();
+            const Price distance = p > best ? p - best : best - p;
+            if (distance < static_cast<Price>(N / 2)) {
+                centre = best + (p - best) / 2;
+            }
+            else if (!better(p, best)) {
+                if (inWindow(best)) return;
+                centre = best;
+            }
+        }
+
+        for (size_t w = 0; w < kWords; ++w) {
+            while (words_[w]) {
+                size_t i = (w << 6) + lowestSetBit(words_[w]);
+                overflow_[base_ + static_cast<Price>(i)] = std::move(levels_[i]);
+                levels_[i] = Level{};
+                words_[w] &= words_[w] - 1;
+            }
+        }
+        summary_ = 0;
+        ladderCount_ = 0;
+
+        base_ = centre - static_cast<Price>(N / 2);
+        auto it = overflow_.lower_bound(base_);
+        while (it != overflow_.end() && it->first < base_ + static_cast<Price>(N)) {
+            size_t i = static_cast<size_t>(it->first - base_);
+            levels_[i] = std::move(it->second);
+            setBit(i);
+            ++ladderCount_;
+            it = overflow_.erase(it);
+        }
+        if (ladderCount_ > 0) bestIdx_ = scanBest();
+    }
+};
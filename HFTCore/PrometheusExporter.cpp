@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "PrometheusExporter.hpp"
 #include <string>
+#include <fstream>
+#include <chrono>
 
 PrometheusExporter::PrometheusExporter(unsigned port)
     : exposer_("0.0.0.0:" + std::to_string(port)),
@@ -13,10 +15,34 @@ PrometheusExporter::PrometheusExporter(unsigned port)
         .Name("hft_throughput_ops")
         .Help("Latest throughput in operations per second")
         .Register(*registry_)),
+    stage_family_(prometheus::BuildGauge()
+        .Name("hft_stage_latency_ns")
+        .Help("Per-stage latency quantiles in nanoseconds (quantile 1 = max)")
+        .Register(*registry_)),
+    stage_count_family_(prometheus::BuildGauge()
+        .Name("hft_stage_latency_ns_count")
+        .Help("Samples recorded per stage")
+        .Register(*registry_)),
+    stage_sum_family_(prometheus::BuildGauge()
+        .Name("hft_stage_latency_ns_sum")
+        .Help("Sum of recorded latencies per stage in nanoseconds")
+        .Register(*registry_)),
     latency_gauge_(latency_family_.Add({})),
     throughput_gauge_(throughput_family_.Add({}))
 {
     exposer_.RegisterCollectable(registry_);
+    publisher_ = std::thread(&PrometheusExporter::publisherLoop, this);
+}
+
+PrometheusExporter::~PrometheusExporter() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (publisher_.joinable()) {
+        publisher_.join();
+    }
 }
 
 void PrometheusExporter::recordLatency(double us) {
@@ -27,4 +53,67 @@ void PrometheusExporter::recordThroughput(double ops) {
     throughput_gauge_.Set(ops);
 }
 
+LatencyHistogram& PrometheusExporter::addStage(const std::string& name) {
+    std::lock_guard<std::mutex> lock(stagesMutex_);
+    for (auto& s : stages_) {
+        if (s->name == name) return s->histogram;
+    }
+    auto s = std::make_unique<Stage>();
+    s->name = name;
+    s->p50 = &stage_family_.Add({ { "stage", name }, { "quantile", "0.5" } });
+    s->p99 = &stage_family_.Add({ { "stage", name }, { "quantile", "0.99" } });
+    s->p999 = &stage_family_.Add({ { "stage", name }, { "quantile", "0.999" } });
+    s->max = &stage_family_.Add({ { "stage", name }, { "quantile", "1" } });
+    s->count = &stage_count_family_.Add({ { "stage", name } });
+    s->sum = &stage_sum_family_.Add({ { "stage", name } });
+    stages_.push_back(std::move(s));
+    return stages_.back()->histogram;
+}
+
+void PrometheusExporter::publish() {
+    std::lock_guard<std::mutex> lock(stagesMutex_);
+    for (auto& s : stages_) {
+        HistogramSnapshot snap(s->histogram);
+        s->p50->Set(static_cast<double>(snap.percentile(0.50)));
+        s->p99->Set(static_cast<double>(snap.percentile(0.99)));
+        s->p999->Set(static_cast<double>(snap.percentile(0.999)));
+        s->max->Set(static_cast<double>(snap.max()));
+        s->count->Set(static_cast<double>(snap.count()));
+        s->sum->Set(snap.mean() * static_cast<double>(snap.count()));
+    }
+}
+
+HistogramSnapshot PrometheusExporter::snapshot(const std::string& stage) const {
+    std::lock_guard<std::mutex> lock(stagesMutex_);
+    for (auto& s : stages_) {
+        if (s->name == stage) return HistogramSnapshot(s->histogram);
+    }
+    return HistogramSnapshot();
+}
+
+bool PrometheusExporter::dumpCsv(const std::string& summaryPath, const std::string& bucketsPath) const {
+    std::ofstream summary(summaryPath);
+    std::ofstream buckets(bucketsPath);
+    if (!summary.is_open() || !buckets.is_open()) {
+        return false;
+    }
+    HistogramSnapshot::writeSummaryHeader(summary);
+    HistogramSnapshot::writeBucketsHeader(buckets);
 
+    std::lock_guard<std::mutex> lock(stagesMutex_);
+    for (auto& s : stages_) {
+        HistogramSnapshot snap(s->histogram);
+        snap.writeSummaryRow(summary, s->name);
+        snap.writeBuckets(buckets, s->name);
+    }
+    return summary.good() && buckets.good();
+}
+
+void PrometheusExporter::publisherLoop() {
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    while (!stopping_) {
+        wake_.wait_for(lock, std::chrono::seconds(1));
+        if (stopping_) break;
+        publish();
+    }
+}
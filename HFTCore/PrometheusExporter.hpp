@@ -3,20 +3,63 @@
 #include <prometheus/registry.h>
 #include <prometheus/gauge.h>
 #include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "LatencyHistogram.hpp"
 
 class PrometheusExporter {
 public:
     PrometheusExporter(unsigned port = 8080);
+    ~PrometheusExporter();
     void recordLatency(double us);
     void recordThroughput(double ops);
+
+    // Registers a pipeline stage ("parse", "match", ...) and returns its
+    // histogram. One thread records into each histogram. Register stages
+    // during setup; the returned reference stays valid for the exporter's
+    // lifetime.
+    LatencyHistogram& addStage(const std::string& name);
+    // Copies every stage's p50/p99/p99.9/max, count and sum into the
+    // hft_stage_latency_ns gauges. A background thread calls this once a
+    // second.
+    void publish();
+    // Per-stage percentile summary and non-empty buckets, for offline
+    // analysis at shutdown
+    bool dumpCsv(const std::string& summaryPath, const std::string& bucketsPath) const;
+    HistogramSnapshot snapshot(const std::string& stage) const;
+
 private:
+    struct Stage {
+        std::string name;
+        LatencyHistogram histogram;
+        prometheus::Gauge* p50;
+        prometheus::Gauge* p99;
+        prometheus::Gauge* p999;
+        prometheus::Gauge* max;
+        prometheus::Gauge* count;
+        prometheus::Gauge* sum;
+    };
+
+    void publisherLoop();
+
     std::shared_ptr<prometheus::Registry> registry_;
     prometheus::Exposer exposer_;
     // Use Family objects to create gauges 
     prometheus::Family<prometheus::Gauge>& latency_family_;
     prometheus::Family<prometheus::Gauge>& throughput_family_;
+    prometheus::Family<prometheus::Gauge>& stage_family_;
+    prometheus::Family<prometheus::Gauge>& stage_count_family_;
+    prometheus::Family<prometheus::Gauge>& stage_sum_family_;
     prometheus::Gauge& latency_gauge_;
     prometheus::Gauge& throughput_gauge_;
-};
-
 
+    std::vector<std::unique_ptr<Stage>> stages_;
+    mutable std::mutex stagesMutex_;
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread publisher_;
+};
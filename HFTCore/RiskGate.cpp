@@ -0,0 +1,75 @@
+#include "pch.h"
+#include "RiskGate.hpp"
+#include <cmath>
+
+const char* toString(RiskReject reason) {
+    switch (reason) {
+    case RiskReject::None: return "none";
+    case RiskReject::SymbolDisabled: return "symbol disabled";
+    case RiskReject::MaxQty: return "max qty";
+    case RiskReject::MaxNotional: return "max notional";
+    case RiskReject::PriceBand: return "price band";
+    case RiskReject::NoReference: return "no reference price";
+    case RiskReject::Position: return "position limit";
+    case RiskReject::GrossExposure: return "gross exposure";
+    case RiskReject::OrderRate: return "order rate";
+    default: return "unknown";
+    }
+}
+
+RiskGate::RiskGate(size_t maxSymbols)
+    : limits_(new RiskLimitTable(0)), state_(maxSymbols) {}
+
+RiskGate::~RiskGate() {
+    delete limits_.load();
+    for (auto& r : retired_) delete r.second;
+}
+
+void RiskGate::setLimits(std::unique_ptr<RiskLimitTable> table) {
+    if (table->maxOrdersPerSecond) {
+        table->rateIntervalTicks = TscClock::fromNanos(1000000000ull / table->maxOrdersPerSecond);
+        if (!table->rateIntervalTicks) table->rateIntervalTicks = 1;
+        const uint32_t burst = table->rateBurst ? table->rateBurst : 1;
+        table->rateToleranceTicks = table->rateIntervalTicks * (burst - 1);
+    }
+    else {
+        table->rateIntervalTicks = 0;
+        table->rateToleranceTicks = 0;
+    }
+    const RiskLimitTable* old = limits_.exchange(table.release(), std::memory_order_acq_rel);
+    // Checks that read the new epoch also see the new table
+    const uint64_t epoch = epoch_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    retired_.emplace_back(epoch, old);
+    reclaim();
+}
+
+std::unique_ptr<RiskLimitTable> RiskGate::copyLimits() const {
+    // Only this (the control) thread frees tables, so the current one is safe to read
+    return std::make_unique<RiskLimitTable>(*limits_.load(std::memory_order_acquire));
+}
+
+void RiskGate::reclaim() {
+    const uint64_t seen = readerEpoch_.load(std::memory_order_acquire);
+    size_t kept = 0;
+    for (auto& r : retired_) {
+        if (r.first <= seen) delete r.second;
+        else retired_[kept++] = r;
+    }
+    retired_.resize(kept);
+}
+
+void RiskGate::onFill(uint32_t symbolId, OrderSide side, uint32_t qty, double price) {
+    if (symbolId >= state_.size()) return;
+    SymbolState& s = state_[symbolId];
+    release(s, side, qty);
+    s.position += side == OrderSide::BUY ? static_cast<int64_t>(qty) : -static_cast<int64_t>(qty);
+    const double exposure = std::fabs(static_cast<double>(s.position)) * price;
+    grossExposure_ += exposure - s.exposure;
+    s.exposure = exposure;
+}
+
+uint64_t RiskGate::rejectedTotal() const {
+    uint64_t total = 0;
+    for (size_t i = 1; i < kRejectReasons; ++i) total += rejects_[i];
+    return total;
+}
@@ -0,0 +1,206 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Order.hpp"
+#include "TscClock.hpp"
+
+// Pre-trade risk check for orders this engine would send. One gate
+// belongs to one trading thread, which calls check() before an order
+// leaves and feeds it fills and market prices; the check is a handful of
+// compares against state already in that thread's cache, with no locks,
+// no allocation and no system call. An accepted order counts as working
+// until fills (onFill) and onOrderClosed() have accounted for all of it.
+//
+// Limits live in an immutable RiskLimitTable indexed by symbol id. A
+// control thread changes them by building a new table and publishing it
+// with setLimits(); the trading thread picks it up on its next check.
+// Retired tables are freed RCU-style: each check() first announces that
+// the trading thread holds no older table, and a retired table is
+// deleted once that announcement has caught up with its retirement.
+
+enum class RiskReject : uint8_t {
+    None,
+    SymbolDisabled,     // no limits for the symbol, or maxOrderQty 0
+    MaxQty,
+    MaxNotional,
+    PriceBand,          // too far from the last trade / mid
+    NoReference,        // no price to check against yet
+    Position,           // with the working orders on its side, would take |net position| past the limit
+    GrossExposure,      // would add to |position| and take total |position| notional past the limit
+    OrderRate,
+    Count
+};
+
+const char* toString(RiskReject reason);
+
+// One cache line per symbol. Limits left at 0 reject everything, so a
+// symbol only trades once it has been configured.
+struct alignas(64) SymbolRiskLimits {
+    uint32_t maxOrderQty = 0;       // 0 = symbol may not trade
+    int64_t maxPosition = 0;        // shares, either direction, as if the order and those working filled
+    double maxNotional = 0.0;       // price * qty of one order
+    double priceBand = 0.05;        // fraction either side of the reference; 0 = no band
+};
+
+static_assert(sizeof(SymbolRiskLimits) == 64, "SymbolRiskLimits should fill one cache line");
+
+struct RiskLimitTable {
+    explicit RiskLimitTable(size_t symbolCount, const SymbolRiskLimits& defaults = SymbolRiskLimits{})
+        : symbols(symbolCount, defaults) {}
+
+    std::vector<SymbolRiskLimits> symbols;      // indexed by symbol id
+    double maxGrossExposure = 0.0;              // 0 = no limit
+    // Orders per second across all symbols, with bursts of up to
+    // rateBurst back to back; 0 = no limit
+    uint32_t maxOrdersPerSecond = 0;
+    uint32_t rateBurst = 1;
+
+    // Filled in by setLimits() from the rate above
+    uint64_t rateIntervalTicks = 0;
+    uint64_t rateToleranceTicks = 0;
+};
+
+class RiskGate {
+public:
+    static constexpr size_t kRejectReasons = static_cast<size_t>(RiskReject::Count);
+
+    // maxSymbols sizes the per-symbol positions and reference prices; ids
+    // past the current table's size are rejected as SymbolDisabled
+    explicit RiskGate(size_t maxSymbols = 4096);
+    ~RiskGate();
+    RiskGate(const RiskGate&) = delete;
+    RiskGate& operator=(const RiskGate&) = delete;
+
+    // Control thread (one at a time). The table is fixed once published.
+    void setLimits(std::unique_ptr<RiskLimitTable> table);
+    // A copy of the current table to edit and publish
+    std::unique_ptr<RiskLimitTable> copyLimits() const;
+    // Frees retired tables the trading thread is done with; setLimits()
+    // does this too
+    void reclaim();
+    size_t retiredTables() const { return retired_.size(); }
+
+    // Trading thread from here on
+    RiskReject check(const Order& o) { return check(o, TscClock::now()); }
+
+    // nowTicks is TscClock::now(), for callers that already have it
+    RiskReject check(const Order& o, uint64_t nowTicks) {
+        // Quiescent point: nothing from an earlier check is still in use
+        readerEpoch_.store(epoch_.load(std::memory_order_acquire), std::memory_order_release);
+        const RiskLimitTable& t = *limits_.load(std::memory_order_acquire);
+        ++checks_;
+
+        const uint32_t id = o.symbolId;
+        if (id >= t.symbols.size() || id >= state_.size()) return reject(RiskReject::SymbolDisabled);
+        const SymbolRiskLimits& l = t.symbols[id];
+        if (l.maxOrderQty == 0) return reject(RiskReject::SymbolDisabled);
+        if (o.qty <= 0 || static_cast<uint32_t>(o.qty) > l.maxOrderQty) return reject(RiskReject::MaxQty);
+
+        SymbolState& s = state_[id];
+        const bool market = o.type == OrderType::Market;
+        // A market order is priced at the reference; a limit order must be
+        // within the band around it
+        if ((market || l.priceBand > 0.0) && s.reference <= 0.0) return reject(RiskReject::NoReference);
+        const double price = market ? s.reference : o.price;
+        if (!market && l.priceBand > 0.0) {
+            const double off = price > s.reference ? price - s.reference : s.reference - price;
+            if (off > l.priceBand * s.reference) return reject(RiskReject::PriceBand);
+        }
+        const double notional = price * o.qty;
+        if (notional > l.maxNotional) return reject(RiskReject::MaxNotional);
+
+        // Worst case: this order and every working order on its side fill
+        const bool buy = o.side == OrderSide::BUY;
+        const int64_t after = buy ? s.position + s.workingBuy + o.qty : s.position - s.workingSell - o.qty;
+        const int64_t afterAbs = after < 0 ? -after : after;
+        if (afterAbs > l.maxPosition) return reject(RiskReject::Position);
+        if (t.maxGrossExposure > 0.0) {
+            // Only what the order adds to |position| counts; reducing or
+            // flattening orders always pass
+            const int64_t nowAbs = s.position < 0 ? -s.position : s.position;
+            const double added = static_cast<double>(afterAbs - nowAbs) * price;
+            if (added > 0.0 && grossExposure_ + added > t.maxGrossExposure) return reject(RiskReject::GrossExposure);
+        }
+
+        // GCRA: the order conforms unless it arrives more than the burst
+        // tolerance ahead of its theoretical arrival time
+        if (t.rateIntervalTicks) {
+            if (nowTicks + t.rateToleranceTicks < rateTat_) return reject(RiskReject::OrderRate);
+            rateTat_ = (nowTicks > rateTat_ ? nowTicks : rateTat_) + t.rateIntervalTicks;
+        }
+        (buy ? s.workingBuy : s.workingSell) += o.qty;
+        return RiskReject::None;
+    }
+
+    // Own executions move the position and stop working; exposure is
+    // marked at the fill price
+    void onFill(uint32_t symbolId, OrderSide side, uint32_t qty, double price);
+    // Unfilled quantity of an accepted order that will no longer trade:
+    // cancelled, refused by the book, or the rest of an order that didn't rest
+    void onOrderClosed(uint32_t symbolId, OrderSide side, uint32_t qty) {
+        if (symbolId < state_.size()) release(state_[symbolId], side, qty);
+    }
+    // Reference price for the band: the mid while both sides are quoted,
+    // else the last trade
+    void onTrade(uint32_t symbolId, double price) {
+        if (symbolId < state_.size()) {
+            state_[symbolId].lastTrade = price;
+            if (!state_[symbolId].quoted) state_[symbolId].reference = price;
+        }
+    }
+    void onQuote(uint32_t symbolId, double bid, double ask) {
+        if (symbolId >= state_.size()) return;
+        SymbolState& s = state_[symbolId];
+        s.quoted = bid > 0.0 && ask > 0.0;
+        s.reference = s.quoted ? (bid + ask) * 0.5 : s.lastTrade;
+    }
+
+    int64_t position(uint32_t symbolId) const { return symbolId < state_.size() ? state_[symbolId].position : 0; }
+    int64_t working(uint32_t symbolId, OrderSide side) const {
+        if (symbolId >= state_.size()) return 0;
+        return side == OrderSide::BUY ? state_[symbolId].workingBuy : state_[symbolId].workingSell;
+    }
+    double grossExposure() const { return grossExposure_; }
+    uint64_t checks() const { return checks_; }
+    uint64_t rejected(RiskReject reason) const { return rejects_[static_cast<size_t>(reason)]; }
+    uint64_t rejectedTotal() const;
+
+private:
+    struct SymbolState {
+        double reference = 0.0;
+        double lastTrade = 0.0;
+        double exposure = 0.0;      // |position| * last fill price
+        int64_t position = 0;
+        int64_t workingBuy = 0;     // accepted, not yet filled or closed
+        int64_t workingSell = 0;
+        bool quoted = false;
+    };
+
+    static void release(SymbolState& s, OrderSide side, uint32_t qty) {
+        int64_t& working = side == OrderSide::BUY ? s.workingBuy : s.workingSell;
+        working = working > qty ? working - qty : 0;
+    }
+
+    RiskReject reject(RiskReject reason) {
+        ++rejects_[static_cast<size_t>(reason)];
+        return reason;
+    }
+
+    // Written by the control thread, read on every check
+    alignas(64) std::atomic<const RiskLimitTable*> limits_;
+    std::atomic<uint64_t> epoch_{ 0 };
+    // Written by the trading thread on every check
+    alignas(64) std::atomic<uint64_t> readerEpoch_{ 0 };
+    uint64_t rateTat_ = 0;
+    double grossExposure_ = 0.0;
+    uint64_t checks_ = 0;
+    uint64_t rejects_[kRejectReasons] = {};
+    std::vector<SymbolState> state_;
+
+    // Control thread only: tables waiting for the reader, with the epoch
+    // that retired them
+    std::vector<std::pair<uint64_t, const RiskLimitTable*>> retired_;
+};
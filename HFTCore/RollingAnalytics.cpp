@@ -0,0 +1,178 @@
+#include "pch.h"
+#include "RollingAnalytics.hpp"
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+static constexpr double kToDollars = 1.0 / static_cast<double>(kPriceScale);
+
+RollingAnalytics::RollingAnalytics(size_t maxSymbols, RollingWindowConfig config)
+    : config_(config), capacity_(maxSymbols), cursors_(maxSymbols), notional_(maxSymbols),
+    volume_(maxSymbols), priceSum_(maxSymbols), count_(maxSymbols), returns_(maxSymbols),
+    retMean_(maxSymbols), retM2_(maxSymbols), ema_(maxSymbols) {
+    if (config_.maxTrades == 0) config_.maxTrades = 1;
+    // Ring slots per symbol: maxTrades rounded up to a power of two
+    while ((uint64_t(1) << ringBits_) < config_.maxTrades) ++ringBits_;
+    mask_ = (uint64_t(1) << ringBits_) - 1;
+    alpha_ = 2.0 / (static_cast<double>(config_.maxTrades) + 1.0);
+    const size_t slots = maxSymbols << ringBits_;
+    samples_.resize(slots);
+    minQueue_.resize(slots);
+    maxQueue_.resize(slots);
+}
+
+void RollingAnalytics::onTrade(uint32_t symbolId, int64_t price, uint32_t qty, uint64_t timeNs) {
+    if (symbolId >= capacity_) return;
+    Cursor& c = cursors_[symbolId];
+
+    while (c.tail - c.head >= config_.maxTrades) evictOldest(symbolId);
+    if (config_.spanNs) expire(symbolId, timeNs);
+
+    Sample& s = samples_[base(symbolId) + (c.tail & mask_)];
+    s.timeNs = timeNs;
+    s.price = price;
+    s.qty = qty;
+    s.hasReturn = c.lastPrice > 0;
+    s.ret = s.hasReturn ? static_cast<double>(price - c.lastPrice) / static_cast<double>(c.lastPrice) : 0.0;
+
+    const double px = static_cast<double>(price);
+    notional_[symbolId] += px * qty;
+    volume_[symbolId] += qty;
+    priceSum_[symbolId] += px;
+    ++count_[symbolId];
+    if (s.hasReturn) {
+        const int32_t n = ++returns_[symbolId];
+        const double d = s.ret - retMean_[symbolId];
+        retMean_[symbolId] += d / n;
+        retM2_[symbolId] += d * (s.ret - retMean_[symbolId]);
+    }
+
+    // Each deque drops what the new trade outranks, so its front is the
+    // extreme of the window; every trade is pushed and popped once
+    uint64_t* minQ = &minQueue_[base(symbolId)];
+    while (c.minTail != c.minHead && sampleAt(symbolId, minQ[(c.minTail - 1) & mask_]).price >= price) --c.minTail;
+    minQ[c.minTail++ & mask_] = c.tail;
+    uint64_t* maxQ = &maxQueue_[base(symbolId)];
+    while (c.maxTail != c.maxHead && sampleAt(symbolId, maxQ[(c.maxTail - 1) & mask_]).price <= price) --c.maxTail;
+    maxQ[c.maxTail++ & mask_] = c.tail;
+    ++c.tail;
+
+    double& ema = ema_[symbolId];
+    const double dollars = px * kToDollars;
+    if (c.lastPrice == 0) {
+        ema = dollars;
+    }
+    else {
+        double alpha = alpha_;
+        if (config_.spanNs) {
+            const double dt = timeNs > c.lastTimeNs ? static_cast<double>(timeNs - c.lastTimeNs) : 0.0;
+            alpha = 1.0 - std::exp(-dt / static_cast<double>(config_.spanNs));
+        }
+        ema += alpha * (dollars - ema);
+    }
+    c.lastPrice = price;
+    c.lastTimeNs = timeNs;
+}
+
+void RollingAnalytics::expire(uint32_t symbolId, uint64_t nowNs) {
+    if (symbolId >= capacity_ || !config_.spanNs) return;
+    Cursor& c = cursors_[symbolId];
+    while (c.head != c.tail) {
+        const uint64_t t = sampleAt(symbolId, c.head).timeNs;
+        if (nowNs < t || nowNs - t < config_.spanNs) break;
+        evictOldest(symbolId);
+    }
+}
+
+void RollingAnalytics::evictOldest(uint32_t symbolId) {
+    Cursor& c = cursors_[symbolId];
+    const Sample& s = sampleAt(symbolId, c.head);
+    const double px = static_cast<double>(s.price);
+    notional_[symbolId] -= px * s.qty;
+    volume_[symbolId] -= s.qty;
+    priceSum_[symbolId] -= px;
+    --count_[symbolId];
+    if (s.hasReturn) {
+        const int32_t n = --returns_[symbolId];
+        if (n == 0) {
+            retMean_[symbolId] = 0.0;
+            retM2_[symbolId] = 0.0;
+        }
+        else {
+            const double d = s.ret - retMean_[symbolId];
+            retMean_[symbolId] -= d / n;
+            // A single return has no spread; don't carry rounding forward
+            retM2_[symbolId] = n == 1 ? 0.0 : retM2_[symbolId] - d * (s.ret - retMean_[symbolId]);
+        }
+    }
+
+    const uint64_t* minQ = &minQueue_[base(symbolId)];
+    if (c.minHead != c.minTail && minQ[c.minHead & mask_] == c.head) ++c.minHead;
+    const uint64_t* maxQ = &maxQueue_[base(symbolId)];
+    if (c.maxHead != c.maxTail && maxQ[c.maxHead & mask_] == c.head) ++c.maxHead;
+    ++c.head;
+}
+
+double RollingAnalytics::vwap(uint32_t symbolId) const {
+    if (symbolId >= capacity_ || volume_[symbolId] <= 0.0) return 0.0;
+    return notional_[symbolId] / volume_[symbolId] * kToDollars;
+}
+
+double RollingAnalytics::average(uint32_t symbolId) const {
+    if (symbolId >= capacity_ || !count_[symbolId]) return 0.0;
+    return priceSum_[symbolId] / count_[symbolId] * kToDollars;
+}
+
+double RollingAnalytics::minPrice(uint32_t symbolId) const {
+    if (symbolId >= capacity_) return 0.0;
+    const Cursor& c = cursors_[symbolId];
+    if (c.minHead == c.minTail) return 0.0;
+    return static_cast<double>(sampleAt(symbolId, minQueue_[base(symbolId) + (c.minHead & mask_)]).price) * kToDollars;
+}
+
+double RollingAnalytics::maxPrice(uint32_t symbolId) const {
+    if (symbolId >= capacity_) return 0.0;
+    const Cursor& c = cursors_[symbolId];
+    if (c.maxHead == c.maxTail) return 0.0;
+    return static_cast<double>(sampleAt(symbolId, maxQueue_[base(symbolId) + (c.maxHead & mask_)]).price) * kToDollars;
+}
+
+double RollingAnalytics::volatility(uint32_t symbolId) const {
+    if (symbolId >= capacity_ || returns_[symbolId] < 2) return 0.0;
+    const double var = retM2_[symbolId] / (returns_[symbolId] - 1);
+    return var > 0.0 ? std::sqrt(var) : 0.0;
+}
+
+void RollingAnalytics::signals(size_t first, size_t count, double* vwap, double* volatility) const {
+    if (first >= capacity_) return;
+    if (count > capacity_ - first) count = capacity_ - first;
+    const double* notional = notional_.data() + first;
+    const double* volume = volume_.data() + first;
+    const int32_t* returns = returns_.data() + first;
+    const double* m2 = retM2_.data() + first;
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d scale = _mm256_set1_pd(kToDollars);
+    for (; i + 4 <= count; i += 4) {
+        const __m256d vol = _mm256_loadu_pd(volume + i);
+        const __m256d px = _mm256_mul_pd(_mm256_div_pd(_mm256_loadu_pd(notional + i), vol), scale);
+        _mm256_storeu_pd(vwap + i, _mm256_and_pd(px, _mm256_cmp_pd(vol, zero, _CMP_GT_OQ)));
+
+        // n - 1 as doubles; lanes with fewer than two returns come out 0
+        const __m256d n = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(returns + i)));
+        const __m256d dof = _mm256_sub_pd(n, one);
+        const __m256d var = _mm256_max_pd(_mm256_div_pd(_mm256_loadu_pd(m2 + i), dof), zero);
+        const __m256d sd = _mm256_sqrt_pd(var);
+        _mm256_storeu_pd(volatility + i, _mm256_and_pd(sd, _mm256_cmp_pd(dof, one, _CMP_GE_OQ)));
+    }
+#endif
+    for (; i < count; ++i) {
+        vwap[i] = volume[i] > 0.0 ? notional[i] / volume[i] * kToDollars : 0.0;
+        const double var = returns[i] >= 2 ? m2[i] / (returns[i] - 1) : 0.0;
+        volatility[i] = var > 0.0 ? std::sqrt(var) : 0.0;
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "Price.hpp"
+
+// Window over a symbol's most recent trades. maxTrades bounds it by
+// count; spanNs, when set, also drops trades older than that.
+struct RollingWindowConfig {
+    uint32_t maxTrades = 64;
+    uint64_t spanNs = 0;        // 0 = count window only
+};
+
+// Per-symbol rolling trade statistics, updated in O(1) per trade: VWAP,
+// mean price, EMA, volatility of trade-to-trade returns (Welford, with
+// removal as trades leave the window), min/max price (monotonic deques)
+// and trade count and volume.
+//
+// Each symbol's trades sit in a fixed-size ring carved out of one
+// allocation made at construction; the min/max deques are rings of the
+// same size. The running sums live in parallel arrays indexed by symbol
+// id, so signals() can compute VWAP and volatility for a range of
+// symbols four at a time with AVX2. The sums are doubles holding whole
+// numbers of 1 / kPriceScale units, so adding and removing trades is
+// exact until a window's notional passes 2^53 units (about $900bn).
+//
+// Prices go in as fixed point (kPriceScale) and come out in dollars. One
+// thread owns an instance; feeding it from the book's trade callback
+// makes the signals current as soon as the match that printed returns.
+class RollingAnalytics {
+public:
+    explicit RollingAnalytics(size_t maxSymbols = 4096, RollingWindowConfig config = RollingWindowConfig{});
+
+    void onTrade(uint32_t symbolId, int64_t price, uint32_t qty, uint64_t timeNs);
+    // Drops trades that have aged out of a time window without a new
+    // trade to push them out
+    void expire(uint32_t symbolId, uint64_t nowNs);
+
+    // 0 when the window is empty
+    double vwap(uint32_t symbolId) const;
+    double average(uint32_t symbolId) const;
+    double minPrice(uint32_t symbolId) const;
+    double maxPrice(uint32_t symbolId) const;
+    // Standard deviation of the returns in the window; 0 below two returns
+    double volatility(uint32_t symbolId) const;
+    // Exponential average of every trade seen, not only the window: alpha
+    // 2 / (maxTrades + 1) per trade, or a decay of spanNs for time windows
+    double ema(uint32_t symbolId) const { return symbolId < capacity_ ? ema_[symbolId] : 0.0; }
+    uint32_t trades(uint32_t symbolId) const { return symbolId < capacity_ ? count_[symbolId] : 0; }
+    uint64_t volume(uint32_t symbolId) const {
+        return symbolId < capacity_ ? static_cast<uint64_t>(volume_[symbolId]) : 0;
+    }
+
+    // VWAP and volatility for symbols [first, first + count), as above
+    void signals(size_t first, size_t count, double* vwap, double* volatility) const;
+
+    size_t capacity() const { return capacity_; }
+    const RollingWindowConfig& config() const { return config_; }
+
+private:
+    struct Sample {
+        uint64_t timeNs;
+        int64_t price;
+        double ret;
+        uint32_t qty;
+        uint32_t hasReturn;     // 0 for a symbol's first trade
+    };
+
+    // Ring positions are sequence numbers, masked on access
+    struct Cursor {
+        uint64_t head = 0, tail = 0;            // samples
+        uint64_t minHead = 0, minTail = 0;      // ascending prices, front is the min
+        uint64_t maxHead = 0, maxTail = 0;      // descending prices, front is the max
+        int64_t lastPrice = 0;
+        uint64_t lastTimeNs = 0;
+    };
+
+    const Sample& sampleAt(uint32_t symbolId, uint64_t seq) const { return samples_[base(symbolId) + (seq & mask_)]; }
+    size_t base(uint32_t symbolId) const { return static_cast<size_t>(symbolId) << ringBits_; }
+    void evictOldest(uint32_t symbolId);
+
+    RollingWindowConfig config_;
+    size_t capacity_;
+    unsigned ringBits_ = 0;
+    uint64_t mask_ = 0;
+    double alpha_;
+
+    std::vector<Cursor> cursors_;
+    std::vector<Sample> samples_;
+    std::vector<uint64_t> minQueue_;
+    std::vector<uint64_t> maxQueue_;
+
+    std::vector<double> notional_;      // sum of price * qty
+    std::vector<double> volume_;
+    std::vector<double> priceSum_;
+    std::vector<uint32_t> count_;
+    std::vector<int32_t> returns_;      // returns in the window
+    std::vector<double> retMean_;
+    std::vector<double> retM2_;         // Welford sum of squared deviations
+    std::vector<double> ema_;
+};
@@ -0,0 +1,120 @@
+#include "pch.h"
+#include "SharedMemory.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+// Windows mapping names can't start with a slash
+static std::string mappingName(const std::string& name) {
+    return "Local\\" + (name.empty() || name[0] != '/' ? name : name.substr(1));
+}
+#endif
+
+SharedRegion::~SharedRegion() {
+    close();
+}
+
+bool SharedRegion::create(const std::string& name, size_t size) {
+    close();
+    if (size == 0) return false;
+#ifdef _WIN32
+    HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(uint64_t(size) >> 32), static_cast<DWORD>(size), mappingName(name).c_str());
+    if (!handle) return false;
+    void* p = MapViewOfFile(handle, FILE_MAP_WRITE, 0, 0, size);
+    if (!p) {
+        CloseHandle(handle);
+        return false;
+    }
+    // Touch each page so the first writer doesn't take the faults
+    for (size_t off = 0; off < size; off += 4096) static_cast<volatile char*>(p)[off] = 0;
+    handle_ = handle;
+#else
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) return false;
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return false;
+    }
+#endif
+    base_ = p;
+    size_ = size;
+    owner_ = true;
+    name_ = name;
+    return true;
+}
+
+bool SharedRegion::open(const std::string& name, bool writable) {
+    close();
+#ifdef _WIN32
+    HANDLE handle = OpenFileMappingA(writable ? FILE_MAP_WRITE : FILE_MAP_READ, FALSE, mappingName(name).c_str());
+    if (!handle) return false;
+    void* p = MapViewOfFile(handle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION info;
+    if (!p || !VirtualQuery(p, &info, sizeof(info))) {
+        if (p) UnmapViewOfFile(p);
+        CloseHandle(handle);
+        return false;
+    }
+    handle_ = handle;
+    size_ = info.RegionSize;
+#else
+    int fd = shm_open(name.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void* p = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, flags, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    size_ = size;
+#endif
+    base_ = p;
+    owner_ = false;
+    name_ = name;
+    return true;
+}
+
+void SharedRegion::close() {
+    if (!base_) return;
+#ifdef _WIN32
+    UnmapViewOfFile(base_);
+    CloseHandle(handle_);
+    handle_ = nullptr;
+#else
+    munmap(base_, size_);
+    if (owner_) shm_unlink(name_.c_str());
+#endif
+    base_ = nullptr;
+    size_ = 0;
+    owner_ = false;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// A named shared-memory region mapped into this process: POSIX shm_open
+// and mmap, or a named file mapping on Windows. name is a POSIX
+// shared-memory name such as "/hft_depth"; on Windows it becomes a
+// "Local\" mapping name.
+class SharedRegion {
+public:
+    SharedRegion() = default;
+    ~SharedRegion();
+    SharedRegion(const SharedRegion&) = delete;
+    SharedRegion& operator=(const SharedRegion&) = delete;
+
+    // Creates the region zero-filled, replacing any left over under the
+    // same name, and maps it read-write with every page already faulted in
+    bool create(const std::string& name, size_t size);
+    // Maps a region someone else created; its size comes from the region
+    bool open(const std::string& name, bool writable);
+    // Unmaps. The creator also removes the name; processes still mapped
+    // keep what they have.
+    void close();
+
+    bool isOpen() const { return base_ != nullptr; }
+    char* data() const { return static_cast<char*>(base_); }
+    size_t size() const { return size_; }
+
+private:
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    bool owner_ = false;
+    std::string name_;
+#ifdef _WIN32
+    void* handle_ = nullptr;
+#endif
+};
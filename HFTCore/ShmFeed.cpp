@@ -0,0 +1,82 @@
+#include "pch.h"
+#include "ShmFeed.hpp"
+#include <iostream>
+
+static const char kShmFeedMagic[8] = { 'H', 'F', 'T', 'S', 'H', 'M', 'F', 'D' };
+static const uint32_t kShmFeedVersion = 1;
+
+static size_t slotsOffset() {
+    return (sizeof(ShmFeedHeader) + alignof(ShmFeedSlot) - 1) & ~(alignof(ShmFeedSlot) - 1);
+}
+
+ShmFeedReader::~ShmFeedReader() {
+    close();
+}
+
+bool ShmFeedReader::create(const std::string& name, uint32_t slots) {
+    close();
+    uint32_t count = 2;
+    while (count < slots) count <<= 1;
+    if (!region_.create(name, slotsOffset() + size_t(count) * sizeof(ShmFeedSlot))) {
+        std::cerr << "[ShmFeed] Cannot create shared memory " << name << std::endl;
+        return false;
+    }
+    header_ = reinterpret_cast<ShmFeedHeader*>(region_.data());
+    slots_ = reinterpret_cast<ShmFeedSlot*>(region_.data() + slotsOffset());
+    mask_ = count - 1;
+    head_ = 0;
+    cachedTail_ = 0;
+    received_ = 0;
+    resetBeat();
+
+    // The region starts zeroed. The magic goes in last, so a writer
+    // attaching early sees either nothing or a complete header.
+    header_->version = kShmFeedVersion;
+    header_->slotCount = count;
+    header_->slotSize = sizeof(ShmFeedSlot);
+    header_->createdRealtimeNs = TscClock::realtimeNanos();
+    header_->readerHeartbeatNs.store(header_->createdRealtimeNs, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header_->magic, kShmFeedMagic, sizeof(kShmFeedMagic));
+    return true;
+}
+
+void ShmFeedReader::close() {
+    region_.close();
+    header_ = nullptr;
+    slots_ = nullptr;
+}
+
+ShmFeedWriter::~ShmFeedWriter() {
+    close();
+}
+
+bool ShmFeedWriter::open(const std::string& name) {
+    close();
+    if (!region_.open(name, true)) return false;
+    auto* header = reinterpret_cast<ShmFeedHeader*>(region_.data());
+    if (region_.size() < sizeof(ShmFeedHeader) || memcmp(header->magic, kShmFeedMagic, sizeof(kShmFeedMagic)) != 0 ||
+        header->version != kShmFeedVersion || header->slotSize != sizeof(ShmFeedSlot) ||
+        header->slotCount < 2 || (header->slotCount & (header->slotCount - 1)) != 0 ||
+        region_.size() < slotsOffset() + size_t(header->slotCount) * sizeof(ShmFeedSlot)) {
+        std::cerr << "[ShmFeed] " << name << " is not a feed ring this build can write" << std::endl;
+        close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    header_ = header;
+    slots_ = reinterpret_cast<ShmFeedSlot*>(region_.data() + slotsOffset());
+    mask_ = header->slotCount - 1;
+    // Carry on where an earlier writer left off
+    tail_ = header->tail.load(std::memory_order_relaxed);
+    cachedHead_ = header->head.load(std::memory_order_acquire);
+    resetBeat();
+    heartbeat();
+    return true;
+}
+
+void ShmFeedWriter::close() {
+    region_.close();
+    header_ = nullptr;
+    slots_ = nullptr;
+}
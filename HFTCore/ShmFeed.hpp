@@ -0,0 +1,183 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "SharedMemory.hpp"
+#include "TscClock.hpp"
+#include "WireProtocol.hpp"
+
+// Shared-memory stand-in for the UDP feed between MarketDataGen and HFTApp
+// on one host: a single-producer/single-consumer ring of datagram slots in
+// a named region. A datagram is copied in once by the generator and
+// decoded in place by the handler; no system call on either side.
+//
+// Indices work as in SpscRing: tail is the producer's count of datagrams
+// written, head the consumer's count of datagrams released, each on its
+// own cache line with a locally cached copy of the other. A full ring
+// refuses the write (the generator counts it as a failed send and the
+// handler sees a sequence gap), so a stalled reader never blocks the
+// generator.
+//
+// Each side stamps a heartbeat (CLOCK_REALTIME ns) next to its index
+// every kHeartbeatIntervalNs, and reads the other side's at the same
+// time, so either can tell when its peer has gone away.
+//
+// The reader creates the region, the way a receiver binds its port; the
+// writer attaches to it. A restarted reader makes a new region, which a
+// writer still attached to the old one only notices as a stale heartbeat.
+
+struct alignas(64) ShmFeedSlot {
+    uint32_t length;
+    uint32_t reserved;
+    char data[kMaxDatagramSize];
+};
+
+struct ShmFeedHeader {
+    char magic[8];                  // "HFTSHMFD"
+    uint32_t version;
+    uint32_t slotCount;             // power of two
+    uint32_t slotSize;
+    uint32_t reserved;
+    uint64_t createdRealtimeNs;
+    // Consumer-owned line
+    alignas(64) std::atomic<uint64_t> head;
+    std::atomic<uint64_t> readerHeartbeatNs;
+    // Producer-owned line
+    alignas(64) std::atomic<uint64_t> tail;
+    std::atomic<uint64_t> writerHeartbeatNs;
+};
+
+static_assert(sizeof(ShmFeedHeader) == 192, "ShmFeedHeader layout changed");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory indices must be lock-free");
+
+// Heartbeat bookkeeping shared by both ends
+class ShmFeedPeer {
+public:
+    static constexpr uint64_t kHeartbeatIntervalNs = 10'000'000;
+    // A peer silent for this long is treated as gone
+    static constexpr uint64_t kHeartbeatTimeoutNs = 1'000'000'000;
+
+    // Whether the other side beat within kHeartbeatTimeoutNs, as of this
+    // side's last beat
+    bool peerAlive() const { return peerAlive_; }
+
+protected:
+    // Cheap unless a beat is due: one TSC read
+    void beat(std::atomic<uint64_t>& own, const std::atomic<uint64_t>& peer) {
+        const uint64_t ticks = TscClock::now();
+        if (ticks - lastBeat_ < beatTicks_) return;
+        lastBeat_ = ticks;
+        const uint64_t now = TscClock::realtimeNanos();
+        own.store(now, std::memory_order_relaxed);
+        const uint64_t seen = peer.load(std::memory_order_relaxed);
+        peerAlive_ = seen && now - seen < kHeartbeatTimeoutNs;
+    }
+    void resetBeat() {
+        beatTicks_ = TscClock::fromNanos(kHeartbeatIntervalNs);
+        lastBeat_ = TscClock::now() - beatTicks_;
+        peerAlive_ = false;
+    }
+
+private:
+    uint64_t beatTicks_ = 0;
+    uint64_t lastBeat_ = 0;
+    bool peerAlive_ = false;
+};
+
+// Consumer side, in the handler. Owns the region.
+class ShmFeedReader : public ShmFeedPeer {
+public:
+    static constexpr uint32_t kDefaultSlots = 1 << 14;
+
+    ShmFeedReader() = default;
+    ~ShmFeedReader();
+    ShmFeedReader(const ShmFeedReader&) = delete;
+    ShmFeedReader& operator=(const ShmFeedReader&) = delete;
+
+    // Creates the region, replacing any left over under the same name.
+    // slots is rounded up to a power of two.
+    bool create(const std::string& name, uint32_t slots = kDefaultSlots);
+    void close();
+    bool isOpen() const { return region_.isOpen(); }
+
+    // The i-th unreleased datagram, read in place; nullptr if it hasn't
+    // been written yet. Valid until release().
+    const char* peek(size_t i, uint32_t& length) {
+        const uint64_t index = head_ + i;
+        if (index >= cachedTail_) {
+            cachedTail_ = header_->tail.load(std::memory_order_acquire);
+            if (index >= cachedTail_) return nullptr;
+        }
+        const ShmFeedSlot& slot = slots_[index & mask_];
+        // The writer clamps lengths, but the region is writable by others
+        length = slot.length < kMaxDatagramSize ? slot.length : static_cast<uint32_t>(kMaxDatagramSize);
+        return slot.data;
+    }
+
+    // Hands the first count peeked slots back to the writer in one store
+    void release(size_t count) {
+        head_ += count;
+        header_->head.store(head_, std::memory_order_release);
+        received_ += count;
+    }
+
+    // Call from the receive loop, busy or idle
+    void heartbeat() { beat(header_->readerHeartbeatNs, header_->writerHeartbeatNs); }
+
+    uint64_t received() const { return received_; }
+
+private:
+    SharedRegion region_;
+    ShmFeedHeader* header_ = nullptr;
+    ShmFeedSlot* slots_ = nullptr;
+    uint64_t mask_ = 0;
+    uint64_t head_ = 0;
+    uint64_t cachedTail_ = 0;
+    uint64_t received_ = 0;
+};
+
+// Producer side, in the generator. One thread writes.
+class ShmFeedWriter : public ShmFeedPeer {
+public:
+    ShmFeedWriter() = default;
+    ~ShmFeedWriter();
+    ShmFeedWriter(const ShmFeedWriter&) = delete;
+    ShmFeedWriter& operator=(const ShmFeedWriter&) = delete;
+
+    // Attaches to a region a reader created; false if there is none
+    bool open(const std::string& name);
+    void close();
+    bool isOpen() const { return region_.isOpen(); }
+
+    // Copies one datagram into the next slot; false if the ring is full
+    bool write(const char* data, size_t length) {
+        if (tail_ - cachedHead_ > mask_) {
+            cachedHead_ = header_->head.load(std::memory_order_acquire);
+            if (tail_ - cachedHead_ > mask_) {
+                heartbeat();
+                return false;
+            }
+        }
+        if (length > kMaxDatagramSize) length = kMaxDatagramSize;
+        ShmFeedSlot& slot = slots_[tail_ & mask_];
+        slot.length = static_cast<uint32_t>(length);
+        memcpy(slot.data, data, length);
+        header_->tail.store(++tail_, std::memory_order_release);
+        heartbeat();
+        return true;
+    }
+
+    // Call while idle too, so the reader can tell a quiet feed from a dead one
+    void heartbeat() { beat(header_->writerHeartbeatNs, header_->readerHeartbeatNs); }
+
+    uint64_t written() const { return tail_; }
+
+private:
+    SharedRegion region_;
+    ShmFeedHeader* header_ = nullptr;
+    ShmFeedSlot* slots_ = nullptr;
+    uint64_t mask_ = 0;
+    uint64_t tail_ = 0;
+    uint64_t cachedHead_ = 0;
+};
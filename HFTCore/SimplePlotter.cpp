@@ -30,7 +30,7 @@ bool CSVExporter::ExportToCSV(const std::vector<double>& x,
     
     // Write data
     for (size_t i = 0; i < x.size(); ++i) {
-        file << std::fixed << std::setprecision(6) << x[i] << "," << y[i] << std::endl;
+        file << std::fixed << std::setprecision(6) << x[i] << "," << y[i] << '\n';
     }
     
     file.close();
@@ -74,7 +74,7 @@ bool CSVExporter::ExportMultiSeries(const std::vector<double>& x,
         for (const auto& series : y_series) {
             file << "," << series[i];
         }
-        file << std::endl;
+        file << '\n';
     }
     
     file.close();
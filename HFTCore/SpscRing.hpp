@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+// Bounded single-producer/single-consumer ring. N must be a power of two.
+// Each side owns a cache line holding its index plus a cached copy of the
+// other side's index, so the shared line is only read when the cached
+// value says the ring looks full (producer) or empty (consumer).
+// The slot array is allocated once at construction; nothing on the
+// push/pop path allocates.
+template<typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+    static constexpr size_t kMask = N - 1;
+
+    // Consumer-owned line
+    alignas(64) std::atomic<size_t> head_{ 0 };
+    size_t cachedTail_ = 0;
+    // Producer-owned line
+    alignas(64) std::atomic<size_t> tail_{ 0 };
+    size_t cachedHead_ = 0;
+
+    alignas(64) std::unique_ptr<T[]> slots_;
+
+public:
+    SpscRing() : slots_(new T[N]) {}
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    static constexpr size_t capacity() { return N; }
+
+    // Producer side
+    bool tryPush(const T& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ == N) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == N) return false;
+        }
+        slots_[tail & kMask] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Copies up to count items and publishes them with a single release
+    // store. Returns how many were pushed.
+    size_t pushBulk(const T* items, size_t count) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t free = N - (tail - cachedHead_);
+        if (free < count) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            free = N - (tail - cachedHead_);
+        }
+        const size_t n = count < free ? count : free;
+        for (size_t i = 0; i < n; ++i) {
+            slots_[(tail + i) & kMask] = items[i];
+        }
+        if (n) tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side
+    bool tryPop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) return false;
+        }
+        out = slots_[head & kMask];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pops up to maxCount items, releasing the slots with a single store.
+    // Returns how many were popped.
+    size_t popBulk(T* out, size_t maxCount) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        size_t avail = cachedTail_ - head;
+        if (avail < maxCount) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            avail = cachedTail_ - head;
+        }
+        const size_t n = maxCount < avail ? maxCount : avail;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = slots_[(head + i) & kMask];
+        }
+        if (n) head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // Approximate when called concurrently with either side
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include "Order.hpp"
+#include "LatencyHistogram.hpp"
+#include "TscClock.hpp"
+
+// Per-hop latency distributions built from OrderStamps. Owned by the thread
+// that finishes orders (the book worker), which is then the only writer of
+// every histogram, including the hops that happened on the receive thread.
+//
+//   wire     generator send -> kernel receive (needs synced clocks across hosts)
+//   ingest   kernel receive -> parsed (socket buffer wait + decode)
+//   enqueue  parsed -> pushed to the ring
+//   queue    pushed -> popped by the worker
+//   fill     popped -> first fill emitted
+//   book     popped -> book done with the order
+//   total    kernel receive -> book done
+class StageLatency {
+public:
+    enum Stage { Wire, Ingest, Enqueue, Queue, Fill, Book, Total, kStageCount };
+
+    static const char* name(int stage) {
+        static const char* const names[kStageCount] = { "wire", "ingest", "enqueue", "queue", "fill", "book", "total" };
+        return names[stage];
+    }
+
+    // registry.addStage(name) must return a LatencyHistogram& that outlives
+    // this object (PrometheusExporter does)
+    template<typename Registry>
+    explicit StageLatency(Registry& registry) {
+        for (int i = 0; i < kStageCount; ++i) {
+            hist_[i] = &registry.addStage(name(i));
+        }
+    }
+
+    void record(const OrderStamps& s) {
+        if (s.sentBefore) hist_[Wire]->record(TscClock::toNanos(s.sentBefore));
+        hop(Ingest, 0, s.parsed);
+        hop(Enqueue, s.parsed, s.enqueued);
+        hop(Queue, s.enqueued, s.dequeued);
+        hop(Fill, s.dequeued, s.filled);
+        hop(Book, s.dequeued, s.applied);
+        hop(Total, 0, s.applied);
+    }
+
+private:
+    // Offsets are from rx; 0 as `from` means rx itself
+    void hop(Stage stage, uint32_t from, uint32_t to) {
+        if (!to || to < from) return;
+        hist_[stage]->record(TscClock::toNanos(to - from));
+    }
+
+    LatencyHistogram* hist_[kStageCount];
+};
@@ -0,0 +1,256 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "Order.hpp"
+#include "OrderBook.hpp"
+#include "TscClock.hpp"
+
+// Strategy plug-ins. A strategy is a plain class deriving from
+// StrategyBase<Self> that defines whichever of these handlers it needs;
+// the rest fall through to no-ops in the base:
+//
+//   void onBookUpdate(const BookUpdate&, OrderBuffer&);
+//   void onTrade(const Trade&, OrderBuffer&);
+//   void onFill(const Fill&, OrderBuffer&);
+//   void onReject(const OrderRequest&, OrderBuffer&);    // refused before it reached a book
+//
+// StrategyHost<A, B, ...> owns the strategies by value and reaches each
+// handler through its concrete type, so there is no virtual dispatch and
+// a whole event can inline into the worker loop. Handlers never send
+// anything themselves: they append OrderRequests to the host's
+// preallocated OrderBuffer, which the engine drains after the event.
+
+// Top of one book after it changed
+struct BookUpdate {
+    uint32_t symbolId = kInvalidSymbolId;
+    double bid = 0.0;               // 0 when the side is empty
+    double ask = 0.0;
+    uint32_t bidQty = 0;
+    uint32_t askQty = 0;
+    uint64_t ticks = 0;             // TscClock when the book finished the change
+};
+
+template<typename Book>
+BookUpdate topOfBook(const Book& book, uint64_t ticks) {
+    BookUpdate u;
+    u.symbolId = book.symbolId();
+    u.bid = book.bestBid();
+    u.ask = book.bestAsk();
+    u.bidQty = book.bestBidQty();
+    u.askQty = book.bestAskQty();
+    u.ticks = ticks;
+    return u;
+}
+
+// One of our own orders trading
+struct Fill {
+    uint32_t symbolId = kInvalidSymbolId;
+    uint64_t orderId = 0;
+    OrderSide side = OrderSide::BUY;
+    double price = 0.0;
+    uint32_t qty = 0;
+    bool passive = false;           // the order was resting when it traded
+};
+
+enum class RequestAction : uint8_t {
+    New,
+    Cancel
+};
+
+struct OrderRequest {
+    RequestAction action = RequestAction::New;
+    OrderSide side = OrderSide::BUY;
+    OrderType type = OrderType::Limit;
+    uint32_t symbolId = kInvalidSymbolId;
+    uint32_t qty = 0;
+    double price = 0.0;
+    uint64_t orderId = 0;           // the new order's id, or the one to cancel
+};
+
+// Strategy order ids: the top bit (kStrategyOrderBit) set, then the
+// strategy's index in its host, then a per-strategy sequence. Feed order
+// ids never set the top bit: toOrder() drops binary messages that do and
+// text and synthetic orders carry id 0. So a trade's maker and taker ids
+// tell whether either side was ours.
+constexpr unsigned kStrategyIndexShift = 48;
+
+inline bool isStrategyOrder(uint64_t id) { return (id & kStrategyOrderBit) != 0; }
+inline uint32_t strategyOfOrder(uint64_t id) { return static_cast<uint32_t>((id >> kStrategyIndexShift) & 0x7FFF); }
+
+// Requests queued during one event. The slots are allocated once; push()
+// refuses and counts instead of growing.
+class OrderBuffer {
+public:
+    explicit OrderBuffer(size_t capacity = 256) : slots_(new OrderRequest[capacity]), capacity_(capacity) {}
+    OrderBuffer(const OrderBuffer&) = delete;
+    OrderBuffer& operator=(const OrderBuffer&) = delete;
+
+    bool push(const OrderRequest& r) {
+        if (size_ == capacity_) {
+            ++dropped_;
+            return false;
+        }
+        slots_[size_++] = r;
+        return true;
+    }
+    // Slots stay put while requests are appended, so a drain loop may
+    // keep indexing as handlers add more
+    const OrderRequest& operator[](size_t i) const { return slots_[i]; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear() { size_ = 0; }
+    size_t capacity() const { return capacity_; }
+    uint64_t dropped() const { return dropped_; }
+
+private:
+    std::unique_ptr<OrderRequest[]> slots_;
+    size_t capacity_;
+    size_t size_ = 0;
+    uint64_t dropped_ = 0;
+};
+
+template<typename Derived>
+class StrategyBase {
+public:
+    void onBookUpdate(const BookUpdate&, OrderBuffer&) {}
+    void onTrade(const Trade&, OrderBuffer&) {}
+    void onFill(const Fill&, OrderBuffer&) {}
+    void onReject(const OrderRequest&, OrderBuffer&) {}
+    static const char* name() { return "strategy"; }
+
+    // Entry points for the host; they resolve to Derived's handlers at
+    // compile time
+    void handleBookUpdate(const BookUpdate& u, OrderBuffer& out) { self().onBookUpdate(u, out); }
+    void handleTrade(const Trade& t, OrderBuffer& out) { self().onTrade(t, out); }
+    void handleFill(const Fill& f, OrderBuffer& out) { self().onFill(f, out); }
+    void handleReject(const OrderRequest& r, OrderBuffer& out) { self().onReject(r, out); }
+
+    // Set by the host; part of every order id this strategy sends
+    void setStrategyIndex(uint32_t index) { index_ = index; }
+    uint32_t strategyIndex() const { return index_; }
+
+protected:
+    // Returns the new order's id, or 0 if the buffer was full
+    uint64_t sendLimit(OrderBuffer& out, uint32_t symbolId, OrderSide side, double price, uint32_t qty) {
+        OrderRequest r;
+        r.side = side;
+        r.symbolId = symbolId;
+        r.qty = qty;
+        r.price = price;
+        r.orderId = kStrategyOrderBit | (uint64_t(index_) << kStrategyIndexShift)
+            | (++sequence_ & ((uint64_t(1) << kStrategyIndexShift) - 1));
+        return out.push(r) ? r.orderId : 0;
+    }
+    bool sendCancel(OrderBuffer& out, uint32_t symbolId, uint64_t orderId) {
+        OrderRequest r;
+        r.action = RequestAction::Cancel;
+        r.symbolId = symbolId;
+        r.orderId = orderId;
+        return out.push(r);
+    }
+
+private:
+    Derived& self() { return static_cast<Derived&>(*this); }
+
+    uint32_t index_ = 0;
+    uint64_t sequence_ = 0;
+};
+
+// Per-strategy time spent in handlers, in TscClock ticks
+struct StrategyStats {
+    uint64_t events = 0;
+    uint64_t ticks = 0;
+    uint64_t maxTicks = 0;
+    uint64_t requests = 0;
+
+    uint64_t averageNanos() const { return events ? TscClock::toNanos(ticks / events) : 0; }
+    uint64_t maxNanos() const { return TscClock::toNanos(maxTicks); }
+};
+
+// Runs every strategy on each event, in template argument order. Each
+// handler call is bracketed by two TscClock reads for its strategy's
+// StrategyStats. Fills and rejects go only to the strategy that sent the
+// order.
+// One thread drives a host.
+template<typename... Strategies>
+class StrategyHost {
+    static_assert(sizeof...(Strategies) > 0, "StrategyHost needs at least one strategy");
+
+public:
+    static constexpr size_t kStrategyCount = sizeof...(Strategies);
+    static constexpr size_t kOutboundCapacity = 256;
+
+    explicit StrategyHost(Strategies... strategies)
+        : strategies_(std::move(strategies)...), out_(kOutboundCapacity) {
+        assignIndices(std::index_sequence_for<Strategies...>{});
+    }
+
+    void onBookUpdate(const BookUpdate& u) {
+        forEach([&](auto& s) { s.handleBookUpdate(u, out_); }, std::index_sequence_for<Strategies...>{});
+    }
+    void onTrade(const Trade& t) {
+        forEach([&](auto& s) { s.handleTrade(t, out_); }, std::index_sequence_for<Strategies...>{});
+    }
+    void onFill(const Fill& f) {
+        forOne(strategyOfOrder(f.orderId), [&](auto& s) { s.handleFill(f, out_); },
+            std::index_sequence_for<Strategies...>{});
+    }
+    // A new-order request the engine refused (risk, a dead symbol); the
+    // order never rests, so the sender must not wait for it to
+    void onReject(const OrderRequest& r) {
+        forOne(strategyOfOrder(r.orderId), [&](auto& s) { s.handleReject(r, out_); },
+            std::index_sequence_for<Strategies...>{});
+    }
+
+    // Requests from the events so far; the engine sends and clears them
+    OrderBuffer& outbound() { return out_; }
+
+    template<size_t I>
+    auto& strategy() { return std::get<I>(strategies_); }
+    const StrategyStats& stats(size_t index) const { return stats_[index]; }
+    const char* name(size_t index) const {
+        const char* result = "";
+        forOne(index, [&](auto& s) { result = s.name(); }, std::index_sequence_for<Strategies...>{});
+        return result;
+    }
+
+private:
+    template<size_t... I>
+    void assignIndices(std::index_sequence<I...>) {
+        static_assert(sizeof...(I) <= 0x7FFF, "strategy index must fit its order-id field");
+        static_assert((std::is_base_of<StrategyBase<Strategies>, Strategies>::value && ...),
+            "strategies must derive from StrategyBase<Self>");
+        (std::get<I>(strategies_).setStrategyIndex(static_cast<uint32_t>(I)), ...);
+    }
+
+    template<typename F, size_t... I>
+    void forEach(F&& f, std::index_sequence<I...>) { (run<I>(f), ...); }
+
+    template<typename F, size_t... I>
+    void forOne(size_t index, F&& f, std::index_sequence<I...>) { ((I == index ? run<I>(f) : void()), ...); }
+    template<typename F, size_t... I>
+    void forOne(size_t index, F&& f, std::index_sequence<I...>) const {
+        ((I == index ? f(std::get<I>(strategies_)) : void()), ...);
+    }
+
+    template<size_t I, typename F>
+    void run(F& f) {
+        const size_t queued = out_.size();
+        const uint64_t start = TscClock::now();
+        f(std::get<I>(strategies_));
+        const uint64_t ticks = TscClock::now() - start;
+        StrategyStats& s = stats_[I];
+        ++s.events;
+        s.ticks += ticks;
+        if (ticks > s.maxTicks) s.maxTicks = ticks;
+        s.requests += out_.size() - queued;
+    }
+
+    std::tuple<Strategies...> strategies_;
+    OrderBuffer out_;
+    StrategyStats stats_[kStrategyCount];
+};
@@ -0,0 +1,56 @@
+#include "pch.h"
+#include "SymbolTable.hpp"
+#include <cstring>
+
+SymbolTable::SymbolTable(size_t maxSymbols)
+    : maxSymbols_(maxSymbols) {
+    size_t cap = 16;
+    while (cap < maxSymbols * 2) cap <<= 1;
+    mask_ = cap - 1;
+    slots_.reset(new uint32_t[cap]());
+    keys_.reset(new Key[maxSymbols]());
+    names_.reset(new Name[maxSymbols]());
+}
+
+SymbolTable::SymbolTable(const std::vector<std::string>& universe, size_t maxSymbols)
+    : SymbolTable(maxSymbols < universe.size() ? universe.size() : maxSymbols) {
+    for (const auto& s : universe) {
+        intern(s.c_str());
+    }
+}
+
+SymbolTable::Key SymbolTable::makeKey(const char* symbol) {
+    char buf[16] = {};
+    size_t len = strnlen(symbol, sizeof(buf) - 1);
+    memcpy(buf, symbol, len);
+    Key k;
+    memcpy(&k.lo, buf, 8);
+    memcpy(&k.hi, buf + 8, 8);
+    return k;
+}
+
+uint32_t SymbolTable::intern(const char* symbol) {
+    Key k = makeKey(symbol);
+    size_t i = home(k);
+    for (; slots_[i] != 0; i = (i + 1) & mask_) {
+        uint32_t id = slots_[i] - 1;
+        if (keys_[id] == k) return id;
+    }
+    if (size_ == maxSymbols_) return kInvalidSymbolId;
+
+    uint32_t id = static_cast<uint32_t>(size_++);
+    keys_[id] = k;
+    memcpy(names_[id].text, &k.lo, 8);
+    memcpy(names_[id].text + 8, &k.hi, 8);
+    slots_[i] = id + 1;
+    return id;
+}
+
+uint32_t SymbolTable::lookup(const char* symbol) const {
+    Key k = makeKey(symbol);
+    for (size_t i = home(k); slots_[i] != 0; i = (i + 1) & mask_) {
+        uint32_t id = slots_[i] - 1;
+        if (keys_[id] == k) return id;
+    }
+    return kInvalidSymbolId;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Order.hpp"
+
+// Interns symbols (up to 15 chars) to dense ids 0..size()-1 at ingest, so
+// everything downstream of the parser indexes arrays instead of comparing
+// strings. Keys are stored as two 64-bit words in a flat linear-probing
+// table; a lookup is one hash and usually one 16-byte compare.
+// Single writer: only the ingest thread may call intern(). Readers on other
+// threads may call name() for ids they received through a queue.
+class SymbolTable {
+public:
+    explicit SymbolTable(size_t maxSymbols = 4096);
+    // Preloads a known universe so ids are stable across runs
+    explicit SymbolTable(const std::vector<std::string>& universe, size_t maxSymbols = 4096);
+
+    // Returns the existing id or assigns the next one; kInvalidSymbolId when full
+    uint32_t intern(const char* symbol);
+    // Returns kInvalidSymbolId if the symbol was never interned
+    uint32_t lookup(const char* symbol) const;
+
+    const char* name(uint32_t id) const { return names_[id].text; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return maxSymbols_; }
+
+private:
+    struct Key {
+        uint64_t lo;
+        uint64_t hi;
+        bool operator==(const Key& o) const { return lo == o.lo && hi == o.hi; }
+    };
+    struct Name {
+        char text[16];
+    };
+
+    static Key makeKey(const char* symbol);
+    size_t home(const Key& k) const {
+        uint64_t h = (k.lo ^ (k.hi * 0xC2B2AE3D27D4EB4Full)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h >> 32) & mask_;
+    }
+
+    size_t maxSymbols_;
+    size_t mask_;
+    size_t size_ = 0;
+    std::unique_ptr<uint32_t[]> slots_;     // id + 1, 0 = empty
+    std::unique_ptr<Key[]> keys_;           // by id
+    std::unique_ptr<Name[]> names_;         // by id
+};
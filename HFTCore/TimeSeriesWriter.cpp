@@ -0,0 +1,204 @@
+#include "pch.h"
+#include "TimeSeriesWriter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+static const char kTimeSeriesMagic[8] = { 'H', 'F', 'T', 'T', 'S', '0', '0', '1' };
+// Rows per binary block; a partial block is written at each flush
+static constexpr size_t kBlockRows = 4096;
+// Worst case for one formatted CSV row
+static constexpr size_t kMaxCsvRow = 40 * (TimeSeriesRow::kMaxColumns + 1);
+
+TimeSeriesWriter::TimeSeriesWriter(std::string basePath, std::vector<std::string> columns,
+    TimeSeriesFormat format, size_t rotateBytes)
+    : basePath_(std::move(basePath)), columns_(std::move(columns)), format_(format), rotateBytes_(rotateBytes) {
+    if (columns_.empty()) columns_.push_back("Time");
+    if (columns_.size() > TimeSeriesRow::kMaxColumns + 1) columns_.resize(TimeSeriesRow::kMaxColumns + 1);
+    valueColumns_ = columns_.size() - 1;
+    chunk_.resize(kChunkBytes);
+    pendingBlock_.reserve(kBlockRows);
+}
+
+TimeSeriesWriter::~TimeSeriesWriter() {
+    stop();
+}
+
+bool TimeSeriesWriter::start() {
+    if (running_.load()) return true;
+    fileIndex_ = 0;
+    chunkUsed_ = 0;
+    if (!openNext()) return false;
+    running_.store(true, std::memory_order_release);
+    writer_ = std::thread(&TimeSeriesWriter::writerLoop, this);
+    return true;
+}
+
+void TimeSeriesWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        if (!running_.exchange(false)) return;
+    }
+    wake_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+void TimeSeriesWriter::writerLoop() {
+    TimeSeriesRow rows[256];
+    auto lastFlush = std::chrono::steady_clock::now();
+    for (;;) {
+        // Read the flag first: anything pushed before stop() is then
+        // guaranteed to be drained below
+        const bool stopping = !running_.load(std::memory_order_acquire);
+        size_t n;
+        while ((n = ring_.popBulk(rows, sizeof(rows) / sizeof(rows[0]))) != 0) {
+            append(rows, n);
+        }
+        if (stopping) break;
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastFlush >= std::chrono::milliseconds(kFlushIntervalMs)) {
+            flushChunk();
+            lastFlush = now;
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wake_.wait_for(lock, std::chrono::milliseconds(1), [this] { return !running_.load(); });
+    }
+    flushChunk();
+    if (rotateBytes_ && fileIndex_ > 1 && rowsInFile_ == 0) {
+        // The last flush rotated into a file nothing went into; drop it
+        chunkUsed_ = 0;
+        closeFile();
+        std::remove(path_.c_str());
+        path_ = pathFor(--fileIndex_ - 1);
+        return;
+    }
+    // A fresh file still has its header in the chunk
+    flushChunk();
+    closeFile();
+}
+
+void TimeSeriesWriter::append(const TimeSeriesRow* rows, size_t count) {
+    if (format_ == TimeSeriesFormat::Binary) {
+        for (size_t i = 0; i < count; ++i) {
+            pendingBlock_.push_back(rows[i]);
+            ++rowsInFile_;
+            if (pendingBlock_.size() == kBlockRows) flushChunk();
+        }
+    }
+    else {
+        for (size_t i = 0; i < count; ++i) {
+            if (chunkUsed_ + kMaxCsvRow > chunk_.size()) flushChunk();
+            char* out = chunk_.data() + chunkUsed_;
+            size_t len = 0;
+            // Huge values are truncated rather than overrunning the row budget
+            auto put = [&](const char* fmt, double v) {
+                int n = snprintf(out + len, kMaxCsvRow - len, fmt, v);
+                if (n > 0) len = (std::min)(len + static_cast<size_t>(n), kMaxCsvRow - 1);
+            };
+            put("%.6f", rows[i].time);
+            for (size_t c = 0; c < valueColumns_; ++c) put(",%.6f", rows[i].values[c]);
+            out[len++] = '\n';
+            chunkUsed_ += len;
+            ++rowsInFile_;
+        }
+    }
+    written_.store(written_.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+}
+
+void TimeSeriesWriter::flushChunk() {
+    if (format_ == TimeSeriesFormat::Binary && !pendingBlock_.empty()) {
+        const uint32_t rows = static_cast<uint32_t>(pendingBlock_.size());
+        const size_t blockBytes = sizeof(rows) + size_t(rows) * sizeof(double) * (valueColumns_ + 1);
+        if (chunkUsed_ + blockBytes > chunk_.size()) {
+            // Flush what's buffered first; kBlockRows always fits an empty chunk
+            std::vector<TimeSeriesRow> block;
+            block.swap(pendingBlock_);
+            flushChunk();
+            block.swap(pendingBlock_);
+        }
+        char* out = chunk_.data() + chunkUsed_;
+        memcpy(out, &rows, sizeof(rows));
+        out += sizeof(rows);
+        // The chunk offset isn't 8-byte aligned, so copy rather than store doubles
+        for (uint32_t r = 0; r < rows; ++r, out += sizeof(double)) {
+            memcpy(out, &pendingBlock_[r].time, sizeof(double));
+        }
+        for (size_t c = 0; c < valueColumns_; ++c) {
+            for (uint32_t r = 0; r < rows; ++r, out += sizeof(double)) {
+                memcpy(out, &pendingBlock_[r].values[c], sizeof(double));
+            }
+        }
+        chunkUsed_ += blockBytes;
+        pendingBlock_.clear();
+    }
+    if (!file_) {
+        // Rotation failed to open a file; keep draining so push() never blocks
+        chunkUsed_ = 0;
+        return;
+    }
+    if (!chunkUsed_) return;
+
+    if (fwrite(chunk_.data(), 1, chunkUsed_, file_) != chunkUsed_) {
+        std::cerr << "[TimeSeriesWriter] Short write to " << path_ << std::endl;
+    }
+    fflush(file_);
+    fileBytes_ += chunkUsed_;
+    chunkUsed_ = 0;
+    if (rotateBytes_ && fileBytes_ >= rotateBytes_) {
+        closeFile();
+        openNext();
+    }
+}
+
+std::string TimeSeriesWriter::pathFor(uint32_t index) const {
+    const char* ext = format_ == TimeSeriesFormat::Csv ? ".csv" : ".ts";
+    if (!rotateBytes_) return basePath_ + ext;
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "-%06u%s", index, ext);
+    return basePath_ + suffix;
+}
+
+bool TimeSeriesWriter::openNext() {
+    path_ = pathFor(fileIndex_);
+    file_ = fopen(path_.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "[TimeSeriesWriter] Cannot open " << path_ << std::endl;
+        return false;
+    }
+    ++fileIndex_;
+    fileBytes_ = 0;
+    rowsInFile_ = 0;
+
+    // Header goes at the front of the (empty) chunk
+    std::string header;
+    if (format_ == TimeSeriesFormat::Csv) {
+        for (size_t c = 0; c < columns_.size(); ++c) {
+            if (c) header += ',';
+            header += columns_[c];
+        }
+        header += '\n';
+    }
+    else {
+        header.append(kTimeSeriesMagic, sizeof(kTimeSeriesMagic));
+        uint32_t count = static_cast<uint32_t>(columns_.size());
+        header.append(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (const auto& name : columns_) {
+            header += name;
+            header += '\0';
+        }
+    }
+    memcpy(chunk_.data() + chunkUsed_, header.data(), header.size());
+    chunkUsed_ += header.size();
+    return true;
+}
+
+void TimeSeriesWriter::closeFile() {
+    if (file_) {
+        fclose(file_);
+        file_ = nullptr;
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SpscRing.hpp"
+
+// One sample: a time plus up to kMaxColumns values. Fixed size, so the
+// hot thread copies 64 bytes into the ring and nothing allocates.
+struct TimeSeriesRow {
+    static constexpr size_t kMaxColumns = 7;
+    double time = 0.0;
+    double values[kMaxColumns] = {};
+};
+
+enum class TimeSeriesFormat {
+    Csv,        // header row, then "time,v0,v1,..." per sample
+    Binary      // columnar blocks, see below
+};
+
+// Streams samples to disk from a background thread so memory stays flat
+// however long the session runs.
+//
+// push() is wait-free for the single producer: it copies the row into an
+// SPSC ring and returns false (counting a drop) if the writer has fallen
+// that far behind. The writer thread formats rows into a 1 MB buffer and
+// writes it out in one call when full, or every kFlushInterval when the
+// feed is quiet, so a crash loses at most that much.
+//
+// Output goes to <base>.csv / <base>.ts, or with rotateBytes set, to
+// <base>-000000.csv, <base>-000001.csv, ... each starting a new file
+// (with its own header) once the current one passes rotateBytes.
+//
+// Binary layout, little-endian: a file header "HFTTS001", u32 column
+// count (including time), then each column name NUL-terminated. Then
+// blocks of u32 row count followed by that many doubles per column,
+// column after column, so a reader can load one series without touching
+// the others (np.frombuffer with the block offset gives each array).
+class TimeSeriesWriter {
+public:
+    static constexpr size_t kRingSize = size_t(1) << 16;
+    static constexpr size_t kChunkBytes = size_t(1) << 20;
+    static constexpr int kFlushIntervalMs = 200;
+
+    // columns[0] names the time column; up to kMaxColumns more follow
+    TimeSeriesWriter(std::string basePath, std::vector<std::string> columns,
+        TimeSeriesFormat format = TimeSeriesFormat::Csv, size_t rotateBytes = 0);
+    ~TimeSeriesWriter();
+    TimeSeriesWriter(const TimeSeriesWriter&) = delete;
+    TimeSeriesWriter& operator=(const TimeSeriesWriter&) = delete;
+
+    bool start();
+    // Drains everything pushed so far, then closes the file
+    void stop();
+
+    // Producer thread only
+    bool push(const TimeSeriesRow& row) {
+        if (ring_.tryPush(row)) return true;
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint32_t files() const { return fileIndex_; }
+    // Path of the file currently (or last) written
+    const std::string& currentPath() const { return path_; }
+
+private:
+    void writerLoop();
+    void append(const TimeSeriesRow* rows, size_t count);
+    void flushChunk();
+    std::string pathFor(uint32_t index) const;
+    bool openNext();
+    void closeFile();
+
+    std::string basePath_;
+    std::vector<std::string> columns_;
+    TimeSeriesFormat format_;
+    size_t rotateBytes_;
+    size_t valueColumns_;
+
+    SpscRing<TimeSeriesRow, kRingSize> ring_;
+    std::thread writer_;
+    std::atomic<bool> running_{ false };
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+
+    // Writer thread state
+    FILE* file_ = nullptr;
+    std::string path_;
+    uint32_t fileIndex_ = 0;
+    size_t fileBytes_ = 0;
+    uint64_t rowsInFile_ = 0;
+    std::vector<char> chunk_;
+    size_t chunkUsed_ = 0;
+    std::vector<TimeSeriesRow> pendingBlock_;  // binary: rows of the block being built
+
+    std::atomic<uint64_t> written_{ 0 };
+    std::atomic<uint64_t> dropped_{ 0 };
+};
@@ -0,0 +1,135 @@
+#include "pch.h"
+#include "TscClock.hpp"
+#include <chrono>
+#include <cmath>
+#include <ctime>
+
+#if defined(HFT_X86) && !defined(_WIN32)
+#include <cpuid.h>
+#endif
+
+bool TscClock::useTsc_ = false;
+uint64_t TscClock::nsPerTick_ = 1ull << 32;
+uint64_t TscClock::ticksPerNs_ = 1ull << 32;
+double TscClock::ghz_ = 0.0;
+std::atomic<uint32_t> TscClock::anchorSeq_{ 0 };
+std::atomic<uint64_t> TscClock::tickAnchor_{ 0 };
+std::atomic<uint64_t> TscClock::realtimeAnchor_{ 0 };
+
+// Calibrate before main() so every component sees converted times
+static const bool tscCalibrated = TscClock::calibrate();
+
+uint64_t TscClock::monotonicNanos() {
+#ifdef __linux__
+    // RAW is not slewed by NTP, so it measures the oscillator like the TSC does
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+uint64_t TscClock::realtimeNanos() {
+#ifdef __linux__
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void TscClock::setRatio(double nsPerTick) {
+    nsPerTick_ = static_cast<uint64_t>(std::llround(nsPerTick * 4294967296.0));
+    ticksPerNs_ = static_cast<uint64_t>(std::llround(4294967296.0 / nsPerTick));
+    reanchor();
+}
+
+void TscClock::reanchor() {
+    // Back-to-back reads; the realtime read sits between the two ticks
+    uint64_t t0 = now();
+    uint64_t realtime = realtimeNanos();
+    uint64_t t1 = now();
+    setRealtimeAnchor(realtime, t0 + (t1 - t0) / 2);
+}
+
+void TscClock::setRealtimeAnchor(uint64_t realtimeNs, uint64_t ticks) {
+    // Claim the odd sequence; a concurrent writer waits its turn
+    uint32_t seq = anchorSeq_.load(std::memory_order_relaxed);
+    while ((seq & 1) || !anchorSeq_.compare_exchange_weak(seq, seq + 1, std::memory_order_relaxed)) {
+        cpuRelax();
+        seq = anchorSeq_.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    tickAnchor_.store(ticks, std::memory_order_relaxed);
+    realtimeAnchor_.store(realtimeNs, std::memory_order_relaxed);
+    anchorSeq_.store(seq + 2, std::memory_order_release);
+}
+
+bool TscClock::invariantTsc() {
+#ifdef HFT_X86
+    // CPUID.80000007H:EDX[8] = invariant TSC
+    unsigned regs[4] = { 0, 0, 0, 0 };
+#ifdef _WIN32
+    int info[4];
+    __cpuid(info, 0x80000000);
+    if (static_cast<unsigned>(info[0]) < 0x80000007u) return false;
+    __cpuid(info, 0x80000007);
+    regs[3] = static_cast<unsigned>(info[3]);
+#else
+    if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007u) return false;
+    __get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+    return (regs[3] & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+bool TscClock::calibrate(int windowMs) {
+    if (!invariantTsc()) {
+        useTsc_ = false;
+        ghz_ = 0.0;
+        setRatio(1.0);
+        return false;
+    }
+
+    // Take each endpoint as the TSC read closest to a clock read, and spin
+    // rather than sleep so the core doesn't drop into a deep C-state
+    auto sample = [](uint64_t& tsc, uint64_t& ns) {
+        uint64_t bestGap = UINT64_MAX;
+        for (int i = 0; i < 5; ++i) {
+            uint64_t t0 = rdtscStart();
+            uint64_t n = monotonicNanos();
+            uint64_t t1 = rdtscEnd();
+            if (t1 - t0 < bestGap) {
+                bestGap = t1 - t0;
+                tsc = t0 + (t1 - t0) / 2;
+                ns = n;
+            }
+        }
+    };
+
+    uint64_t tsc0 = 0, ns0 = 0, tsc1 = 0, ns1 = 0;
+    sample(tsc0, ns0);
+    const uint64_t deadline = ns0 + uint64_t(windowMs) * 1000000ull;
+    while (monotonicNanos() < deadline) {
+        cpuRelax();
+    }
+    sample(tsc1, ns1);
+
+    if (tsc1 <= tsc0 || ns1 <= ns0) {
+        useTsc_ = false;
+        ghz_ = 0.0;
+        setRatio(1.0);
+        return false;
+    }
+    double nsPerCycle = double(ns1 - ns0) / double(tsc1 - tsc0);
+    ghz_ = 1.0 / nsPerCycle;
+    useTsc_ = true;
+    setRatio(nsPerCycle);
+    return true;
+}
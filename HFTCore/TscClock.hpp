@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "Utils.hpp"
+
+// Cycle-counter clock for latency measurement. now() is a single rdtsc
+// (~20 cycles, no syscall); toNanos() converts with one multiply and shift
+// using a ratio measured against CLOCK_MONOTONIC_RAW (steady_clock off
+// Linux) by calibrate().
+//
+// If the CPU lacks an invariant TSC (its rate changes with frequency
+// scaling, or it stops in deep C-states) or isn't x86, the clock falls
+// back to reading the OS monotonic clock in nanoseconds. The API is the
+// same, only slower. Until calibrate() runs, the fallback is in effect.
+//
+// calibrate() runs once during static initialisation. Calling it again
+// with a longer window gives a more precise ratio, but only do that
+// before other threads start using the clock.
+class TscClock {
+public:
+    // Ticks: TSC cycles, or nanoseconds in fallback mode
+    static uint64_t now() { return useTsc_ ? rdtsc() : monotonicNanos(); }
+    // Serialised reads for bracketing a short measured region
+    static uint64_t start() { return useTsc_ ? rdtscStart() : monotonicNanos(); }
+    static uint64_t stop() { return useTsc_ ? rdtscEnd() : monotonicNanos(); }
+
+    // Ticks to nanoseconds. Split in two so the multiply can't overflow
+    // for any 64-bit tick value.
+    static uint64_t toNanos(uint64_t ticks) { return scale(ticks, nsPerTick_); }
+    static double toMicros(uint64_t ticks) { return toNanos(ticks) * 1e-3; }
+    static uint64_t elapsedNanos(uint64_t startTicks) { return toNanos(now() - startTicks); }
+    // A duration in nanoseconds as ticks, for deadlines and intervals
+    static uint64_t fromNanos(uint64_t ns) { return scale(ns, ticksPerNs_); }
+
+    // Maps a CLOCK_REALTIME timestamp (a peer's send time, a kernel receive
+    // stamp) onto this clock, using the latest anchor pair
+    static uint64_t fromRealtimeNanos(uint64_t ns) {
+        uint64_t tickAnchor, realtimeAnchor;
+        readAnchor(tickAnchor, realtimeAnchor);
+        if (ns >= realtimeAnchor) return tickAnchor + scale(ns - realtimeAnchor, ticksPerNs_);
+        uint64_t back = scale(realtimeAnchor - ns, ticksPerNs_);
+        return back < tickAnchor ? tickAnchor - back : 0;
+    }
+
+    // The realtime mapping holds only while the wall clock runs with the
+    // TSC; a step (settimeofday, an NTP jump) shifts every mapped stamp
+    // until the next anchor. reanchor() re-reads the pair, a few hundred
+    // ns; the receive loop calls it about once a second. Safe to call
+    // while other threads map stamps.
+    static void reanchor();
+    // Installs an anchor pair directly: realtimeNs is the wall clock at ticks
+    static void setRealtimeAnchor(uint64_t realtimeNs, uint64_t ticks);
+
+    // Measures the TSC rate over `windowMs`. Returns false (and stays in
+    // fallback mode) when there is no usable invariant TSC.
+    static bool calibrate(int windowMs = 20);
+
+    static bool usingTsc() { return useTsc_; }
+    static bool invariantTsc();
+    // TSC rate in GHz; 0 in fallback mode
+    static double ghz() { return ghz_; }
+    static uint64_t monotonicNanos();
+    static uint64_t realtimeNanos();
+
+private:
+    // value * factor / 2^32 for a 32.32 fixed-point factor
+    static uint64_t scale(uint64_t value, uint64_t factor) {
+        return (value >> 32) * factor + (((value & 0xFFFFFFFFull) * factor) >> 32);
+    }
+    static void setRatio(double nsPerTick);
+    // Seqlock read of the anchor pair: anchorSeq_ is odd while it is written
+    static void readAnchor(uint64_t& ticks, uint64_t& realtimeNs) {
+        for (;;) {
+            const uint32_t before = anchorSeq_.load(std::memory_order_acquire);
+            ticks = tickAnchor_.load(std::memory_order_relaxed);
+            realtimeNs = realtimeAnchor_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (!(before & 1) && anchorSeq_.load(std::memory_order_relaxed) == before) return;
+            cpuRelax();
+        }
+    }
+
+    static bool useTsc_;
+    // Nanoseconds per tick and ticks per nanosecond as 32.32 fixed point
+    static uint64_t nsPerTick_;
+    static uint64_t ticksPerNs_;
+    static double ghz_;
+    // now() and realtimeNanos() read together
+    static std::atomic<uint32_t> anchorSeq_;
+    static std::atomic<uint64_t> tickAnchor_;
+    static std::atomic<uint64_t> realtimeAnchor_;
+};
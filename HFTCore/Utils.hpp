@@ -1,14 +1,106 @@
 #pragma once
 #include <cstdint>
+#include <chrono>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define HFT_X86 1
+#endif
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
 #include <intrin.h>
 #include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#ifdef HFT_X86
+#include <x86intrin.h>
+#endif
+#endif
 
-inline void pinThread(int cpu) {
+// Pin the calling thread to one CPU core. Returns false if the OS refused
+// (core out of range, restricted cpuset) or pinning isn't supported.
+inline bool pinThread(int cpu) {
+#if defined(_WIN32)
     // Set thread affinity mask to single CPU core
     DWORD_PTR mask = DWORD_PTR(1) << cpu;
-    SetThreadAffinityMask(GetCurrentThread(), mask);
+    return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
 }
 
+// Raw time stamp counter. Not ordered with surrounding instructions: use
+// rdtscStart()/rdtscEnd() around a measured region. On non-x86 targets
+// these return steady_clock nanoseconds instead.
 inline uint64_t rdtsc() {
+#ifdef HFT_X86
     return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// lfence keeps earlier instructions from drifting past the read
+inline uint64_t rdtscStart() {
+#ifdef HFT_X86
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+#else
+    return rdtsc();
+#endif
+}
+
+// rdtscp waits for the measured code to finish; the trailing lfence keeps
+// later instructions from starting before the read
+inline uint64_t rdtscEnd() {
+#ifdef HFT_X86
+    unsigned aux;
+    uint64_t t = __rdtscp(&aux);
+    _mm_lfence();
+    return t;
+#else
+    return rdtsc();
+#endif
+}
+
+// Spin-wait hint: lets the sibling hyperthread run and saves power
+inline void cpuRelax() {
+#ifdef HFT_X86
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Index of the lowest / highest set bit; x must be non-zero
+inline unsigned lowestSetBit(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward64(&idx, x);
+    return static_cast<unsigned>(idx);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+inline unsigned highestSetBit(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanReverse64(&idx, x);
+    return static_cast<unsigned>(idx);
+#else
+    return static_cast<unsigned>(63 - __builtin_clzll(x));
+#endif
 }
@@ -0,0 +1,263 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "Order.hpp"
+#include "Price.hpp"
+
+// Packed little-endian binary feed format shared by MarketDataGen and
+// MarketDataHandler (ITCH/MoldUDP64 style). A datagram is one
+// PacketHeader followed by messageCount messages. Every message starts
+// with its length and type, so receivers can skip types they don't know.
+// Messages are numbered consecutively; the header carries the sequence
+// number of the first message, so the next packet should start at
+// sequence + messageCount. All fields are little-endian.
+
+enum class WireFormat {
+    Ascii,      // "SYMBOL,PRICE,QTY,SIDE", one message per datagram
+    Binary
+};
+
+constexpr uint32_t kWireMagic = 0x42544648;     // "HFTB"
+constexpr uint16_t kWireVersion = 1;
+constexpr size_t kMaxDatagramSize = 1472;       // fits a 1500-byte Ethernet MTU
+
+enum class WireMessageType : uint8_t {
+    AddOrder = 'A'
+};
+
+#pragma pack(push, 1)
+struct PacketHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t messageCount;
+    uint64_t sequence;          // sequence number of the first message
+    uint64_t sendTimestamp;     // sender CLOCK_REALTIME in ns when the datagram was built
+};
+
+struct AddOrderMessage {
+    uint16_t length;            // sizeof(AddOrderMessage)
+    uint8_t type;               // WireMessageType::AddOrder
+    uint8_t side;               // 'B' or 'S'
+    uint32_t qty;
+    uint64_t orderId;
+    int64_t price;              // fixed point, 1 / kPriceScale units
+    char symbol[8];             // NUL padded
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PacketHeader) == 24, "PacketHeader layout changed");
+static_assert(sizeof(AddOrderMessage) == 32, "AddOrderMessage layout changed");
+
+constexpr size_t kMaxMessagesPerPacket = (kMaxDatagramSize - sizeof(PacketHeader)) / sizeof(AddOrderMessage);
+
+// Builds one datagram in a caller-owned buffer
+class PacketBuilder {
+    char* buf_;
+    size_t capacity_;
+    size_t length_ = 0;
+    uint16_t count_ = 0;
+
+public:
+    PacketBuilder(char* buffer, size_t capacity) : buf_(buffer), capacity_(capacity) {}
+
+    void begin(uint64_t sequence, uint64_t sendTimestamp) {
+        PacketHeader h{ kWireMagic, kWireVersion, 0, sequence, sendTimestamp };
+        memcpy(buf_, &h, sizeof(h));
+        length_ = sizeof(h);
+        count_ = 0;
+    }
+
+    // False when the datagram is full
+    bool add(const AddOrderMessage& m) {
+        if (length_ + sizeof(m) > capacity_) return false;
+        memcpy(buf_ + length_, &m, sizeof(m));
+        length_ += sizeof(m);
+        ++count_;
+        reinterpret_cast<PacketHeader*>(buf_)->messageCount = count_;
+        return true;
+    }
+
+    const char* data() const { return buf_; }
+    size_t size() const { return length_; }
+    uint16_t count() const { return count_; }
+};
+
+// Fills symbol, id, price, qty, side and type of `order` from an add
+// message; the symbol id, timestamps and stamps are left to the caller.
+// False, with `order` untouched, for a message the ASCII parser would
+// refuse too: qty of 0 or above INT_MAX, a price that isn't positive, a
+// side other than 'B' or 'S'. Ids in the strategy id space are refused
+// as well, so feed orders can never pass for our own.
+inline bool toOrder(const AddOrderMessage& m, Order& order) {
+    if (m.qty == 0 || m.qty > static_cast<uint32_t>(INT32_MAX)) return false;
+    if (m.price <= 0) return false;
+    if (m.side != 'B' && m.side != 'S') return false;
+    if (m.orderId & kStrategyOrderBit) return false;
+    memcpy(order.symbol, m.symbol, sizeof(m.symbol));
+    memset(order.symbol + sizeof(m.symbol), 0, sizeof(order.symbol) - sizeof(m.symbol));
+    order.id = m.orderId;
+    order.price = static_cast<double>(m.price) * (1.0 / kPriceScale);
+    order.qty = static_cast<int>(m.qty);
+    order.side = (m.side == 'B') ? OrderSide::BUY : OrderSide::SELL;
+    order.type = OrderType::Limit;
+    return true;
+}
+
+enum class DecodeResult {
+    Ok,
+    TooShort,
+    BadMagic,
+    BadVersion,
+    Truncated
+};
+
+// Validates the header and every message length against the datagram
+// size, then hands each AddOrderMessage to onAdd(message, sequence).
+// Unknown message types are skipped. Messages before a truncation are
+// still delivered.
+template<typename OnAdd>
+DecodeResult decodePacket(const char* data, size_t length, const PacketHeader*& header, OnAdd onAdd) {
+    if (length < sizeof(PacketHeader)) return DecodeResult::TooShort;
+    header = reinterpret_cast<const PacketHeader*>(data);
+    if (header->magic != kWireMagic) return DecodeResult::BadMagic;
+    if (header->version != kWireVersion) return DecodeResult::BadVersion;
+
+    size_t offset = sizeof(PacketHeader);
+    for (uint16_t i = 0; i < header->messageCount; ++i) {
+        if (offset + 3 > length) return DecodeResult::Truncated;
+        uint16_t msgLen;
+        memcpy(&msgLen, data + offset, sizeof(msgLen));
+        if (msgLen < 3 || offset + msgLen > length) return DecodeResult::Truncated;
+        uint8_t type = static_cast<uint8_t>(data[offset + 2]);
+        if (type == static_cast<uint8_t>(WireMessageType::AddOrder)) {
+            if (msgLen < sizeof(AddOrderMessage)) return DecodeResult::Truncated;
+            onAdd(*reinterpret_cast<const AddOrderMessage*>(data + offset), header->sequence + i);
+        }
+        offset += msgLen;
+    }
+    return DecodeResult::Ok;
+}
+
+// Arbitration between redundant feed lines (A/B) carrying the same packets.
+// Whichever copy of a message arrives first is taken, the other dropped, so
+// a packet lost on one line costs nothing if the other line delivers it.
+//
+// A bitmap remembers which of the last kWindow sequence numbers have been
+// taken. Out-of-order arrivals inside the window, such as line B filling a
+// hole line A left, are accepted; a number is only counted lost once the
+// window moves past it with neither line having delivered it. Copies older
+// than the window are dropped as late. With a single line the same window
+// absorbs reordering, such as several senders interleaving their sequence
+// ranges. Single writer (the receive thread polls both lines), no locks;
+// the counters can be read from any thread.
+class LineArbiter {
+public:
+    static constexpr uint64_t kWindow = uint64_t(1) << 16;     // messages
+    static constexpr int kMaxLines = 2;
+
+    // True if this is the first copy of seq and it should be processed
+    bool accept(uint64_t seq, int line) {
+        if (!started_) {
+            started_ = true;
+            first_ = high_ = seq;
+        }
+        if (seq >= high_) {
+            if (seq > high_) missing_.fetch_add(seq - high_, std::memory_order_relaxed);
+            advance(seq + 1);
+        }
+        else if (seq + kWindow < high_) {
+            late_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else if (seq < first_) {
+            // Older than anything taken so far but still inside the window,
+            // e.g. a sender whose range was reserved first arriving second.
+            // The numbers in between are now expected as well.
+            missing_.fetch_add(first_ - seq - 1, std::memory_order_relaxed);
+            first_ = seq;
+        }
+        else if (test(seq)) {
+            duplicates_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else {
+            // A hole behind the leading edge, filled
+            missing_.fetch_sub(1, std::memory_order_relaxed);
+            recovered_.fetch_add(1, std::memory_order_relaxed);
+        }
+        set(seq);
+        wins_[line & (kMaxLines - 1)].fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // One past the highest sequence number taken
+    uint64_t high() const { return high_; }
+    // Messages neither line delivered before the window passed them
+    uint64_t lostMessages() const { return lost_.load(std::memory_order_relaxed); }
+    // Numbers between the lowest and highest taken that have not been
+    // delivered yet: the lost ones plus holes the window could still fill
+    uint64_t missing() const { return missing_.load(std::memory_order_relaxed); }
+    // Second copies dropped
+    uint64_t duplicates() const { return duplicates_.load(std::memory_order_relaxed); }
+    // Copies that arrived after the window had passed them
+    uint64_t late() const { return late_.load(std::memory_order_relaxed); }
+    // Messages taken below the leading edge, i.e. gaps one line closed
+    uint64_t recovered() const { return recovered_.load(std::memory_order_relaxed); }
+    // Messages whose first copy came from this line
+    uint64_t wins(int line) const { return wins_[line & (kMaxLines - 1)].load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint64_t kWords = kWindow / 64;
+
+    bool test(uint64_t seq) const { return (bits_[(seq / 64) % kWords] >> (seq % 64)) & 1; }
+    void set(uint64_t seq) { bits_[(seq / 64) % kWords] |= uint64_t(1) << (seq % 64); }
+
+    // Moves the leading edge to newHigh. Slots reused by the new numbers
+    // belonged to numbers falling out of the window; any of those never
+    // taken are lost.
+    void advance(uint64_t newHigh) {
+        uint64_t lost = 0;
+        if (newHigh - high_ >= kWindow) {
+            // The whole window is replaced
+            uint64_t low = high_ > first_ + kWindow ? high_ - kWindow : first_;
+            uint64_t held = 0;
+            for (uint64_t w = 0; w < kWords; ++w) {
+                held += static_cast<uint64_t>(popcount(bits_[w]));
+                bits_[w] = 0;
+            }
+            // Numbers in the old window not taken, plus those skipped
+            // entirely that are already below the new window
+            lost = (high_ - low) - held + (newHigh - kWindow - high_);
+        }
+        else {
+            for (uint64_t s = high_; s < newHigh; ++s) {
+                uint64_t& word = bits_[(s / 64) % kWords];
+                const uint64_t mask = uint64_t(1) << (s % 64);
+                // The slot last held s - kWindow
+                if (!(word & mask) && s >= first_ + kWindow) ++lost;
+                word &= ~mask;
+            }
+        }
+        if (lost) lost_.fetch_add(lost, std::memory_order_relaxed);
+        high_ = newHigh;
+    }
+
+    static int popcount(uint64_t v) {
+        int n = 0;
+        for (; v; v &= v - 1) ++n;
+        return n;
+    }
+
+    uint64_t bits_[kWords] = {};
+    uint64_t first_ = 0;
+    uint64_t high_ = 0;
+    bool started_ = false;
+    std::atomic<uint64_t> lost_{ 0 };
+    std::atomic<uint64_t> missing_{ 0 };
+    std::atomic<uint64_t> duplicates_{ 0 };
+    std::atomic<uint64_t> late_{ 0 };
+    std::atomic<uint64_t> recovered_{ 0 };
+    std::atomic<uint64_t> wins_[kMaxLines] = {};
+};
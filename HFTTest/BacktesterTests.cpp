@@ -0,0 +1,155 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "Backtester.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+static std::string tempPath(const char* name) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(path);
+    return path.string();
+}
+
+TEST(Backtester, CsvDrivesBooksWithSimulatedTime) {
+    const std::string path = tempPath("hft_backtest_small.csv");
+    {
+        std::ofstream out(path);
+        out << "symbol,price,qty,side\n"
+            << "AAPL,100.00,10,BUY\n"
+            << "AAPL,101.00,5,SELL\r\n"
+            << "5000,MSFT,50.00,3,SELL\n"
+            << "AAPL,99.50,4,SELL";         // no trailing newline
+    }
+
+    BacktestReader reader;
+    ASSERT_TRUE(reader.open(path));
+    ASSERT_EQ(reader.orderBound(), 5u);
+    Order o;
+    uint64_t t = 0;
+    ASSERT_TRUE(reader.next(o, t));
+    ASSERT_STREQ(o.symbol, "AAPL");
+    ASSERT_EQ(t, 0u);
+    ASSERT_TRUE(reader.next(o, t));
+    ASSERT_EQ(t, BacktestReader::kCsvDefaultSpacingNs);
+    ASSERT_TRUE(reader.next(o, t));
+    ASSERT_STREQ(o.symbol, "MSFT");
+    ASSERT_EQ(o.symbolId, 1u);
+    ASSERT_EQ(t, 5000u);
+    ASSERT_EQ(o.timestamp.time_since_epoch(), std::chrono::nanoseconds(5000));
+    ASSERT_TRUE(reader.next(o, t));
+    ASSERT_EQ(t, 5000u + BacktestReader::kCsvDefaultSpacingNs);
+    ASSERT_FALSE(reader.next(o, t));
+    ASSERT_EQ(reader.malformed(), 1u);
+
+    BacktestReader again;
+    ASSERT_TRUE(again.open(path));
+    BacktestResult r = Backtester(2).run(again);
+    ASSERT_EQ(r.orders, 4u);
+    ASSERT_EQ(r.malformed, 1u);
+    ASSERT_EQ(r.trades, 1u);
+    ASSERT_EQ(r.volume, 4u);
+    // AAPL: (101 - 100) * -5 + (99.5 - 101) * -4
+    ASSERT_EQ(r.pnlFixed, 1 * kPriceScale);
+    ASSERT_EQ(r.symbols.size(), 2u);
+    ASSERT_EQ(r.perSymbol[0].trades, 1u);
+    ASSERT_EQ(r.perSymbol[1].pnlFixed, 0);
+    ASSERT_EQ(r.lastTimeNs, 6000u);
+    std::filesystem::remove(path);
+}
+
+TEST(Backtester, OverlongLineIsSkippedWhole) {
+    const std::string path = tempPath("hft_backtest_overlong.csv");
+    {
+        std::ofstream out(path);
+        // Longer than the 1 MB read block; what follows the first block
+        // would parse as an order on its own
+        out << std::string(size_t(1) << 20, 'A') << "MSFT,1.00,1,BUY\n"
+            << "AAPL,100.00,10,BUY\n";
+    }
+    BacktestReader reader;
+    ASSERT_TRUE(reader.open(path));
+    Order o;
+    uint64_t t = 0;
+    ASSERT_TRUE(reader.next(o, t));
+    ASSERT_STREQ(o.symbol, "AAPL");
+    ASSERT_FALSE(reader.next(o, t));
+    ASSERT_EQ(reader.malformed(), 1u);
+    std::filesystem::remove(path);
+}
+
+TEST(Backtester, ResultsIndependentOfWorkerCount) {
+    const std::string path = tempPath("hft_backtest_random.csv");
+    {
+        std::ofstream out(path);
+        std::mt19937 rng(7);
+        for (int i = 0; i < 20000; ++i) {
+            int sym = static_cast<int>(rng() % 20);
+            int cents = 10000 + static_cast<int>(rng() % 200);
+            out << i * 250 << ",SYM" << sym << ',' << cents / 100 << '.' << (cents % 100 < 10 ? "0" : "")
+                << cents % 100 << ',' << 1 + rng() % 50 << ',' << (rng() & 1 ? "BUY" : "SELL") << '\n';
+        }
+    }
+
+    BacktestResult runs[3];
+    const unsigned workers[3] = { 1, 4, 4 };
+    for (int i = 0; i < 3; ++i) {
+        BacktestReader reader;
+        ASSERT_TRUE(reader.open(path));
+        runs[i] = Backtester(workers[i]).run(reader);
+    }
+    ASSERT_EQ(runs[0].orders, 20000u);
+    ASSERT_GT(runs[0].trades, 0u);
+    for (int i = 1; i < 3; ++i) {
+        ASSERT_EQ(runs[i].digest, runs[0].digest);
+        ASSERT_EQ(runs[i].trades, runs[0].trades);
+        ASSERT_EQ(runs[i].volume, runs[0].volume);
+        ASSERT_EQ(runs[i].pnlFixed, runs[0].pnlFixed);
+        ASSERT_EQ(runs[i].symbols, runs[0].symbols);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(Backtester, ReadsJournalledPackets) {
+    const std::string dir = tempPath("hft_backtest_journal");
+    {
+        JournalWriter writer;
+        ASSERT_TRUE(writer.open(dir, WireFormat::Binary));
+        char buf[kMaxDatagramSize];
+        PacketBuilder packet(buf, sizeof(buf));
+        packet.begin(1, 0);
+        for (uint64_t id = 1; id <= 2; ++id) {
+            AddOrderMessage m{};
+            m.length = sizeof(m);
+            m.type = static_cast<uint8_t>(WireMessageType::AddOrder);
+            m.side = id == 1 ? 'B' : 'S';
+            m.qty = 10;
+            m.orderId = id;
+            m.price = 1500000;
+            memcpy(m.symbol, "AAPL", 4);
+            packet.add(m);
+        }
+        ASSERT_TRUE(writer.append(packet.data(), static_cast<uint32_t>(packet.size()), 1000));
+        // Duplicate delivery is dropped by sequence number
+        ASSERT_TRUE(writer.append(packet.data(), static_cast<uint32_t>(packet.size()), 1500));
+        const char ascii[] = "MSFT,300.25,7,BUY";
+        ASSERT_TRUE(writer.append(ascii, sizeof(ascii) - 1, 3000));
+        writer.close();
+    }
+
+    BacktestReader reader;
+    ASSERT_TRUE(reader.open(dir));
+    ASSERT_EQ(reader.format(), BacktestReader::Format::Journal);
+    // Two 2-message packets and one ASCII datagram
+    ASSERT_EQ(reader.orderBound(), 5u);
+    BacktestResult r = Backtester(1).run(reader);
+    ASSERT_EQ(r.orders, 3u);
+    ASSERT_EQ(r.trades, 1u);
+    ASSERT_EQ(r.volume, 10u);
+    ASSERT_EQ(r.symbols, (std::vector<std::string>{ "AAPL", "MSFT" }));
+    ASSERT_EQ(r.firstTimeNs, 0u);
+    ASSERT_GT(r.lastTimeNs, 0u);
+    std::filesystem::remove_all(dir);
+}
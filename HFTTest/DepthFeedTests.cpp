@@ -0,0 +1,114 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "DepthFeed.hpp"
+#include "OrderBook.hpp"
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+static std::string regionName(const char* name) {
+#ifdef _WIN32
+    return std::string("/") + name;
+#else
+    return std::string("/") + name + "_" + std::to_string(getpid());
+#endif
+}
+
+static std::vector<DepthMessage> drain(DepthReader& reader) {
+    std::vector<DepthMessage> out;
+    DepthMessage m;
+    while (reader.poll(m)) out.push_back(m);
+    return out;
+}
+
+TEST(DepthFeed, BookPublishesLevelUpdatesAndSnapshots) {
+    const std::string name = regionName("hft_depth_book");
+    DepthPublisher publisher;
+    ASSERT_TRUE(publisher.open(name, 1024, 16));
+    DepthReader reader;
+    ASSERT_TRUE(reader.open(name));
+
+    OrderBook book;
+    book.setSymbolId(3);
+    publisher.nameSymbol(3, "AAPL");
+    book.setDepthPublisher(&publisher, 1000);
+
+    book.match(Order("AAPL", 100.0, 50, OrderType::Limit, OrderSide::BUY, 1));
+    book.match(Order("AAPL", 100.5, 20, OrderType::Limit, OrderSide::SELL, 2));
+    book.match(Order("AAPL", 100.0, 30, OrderType::Limit, OrderSide::SELL, 3));
+    book.cancel(1);
+
+    auto msgs = drain(reader);
+    ASSERT_EQ(msgs.size(), 5u);
+    ASSERT_STREQ(reader.symbolName(3), "AAPL");
+    for (size_t i = 0; i < msgs.size(); ++i) {
+        ASSERT_EQ(msgs[i].symbolId, 3u);
+        ASSERT_EQ(msgs[i].bookSequence, i + 1);
+    }
+
+    // The first change, then the snapshot that a new publisher owes readers
+    ASSERT_EQ(msgs[0].type, static_cast<uint8_t>(DepthMessageType::LevelUpdate));
+    ASSERT_EQ(msgs[0].bidCount, 1);
+    ASSERT_EQ(msgs[0].bids[0].price, 100 * kPriceScale);
+    ASSERT_EQ(msgs[0].bids[0].qty, 50u);
+    ASSERT_EQ(msgs[1].type, static_cast<uint8_t>(DepthMessageType::Snapshot));
+    ASSERT_EQ(msgs[1].bidCount, 1);
+    ASSERT_EQ(msgs[1].askCount, 0);
+
+    ASSERT_EQ(msgs[2].askCount, 1);
+    ASSERT_EQ(msgs[2].asks[0].price, 1005 * kPriceScale / 10);
+    ASSERT_EQ(msgs[2].asks[0].qty, 20u);
+
+    // The sell sweeps part of the bid: one update for the level
+    ASSERT_EQ(msgs[3].bidCount, 1);
+    ASSERT_EQ(msgs[3].bids[0].qty, 20u);
+    ASSERT_EQ(msgs[3].bids[0].orders, 1u);
+    // Cancelling the rest empties it
+    ASSERT_EQ(msgs[4].bids[0].qty, 0u);
+
+    book.publishSnapshot();
+    msgs = drain(reader);
+    ASSERT_EQ(msgs.size(), 1u);
+    ASSERT_EQ(msgs[0].bidCount, 0);
+    ASSERT_EQ(msgs[0].askCount, 1);
+    ASSERT_EQ(msgs[0].asks[0].qty, 20u);
+}
+
+TEST(DepthFeed, LappedReaderSkipsAheadWithoutStallingPublisher) {
+    const std::string name = regionName("hft_depth_lap");
+    DepthPublisher publisher;
+    ASSERT_TRUE(publisher.open(name, 16, 4));
+    DepthReader reader;
+    ASSERT_TRUE(reader.open(name));
+
+    auto publish = [&](uint64_t n) {
+        DepthMessage& m = publisher.begin();
+        m.type = static_cast<uint8_t>(DepthMessageType::LevelUpdate);
+        m.bidCount = 1;
+        m.askCount = 0;
+        m.symbolId = 0;
+        m.bookSequence = n;
+        m.bids[0] = DepthLevel{ static_cast<int64_t>(n), 1, 1 };
+        publisher.commit();
+    };
+
+    DepthMessage m;
+    ASSERT_FALSE(reader.poll(m));
+    publish(1);
+    ASSERT_TRUE(reader.poll(m));
+    ASSERT_EQ(m.bookSequence, 1u);
+
+    // Publish two laps' worth while the reader sleeps
+    for (uint64_t n = 2; n <= 40; ++n) publish(n);
+    ASSERT_EQ(reader.backlog(), 39u);
+    ASSERT_FALSE(reader.poll(m));
+    ASSERT_EQ(reader.overruns(), 39u);
+
+    publish(41);
+    ASSERT_TRUE(reader.poll(m));
+    ASSERT_EQ(m.bookSequence, 41u);
+    ASSERT_EQ(m.bids[0].price, 41);
+    ASSERT_EQ(reader.received(), 2u);
+}
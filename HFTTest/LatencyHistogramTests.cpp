@@ -0,0 +1,73 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "LatencyHistogram.hpp"
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+TEST(LatencyHistogram, BucketsCoverRangeWithBoundedError) {
+    size_t prev = 0;
+    for (uint64_t v = 0; v < (uint64_t(1) << 20); v += 1 + v / 97) {
+        size_t idx = LatencyHistogram::bucketIndex(v);
+        ASSERT_LT(idx, LatencyHistogram::kBucketCount);
+        ASSERT_GE(idx, prev);
+        ASSERT_LE(LatencyHistogram::bucketLow(idx), v);
+        ASSERT_GE(LatencyHistogram::bucketHigh(idx), v);
+        ASSERT_LE(LatencyHistogram::bucketHigh(idx) - LatencyHistogram::bucketLow(idx), v / 64);
+        prev = idx;
+    }
+    // Out-of-range values clamp to the last bucket
+    ASSERT_EQ(LatencyHistogram::bucketIndex(UINT64_MAX), LatencyHistogram::kBucketCount - 1);
+}
+
+TEST(LatencyHistogram, Percentiles) {
+    auto h = std::make_unique<LatencyHistogram>();
+    for (uint64_t v = 1; v <= 10000; ++v) h->record(v);
+
+    HistogramSnapshot snap(*h);
+    ASSERT_EQ(snap.count(), 10000u);
+    ASSERT_EQ(snap.min(), 1u);
+    ASSERT_EQ(snap.max(), 10000u);
+    ASSERT_NEAR(snap.mean(), 5000.5, 0.01);
+    ASSERT_NEAR(static_cast<double>(snap.percentile(0.5)), 5000.0, 5000.0 / 64);
+    ASSERT_NEAR(static_cast<double>(snap.percentile(0.99)), 9900.0, 9900.0 / 64);
+    ASSERT_EQ(snap.percentile(1.0), 10000u);
+
+    HistogramSnapshot empty;
+    ASSERT_EQ(empty.percentile(0.99), 0u);
+}
+
+TEST(LatencyHistogram, MergeAndCsv) {
+    auto a = std::make_unique<LatencyHistogram>();
+    auto b = std::make_unique<LatencyHistogram>();
+    for (int i = 0; i < 99; ++i) a->record(100);
+    b->record(1000000);
+
+    HistogramSnapshot snap(*a);
+    snap.merge(*b);
+    ASSERT_EQ(snap.count(), 100u);
+    ASSERT_EQ(snap.percentile(0.99), 100u);
+    ASSERT_EQ(snap.percentile(0.999), 1000000u);
+
+    std::ostringstream out;
+    snap.writeBuckets(out, "match");
+    ASSERT_EQ(out.str(), "match,100,100,99,0.99\nmatch,999424,1007615,1,1\n");
+}
+
+TEST(LatencyHistogram, SnapshotWhileRecording) {
+    auto h = std::make_unique<LatencyHistogram>();
+    std::atomic<bool> done{ false };
+    std::thread writer([&] {
+        for (uint64_t i = 0; i < 200000; ++i) h->record(i & 1023);
+        done.store(true);
+    });
+    uint64_t last = 0;
+    while (!done.load()) {
+        HistogramSnapshot snap(*h);
+        ASSERT_GE(snap.count(), last);
+        last = snap.count();
+    }
+    writer.join();
+    ASSERT_EQ(HistogramSnapshot(*h).count(), 200000u);
+}
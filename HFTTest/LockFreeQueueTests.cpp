@@ -1,6 +1,9 @@
 #include "pch.h"
 #include "gtest/gtest.h"
 #include "LockFreeQueue.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
 
 TEST(LockFreeQueue, EnqueueDequeue) {
     LockFreeQueue<int> q;
@@ -9,3 +12,62 @@ TEST(LockFreeQueue, EnqueueDequeue) {
     ASSERT_TRUE(q.dequeue(v));
     ASSERT_EQ(v, 42);
 }
+
+TEST(LockFreeQueue, ReportsFullAndEmpty) {
+    LockFreeQueue<int> q(4);
+    ASSERT_EQ(q.capacity(), 4u);
+    for (int i = 0; i < 4; ++i) ASSERT_TRUE(q.enqueue(i));
+    ASSERT_FALSE(q.enqueue(4));
+    int v = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(q.dequeue(v));
+        ASSERT_EQ(v, i);
+    }
+    ASSERT_FALSE(q.dequeue(v));
+}
+
+TEST(LockFreeQueue, BulkTransfersArePartialWhenNearlyFull) {
+    LockFreeQueue<int> q(8);
+    int in[6] = { 1, 2, 3, 4, 5, 6 };
+    int out[8] = {};
+    ASSERT_EQ(q.enqueueBulk(in, 6), 6u);
+    ASSERT_EQ(q.enqueueBulk(in, 6), 2u);
+    ASSERT_EQ(q.dequeueBulk(out, 3), 3u);
+    ASSERT_EQ(out[2], 3);
+    ASSERT_EQ(q.dequeueBulk(out, 8), 5u);
+    ASSERT_EQ(out[4], 2);
+    ASSERT_EQ(q.dequeueBulk(out, 8), 0u);
+}
+
+TEST(LockFreeQueue, MultipleProducersAndConsumers) {
+    LockFreeQueue<uint64_t> q(256);
+    const int producers = 4, consumers = 4;
+    const uint64_t perProducer = 5000;
+    std::atomic<uint64_t> sum{ 0 }, received{ 0 };
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            uint64_t batch[8];
+            for (uint64_t i = 0; i < perProducer;) {
+                size_t n = 0;
+                while (n < 8 && i + n < perProducer) { batch[n] = p * perProducer + i + n + 1; ++n; }
+                i += q.enqueueBulk(batch, n);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            uint64_t v;
+            while (received.load() < producers * perProducer) {
+                if (q.dequeue(v)) {
+                    sum.fetch_add(v);
+                    received.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    const uint64_t n = producers * perProducer;
+    ASSERT_EQ(received.load(), n);
+    ASSERT_EQ(sum.load(), n * (n + 1) / 2);
+}
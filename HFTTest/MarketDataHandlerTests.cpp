@@ -0,0 +1,189 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "MarketDataHandler.hpp"
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A binary datagram of `count` adds, numbered from `sequence`
+static std::vector<char> addPacket(uint64_t sequence, size_t count) {
+    std::vector<char> buf(sizeof(PacketHeader) + count * sizeof(AddOrderMessage));
+    PacketBuilder builder(buf.data(), buf.size());
+    builder.begin(sequence, 0);
+    for (size_t i = 0; i < count; ++i) {
+        AddOrderMessage m{};
+        m.length = sizeof(AddOrderMessage);
+        m.type = static_cast<uint8_t>(WireMessageType::AddOrder);
+        m.side = 'B';
+        m.qty = 100;
+        m.orderId = sequence + i;
+        m.price = 1000000;
+        memcpy(m.symbol, "AAPL", 4);
+        builder.add(m);
+    }
+    return buf;
+}
+
+// Packets far larger than a receive buffer fill the staging and drop the
+// rest, instead of writing past it
+TEST(MarketDataHandler, OversizedPacketIsCutAtTheStagingCapacity) {
+    const auto dir = std::filesystem::temp_directory_path() / "hft_handler_oversized";
+    std::filesystem::remove_all(dir);
+    const std::vector<char> packets[] = {
+        addPacket(1, 63),       // 2040 bytes: the most a 2048-byte receive buffer holds
+        addPacket(64, 124),     // ~4 KB, only possible from a journal
+        addPacket(188, 1)
+    };
+    {
+        JournalWriter writer;
+        ASSERT_TRUE(writer.open(dir.string(), WireFormat::Binary));
+        for (const auto& p : packets) ASSERT_TRUE(writer.append(p.data(), static_cast<uint32_t>(p.size()), 1));
+        writer.close();
+    }
+
+    JournalReader reader;
+    ASSERT_TRUE(reader.open(dir.string()));
+    auto ring = std::make_unique<OrderRing>();
+    MarketDataHandler handler(*ring, 0, false);
+    handler.setWireFormat(WireFormat::Binary);
+    handler.setReplaySource(&reader);
+    handler.start();
+    for (int i = 0; i < 5000 && !handler.replayFinished(); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    handler.stop();
+    ASSERT_TRUE(handler.replayFinished());
+
+    std::vector<Order> orders(256);
+    const size_t received = ring->popBulk(orders.data(), orders.size());
+    // Every add of the full-size packet, 64 of the oversized one, then the last
+    ASSERT_EQ(received, 63u + 64u + 1u);
+    ASSERT_EQ(orders[62].id, 63u);
+    ASSERT_EQ(orders[63 + 63].id, 127u);
+    ASSERT_EQ(orders[received - 1].id, 188u);
+    ASSERT_EQ(handler.parseErrors(), 1u);
+    // The dropped tail shows up as lost messages
+    ASSERT_EQ(handler.gapMessages(), 60u);
+    std::filesystem::remove_all(dir);
+}
+
+// A journal records its wire format; replaying it with the other decoder
+// would turn every datagram into a parse error, so start() refuses
+TEST(MarketDataHandler, ReplayRefusesAJournalOfTheOtherFormat) {
+    const auto dir = std::filesystem::temp_directory_path() / "hft_handler_format";
+    std::filesystem::remove_all(dir);
+    {
+        JournalWriter writer;
+        ASSERT_TRUE(writer.open(dir.string(), WireFormat::Ascii));
+        const char msg[] = "AAPL,150.25,10,BUY";
+        ASSERT_TRUE(writer.append(msg, sizeof(msg) - 1, 1));
+        writer.close();
+    }
+
+    JournalReader reader;
+    ASSERT_TRUE(reader.open(dir.string()));
+    ASSERT_EQ(reader.wireFormat(), WireFormat::Ascii);
+    auto ring = std::make_unique<OrderRing>();
+    MarketDataHandler handler(*ring, 0, false);
+    handler.setWireFormat(WireFormat::Binary);
+    handler.setReplaySource(&reader);
+    handler.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    handler.stop();
+    ASSERT_EQ(reader.records(), 0u);
+    ASSERT_EQ(handler.parseErrors(), 0u);
+    std::filesystem::remove_all(dir);
+}
+
+// Several load senders reserve sequence ranges from one counter, so a
+// single-line receiver sees the ranges interleaved out of order. None of
+// them may be dropped as duplicates or counted as gaps.
+TEST(MarketDataHandler, InterleavedSenderRangesAreAllTaken) {
+    const auto dir = std::filesystem::temp_directory_path() / "hft_handler_interleaved";
+    std::filesystem::remove_all(dir);
+    constexpr uint64_t kSenders = 4, kRounds = 50, kPerPacket = 16;
+    // Each round the senders reserve consecutive ranges, but the packets
+    // go out in a different order, starting with a later range
+    const uint64_t sendOrder[kSenders] = { 2, 0, 3, 1 };
+    {
+        JournalWriter writer;
+        ASSERT_TRUE(writer.open(dir.string(), WireFormat::Binary));
+        for (uint64_t round = 0; round < kRounds; ++round) {
+            for (uint64_t sender : sendOrder) {
+                const auto p = addPacket(1 + (round * kSenders + sender) * kPerPacket, kPerPacket);
+                ASSERT_TRUE(writer.append(p.data(), static_cast<uint32_t>(p.size()), 1));
+            }
+        }
+        writer.close();
+    }
+
+    JournalReader reader;
+    ASSERT_TRUE(reader.open(dir.string()));
+    auto ring = std::make_unique<OrderRing>();
+    MarketDataHandler handler(*ring, 0, false);
+    handler.setWireFormat(WireFormat::Binary);
+    handler.setReplaySource(&reader);
+    handler.start();
+    for (int i = 0; i < 5000 && !handler.replayFinished(); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    handler.stop();
+    ASSERT_TRUE(handler.replayFinished());
+
+    const uint64_t total = kRounds * kSenders * kPerPacket;
+    std::vector<Order> orders(total + 1);
+    ASSERT_EQ(ring->popBulk(orders.data(), orders.size()), total);
+    std::vector<bool> seen(total + 1, false);
+    for (uint64_t i = 0; i < total; ++i) {
+        ASSERT_GE(orders[i].id, 1u);
+        ASSERT_LE(orders[i].id, total);
+        ASSERT_FALSE(seen[orders[i].id]);
+        seen[orders[i].id] = true;
+    }
+    ASSERT_EQ(handler.gapMessages(), 0u);
+    ASSERT_EQ(handler.duplicateMessages(), 0u);
+    ASSERT_EQ(handler.parseErrors(), 0u);
+    std::filesystem::remove_all(dir);
+}
+
+// Messages with invalid fields are dropped as parse errors but still count
+// as delivered for sequencing
+TEST(MarketDataHandler, InvalidBinaryMessagesAreParseErrors) {
+    const auto dir = std::filesystem::temp_directory_path() / "hft_handler_invalid";
+    std::filesystem::remove_all(dir);
+    std::vector<char> packet = addPacket(1, 4);
+    auto field = [&](size_t msg, size_t offset) {
+        return packet.data() + sizeof(PacketHeader) + msg * sizeof(AddOrderMessage) + offset;
+    };
+    const uint32_t hugeQty = 0x80000000u;
+    const uint64_t strategyId = kStrategyOrderBit | 2;
+    memcpy(field(1, offsetof(AddOrderMessage, qty)), &hugeQty, sizeof(hugeQty));
+    memcpy(field(2, offsetof(AddOrderMessage, orderId)), &strategyId, sizeof(strategyId));
+    *field(3, offsetof(AddOrderMessage, side)) = 'X';
+    {
+        JournalWriter writer;
+        ASSERT_TRUE(writer.open(dir.string(), WireFormat::Binary));
+        ASSERT_TRUE(writer.append(packet.data(), static_cast<uint32_t>(packet.size()), 1));
+        const auto next = addPacket(5, 1);
+        ASSERT_TRUE(writer.append(next.data(), static_cast<uint32_t>(next.size()), 2));
+        writer.close();
+    }
+
+    JournalReader reader;
+    ASSERT_TRUE(reader.open(dir.string()));
+    auto ring = std::make_unique<OrderRing>();
+    MarketDataHandler handler(*ring, 0, false);
+    handler.setWireFormat(WireFormat::Binary);
+    handler.setReplaySource(&reader);
+    handler.start();
+    for (int i = 0; i < 5000 && !handler.replayFinished(); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    handler.stop();
+    ASSERT_TRUE(handler.replayFinished());
+
+    std::vector<Order> orders(8);
+    ASSERT_EQ(ring->popBulk(orders.data(), orders.size()), 2u);
+    ASSERT_EQ(orders[0].id, 1u);
+    ASSERT_EQ(orders[1].id, 5u);
+    ASSERT_EQ(handler.parseErrors(), 3u);
+    ASSERT_EQ(handler.gapMessages(), 0u);
+    std::filesystem::remove_all(dir);
+}
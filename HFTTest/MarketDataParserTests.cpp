@@ -0,0 +1,59 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "MarketDataParser.hpp"
+#include <cstring>
+#include <string>
+
+static ParseError parse(const std::string& msg, Order& o) {
+    return parseOrderMessage(msg.data(), msg.size(), o);
+}
+
+TEST(MarketDataParser, ParsesGeneratorMessage) {
+    Order o;
+    ASSERT_EQ(parse("GOOGL,2801.57,4200,SELL", o), ParseError::None);
+    ASSERT_STREQ(o.symbol, "GOOGL");
+    ASSERT_DOUBLE_EQ(o.price, 2801.57);
+    ASSERT_EQ(o.qty, 4200);
+    ASSERT_EQ(o.side, OrderSide::SELL);
+
+    ASSERT_EQ(parse("AAPL,150,10,BUY\n", o), ParseError::None);
+    ASSERT_STREQ(o.symbol, "AAPL");
+    ASSERT_DOUBLE_EQ(o.price, 150.0);
+    ASSERT_EQ(o.side, OrderSide::BUY);
+}
+
+TEST(MarketDataParser, FixedPointPrice) {
+    int64_t px = 0;
+    ASSERT_TRUE(parseFixedPrice("123.4567", 8, px));
+    ASSERT_EQ(px, 1234567);
+    ASSERT_TRUE(parseFixedPrice(".5", 2, px));
+    ASSERT_EQ(px, 5000);
+    ASSERT_TRUE(parseFixedPrice("1.000019", 8, px));
+    ASSERT_EQ(px, 10000);
+    ASSERT_FALSE(parseFixedPrice("12a", 3, px));
+    ASSERT_FALSE(parseFixedPrice("", 0, px));
+    // 14 whole digits is the limit; longer runs are refused without overflowing
+    ASSERT_TRUE(parseFixedPrice("99999999999999.9999", 19, px));
+    ASSERT_EQ(px, INT64_C(999999999999999999));
+    const char* huge = "99999999999999999999999999.5";
+    ASSERT_FALSE(parseFixedPrice(huge, strlen(huge), px));
+    ASSERT_FALSE(parseFixedPrice("123456789012345", 15, px));
+}
+
+TEST(MarketDataParser, ReportsMalformedInput) {
+    Order o;
+    ASSERT_EQ(parse("AAPL,150.00,100", o), ParseError::MissingField);
+    ASSERT_EQ(parse(",150.00,100,BUY", o), ParseError::BadSymbol);
+    ASSERT_EQ(parse("AAPL,abc,100,BUY", o), ParseError::BadPrice);
+    ASSERT_EQ(parse("AAPL,150.00,-5,BUY", o), ParseError::BadQty);
+    ASSERT_EQ(parse("AAPL,150.00,100,HOLD", o), ParseError::BadSide);
+    ASSERT_EQ(parse("AAPL,150.00,100,BU", o), ParseError::BadSide);
+    ASSERT_EQ(parse(std::string(80, 'A'), o), ParseError::TooLong);
+}
+
+TEST(MarketDataParser, FindCommasAcrossChunks) {
+    std::string s(40, 'x');
+    s[3] = s[17] = s[33] = ',';
+    uint64_t mask = findCommas(s.data(), s.size());
+    ASSERT_EQ(mask, (uint64_t(1) << 3) | (uint64_t(1) << 17) | (uint64_t(1) << 33));
+}
@@ -0,0 +1,68 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "MemoryPool.hpp"
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(MemoryPool, ExhaustAndReuse) {
+    MemoryPool<uint64_t, 8> pool;
+    std::set<uint64_t*> seen;
+    for (int i = 0; i < 8; ++i) {
+        uint64_t* p = pool.allocate();
+        ASSERT_NE(p, nullptr);
+        seen.insert(p);
+    }
+    ASSERT_EQ(seen.size(), 8u);
+    ASSERT_EQ(pool.allocate(), nullptr);
+    ASSERT_EQ(pool.inUse(), 8u);
+
+    uint64_t* back = *seen.begin();
+    pool.deallocate(back);
+    ASSERT_EQ(pool.allocate(), back);
+    ASSERT_EQ(pool.peakInUse(), 8u);
+}
+
+TEST(MemoryPool, CapacityCanBeSetAtConstruction) {
+    MemoryPool<uint64_t, 8> pool(3);
+    ASSERT_EQ(pool.capacity(), 3u);
+    for (int i = 0; i < 3; ++i) ASSERT_NE(pool.allocate(), nullptr);
+    ASSERT_EQ(pool.allocate(), nullptr);
+    ASSERT_EQ(pool.available(), 0u);
+}
+
+TEST(MemoryPool, ConstructAndDestroy) {
+    MemoryPool<std::string, 4> pool;
+    std::string* s = pool.construct(5, 'x');
+    ASSERT_EQ(*s, "xxxxx");
+    pool.destroy(s);
+    ASSERT_EQ(pool.inUse(), 0u);
+}
+
+TEST(MemoryPool, LocalCachesChurnAcrossThreads) {
+    MemoryPool<uint64_t, 1024> pool;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool, t] {
+            MemoryPool<uint64_t, 1024>::LocalCache cache(pool);
+            std::vector<uint64_t*> held;
+            for (int round = 0; round < 2000; ++round) {
+                for (int i = 0; i < 100; ++i) {
+                    uint64_t* p = (i % 2) ? cache.allocate() : pool.allocate();
+                    ASSERT_NE(p, nullptr);
+                    *p = static_cast<uint64_t>(t);
+                    held.push_back(p);
+                }
+                for (uint64_t* p : held) {
+                    ASSERT_EQ(*p, static_cast<uint64_t>(t));
+                    cache.deallocate(p);
+                }
+                held.clear();
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    ASSERT_EQ(pool.inUse(), 0u);
+    ASSERT_LE(pool.peakInUse(), 1024u);
+}
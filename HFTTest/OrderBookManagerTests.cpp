@@ -0,0 +1,63 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "OrderBookManager.hpp"
+#include <string>
+#include <vector>
+
+TEST(SymbolTable, InternAssignsDenseIds) {
+    SymbolTable t(8);
+    ASSERT_EQ(t.intern("AAPL"), 0u);
+    ASSERT_EQ(t.intern("GOOGL"), 1u);
+    ASSERT_EQ(t.intern("AAPL"), 0u);
+    ASSERT_EQ(t.lookup("MSFT"), kInvalidSymbolId);
+    ASSERT_STREQ(t.name(1), "GOOGL");
+    ASSERT_EQ(t.intern("A_VERY_LONG_SYMBOL_NAME"), t.intern("A_VERY_LONG_SYM"));
+}
+
+TEST(SymbolTable, FullTableRejectsNewSymbols) {
+    SymbolTable t(3);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_NE(t.intern(("SYN" + std::to_string(i)).c_str()), kInvalidSymbolId);
+    }
+    ASSERT_EQ(t.intern("OVERFLOW"), kInvalidSymbolId);
+    ASSERT_EQ(t.intern("SYN2"), 2u);
+}
+
+TEST(OrderBookManager, UnknownSymbolIdsAreRejected) {
+    OrderBookManager m(4);
+    m.match(Order("AAPL", 150.0, 10, OrderType::Limit, OrderSide::BUY, 1));
+    const uint32_t aapl = m.symbols().lookup("AAPL");
+    // Interned but never traded, past the table, and the invalid marker
+    const uint32_t unknown[] = { aapl + 1, 4u, 1000u, kInvalidSymbolId };
+    for (uint32_t id : unknown) {
+        ASSERT_EQ(m.find(id), nullptr);
+        ASSERT_FALSE(m.cancel(id, 1));
+        ASSERT_FALSE(m.modify(id, 1, 5));
+        ASSERT_FALSE(m.replace(id, 1, 151.0, 5));
+    }
+    Order stray("AAPL", 150.0, 10, OrderType::Limit, OrderSide::SELL, 2);
+    stray.symbolId = 1000;
+    ASSERT_EQ(m.match(stray), 0u);
+    ASSERT_EQ(m.activeBooks(), 1u);
+    ASSERT_TRUE(m.cancel(aapl, 1));
+}
+
+TEST(OrderBookManager, RoutesOrdersToPerSymbolBooks) {
+    OrderBookManager m(16);
+    std::vector<Trade> trades;
+    m.setTradeCallback([&](const Trade& t) { trades.push_back(t); });
+
+    Order aaplBid("AAPL", 150.0, 10, OrderType::Limit, OrderSide::BUY, 1);
+    aaplBid.symbolId = m.symbols().intern("AAPL");
+    m.match(aaplBid);
+    // A GOOGL offer at the same price must not trade with the AAPL bid
+    m.match(Order("GOOGL", 150.0, 10, OrderType::Limit, OrderSide::SELL, 2));
+    ASSERT_EQ(m.tradeCount(), 0u);
+    ASSERT_EQ(m.activeBooks(), 2u);
+
+    m.match(Order("AAPL", 150.0, 4, OrderType::Limit, OrderSide::SELL, 3));
+    ASSERT_EQ(trades.size(), 1u);
+    ASSERT_EQ(trades[0].symbolId, m.symbols().lookup("AAPL"));
+    ASSERT_TRUE(m.cancel(m.symbols().lookup("GOOGL"), 2));
+    ASSERT_FALSE(m.cancel(m.symbols().lookup("AAPL"), 2));
+}
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "gtest/gtest.h"
 #include "OrderBook.hpp"
+#include <vector>
 
 TEST(OrderBook, SimpleSubmit) {
     OrderBook b;
@@ -9,3 +10,119 @@ TEST(OrderBook, SimpleSubmit) {
     b.processAll();
     SUCCEED();
 }
+
+template<typename Book>
+class OrderBookBackends : public ::testing::Test {};
+using BookTypes = ::testing::Types<OrderBook, LadderOrderBook>;
+TYPED_TEST_SUITE(OrderBookBackends, BookTypes);
+
+TYPED_TEST(OrderBookBackends, LimitOrdersRestWithoutCrossing) {
+    TypeParam b;
+    b.match(Order("SYM", 99.0, 10, OrderType::Limit, OrderSide::BUY));
+    b.match(Order("SYM", 101.0, 5, OrderType::Limit, OrderSide::SELL));
+    ASSERT_EQ(b.bestBid(), 99.0);
+    ASSERT_EQ(b.bestAsk(), 101.0);
+    ASSERT_EQ(b.tradeCount(), 0u);
+}
+
+TYPED_TEST(OrderBookBackends, CrossingOrderSweepsInPriceTimePriority) {
+    TypeParam b;
+    std::vector<Trade> trades;
+    b.setTradeCallback([&](const Trade& t) { trades.push_back(t); });
+    b.match(Order("SYM", 101.0, 5, OrderType::Limit, OrderSide::SELL));
+    b.match(Order("SYM", 100.0, 3, OrderType::Limit, OrderSide::SELL));
+    b.match(Order("SYM", 100.0, 4, OrderType::Limit, OrderSide::SELL));
+
+    ASSERT_EQ(b.match(Order("SYM", 101.0, 10, OrderType::Limit, OrderSide::BUY)), 10u);
+    ASSERT_EQ(trades.size(), 3u);
+    ASSERT_EQ(trades[0].price, 100.0);
+    ASSERT_EQ(trades[0].qty, 3u);
+    ASSERT_EQ(trades[1].price, 100.0);
+    ASSERT_EQ(trades[1].qty, 4u);
+    ASSERT_EQ(trades[2].price, 101.0);
+    ASSERT_EQ(trades[2].qty, 3u);
+    ASSERT_EQ(b.volumeAt(OrderSide::SELL, 101.0), 2u);
+    ASSERT_FALSE(b.hasBid());
+}
+
+TYPED_TEST(OrderBookBackends, TradeSinkReplacesTheCallbackForOneMatch) {
+    TypeParam b;
+    uint32_t viaCallback = 0, viaSink = 0;
+    b.setTradeCallback([&](const Trade& t) { viaCallback += t.qty; });
+    b.match(Order("SYM", 100.0, 5, OrderType::Limit, OrderSide::SELL));
+    b.match(Order("SYM", 100.0, 5, OrderType::Limit, OrderSide::SELL));
+
+    ASSERT_EQ(b.match(Order("SYM", 100.0, 3, OrderType::Limit, OrderSide::BUY),
+        [&](const Trade& t) { viaSink += t.qty; }), 3u);
+    ASSERT_EQ(viaSink, 3u);
+    ASSERT_EQ(viaCallback, 0u);
+    b.match(Order("SYM", 100.0, 4, OrderType::Limit, OrderSide::BUY));
+    ASSERT_EQ(viaCallback, 4u);
+    ASSERT_EQ(b.tradedVolume(), 7u);
+}
+
+TYPED_TEST(OrderBookBackends, MarketOrderRemainderDoesNotRest) {
+    TypeParam b;
+    b.match(Order("SYM", 100.0, 5, OrderType::Limit, OrderSide::BUY));
+    ASSERT_EQ(b.match(Order("SYM", 0.0, 8, OrderType::Market, OrderSide::SELL)), 5u);
+    ASSERT_FALSE(b.hasBid());
+    ASSERT_FALSE(b.hasAsk());
+    ASSERT_EQ(b.tradedVolume(), 5u);
+}
+
+TYPED_TEST(OrderBookBackends, CancelAndModifyById) {
+    TypeParam b;
+    b.match(Order("SYM", 100.0, 5, OrderType::Limit, OrderSide::BUY, 1));
+    b.match(Order("SYM", 100.0, 7, OrderType::Limit, OrderSide::BUY, 2));
+    b.match(Order("SYM", 99.0, 3, OrderType::Limit, OrderSide::BUY, 3));
+    ASSERT_EQ(b.restingOrders(), 3u);
+
+    ASSERT_TRUE(b.cancel(1));
+    ASSERT_FALSE(b.cancel(1));
+    ASSERT_EQ(b.volumeAt(OrderSide::BUY, 100.0), 7u);
+
+    ASSERT_TRUE(b.modify(2, 4));
+    ASSERT_EQ(b.volumeAt(OrderSide::BUY, 100.0), 4u);
+    ASSERT_TRUE(b.modify(2, 0));
+    ASSERT_EQ(b.bestBid(), 99.0);
+    ASSERT_EQ(b.restingOrders(), 1u);
+}
+
+TYPED_TEST(OrderBookBackends, ModifyUpLosesTimePriority) {
+    TypeParam b;
+    std::vector<uint64_t> makers;
+    b.setTradeCallback([&](const Trade& t) { makers.push_back(t.makerId); });
+    b.match(Order("SYM", 50.0, 5, OrderType::Limit, OrderSide::SELL, 10));
+    b.match(Order("SYM", 50.0, 5, OrderType::Limit, OrderSide::SELL, 11));
+    ASSERT_TRUE(b.modify(10, 6));
+    b.match(Order("SYM", 50.0, 11, OrderType::Limit, OrderSide::BUY, 12));
+    ASSERT_EQ(makers.size(), 2u);
+    ASSERT_EQ(makers[0], 11u);
+    ASSERT_EQ(makers[1], 10u);
+    ASSERT_EQ(b.restingOrders(), 0u);
+}
+
+TYPED_TEST(OrderBookBackends, ReplaceCanCross) {
+    TypeParam b;
+    b.match(Order("SYM", 101.0, 5, OrderType::Limit, OrderSide::SELL, 1));
+    b.match(Order("SYM", 99.0, 5, OrderType::Limit, OrderSide::BUY, 2));
+    ASSERT_TRUE(b.replace(2, 101.0, 8));
+    ASSERT_EQ(b.tradedVolume(), 5u);
+    ASSERT_EQ(b.bestBid(), 101.0);
+    ASSERT_EQ(b.volumeAt(OrderSide::BUY, 101.0), 3u);
+    ASSERT_FALSE(b.hasAsk());
+}
+
+TYPED_TEST(OrderBookBackends, OwnedPoolCapacityCapsRestingOrders) {
+    TypeParam b(kDefaultTickSize, nullptr, 16, 4);
+    for (uint64_t id = 1; id <= 5; ++id) {
+        b.match(Order("SYM", 100.0 - id, 10, OrderType::Limit, OrderSide::BUY, id));
+    }
+    ASSERT_EQ(b.restingOrders(), 4u);
+    ASSERT_EQ(b.rejectedCount(), 1u);
+    // A filled order hands its node back
+    b.match(Order("SYM", 99.0, 10, OrderType::Limit, OrderSide::SELL, 6));
+    b.match(Order("SYM", 95.0, 10, OrderType::Limit, OrderSide::BUY, 7));
+    ASSERT_EQ(b.restingOrders(), 4u);
+    ASSERT_EQ(b.rejectedCount(), 1u);
+}
@@ -0,0 +1,21 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "OrderIndex.hpp"
+#include <vector>
+
+TEST(OrderIndex, InsertFindEraseWithGrowth) {
+    OrderIndex<int> index(16);
+    std::vector<int> nodes(1000);
+    for (uint64_t id = 1; id <= 1000; ++id) {
+        ASSERT_TRUE(index.insert(id, &nodes[id - 1]));
+    }
+    ASSERT_FALSE(index.insert(7, &nodes[0]));
+    ASSERT_EQ(index.size(), 1000u);
+    for (uint64_t id = 1; id <= 1000; id += 2) {
+        ASSERT_TRUE(index.erase(id));
+    }
+    for (uint64_t id = 1; id <= 1000; ++id) {
+        ASSERT_EQ(index.find(id), (id % 2) ? nullptr : &nodes[id - 1]);
+    }
+    ASSERT_FALSE(index.erase(1));
+}
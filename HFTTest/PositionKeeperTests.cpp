@@ -0,0 +1,82 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "PositionKeeper.hpp"
+
+static int64_t px(double price) { return toFixedPrice(price); }
+
+TEST(PositionKeeper, AverageCostAndRealizedPnlThroughAFlip) {
+    PositionKeeper keeper(8);
+    keeper.onFill(3, OrderSide::BUY, 100, px(10.00));
+    keeper.onFill(3, OrderSide::BUY, 100, px(12.00));
+    ASSERT_EQ(keeper.position(3), 200);
+    ASSERT_EQ(keeper.averageCost(3), px(11.00));
+    ASSERT_EQ(keeper.realized(3), 0);
+
+    // Selling part of it realizes against the average, which stays put
+    keeper.onFill(3, OrderSide::SELL, 50, px(13.00));
+    ASSERT_EQ(keeper.position(3), 150);
+    ASSERT_EQ(keeper.averageCost(3), px(11.00));
+    ASSERT_EQ(keeper.realized(3), px(100.00));
+
+    // Selling through flat closes the long and opens a short at the fill
+    keeper.onFill(3, OrderSide::SELL, 250, px(10.00));
+    ASSERT_EQ(keeper.position(3), -100);
+    ASSERT_EQ(keeper.averageCost(3), px(10.00));
+    ASSERT_EQ(keeper.realized(3), px(100.00 - 150.00));
+
+    // Covering the short at a lower price makes money
+    keeper.onFill(3, OrderSide::BUY, 100, px(9.50));
+    ASSERT_EQ(keeper.position(3), 0);
+    ASSERT_EQ(keeper.averageCost(3), 0);
+    ASSERT_EQ(keeper.realized(3), px(-50.00 + 50.00));
+    ASSERT_EQ(keeper.totalRealized(), keeper.realized(3));
+    ASSERT_EQ(keeper.fills(), 5u);
+
+    // Out of range ids and empty fills are ignored
+    keeper.onFill(8, OrderSide::BUY, 100, px(1.00));
+    keeper.onFill(2, OrderSide::BUY, 0, px(1.00));
+    ASSERT_EQ(keeper.fills(), 5u);
+    ASSERT_EQ(keeper.position(8), 0);
+}
+
+TEST(PositionKeeper, RoundTripsLeaveNoRoundingResidue) {
+    PositionKeeper keeper(4);
+    // Three buys whose average is not a whole number of fixed-point units
+    keeper.onFill(0, OrderSide::BUY, 3, px(10.0001));
+    keeper.onFill(0, OrderSide::BUY, 3, px(10.0002));
+    keeper.onFill(0, OrderSide::BUY, 1, px(10.0004));
+    // Closed in uneven pieces, all at the same price
+    keeper.onFill(0, OrderSide::SELL, 2, px(10.0010));
+    keeper.onFill(0, OrderSide::SELL, 4, px(10.0010));
+    keeper.onFill(0, OrderSide::SELL, 1, px(10.0010));
+    ASSERT_EQ(keeper.position(0), 0);
+    // 7 shares at 10.0010 less what they cost, to the unit
+    const int64_t cost = 3 * px(10.0001) + 3 * px(10.0002) + px(10.0004);
+    ASSERT_EQ(keeper.realized(0), 7 * px(10.0010) - cost);
+}
+
+TEST(PositionKeeper, MarkToMarketValuesOpenPositionsAtTheirMarks) {
+    PositionKeeper keeper(1024);
+    keeper.onFill(1, OrderSide::BUY, 100, px(50.00));
+    keeper.onFill(700, OrderSide::SELL, 20, px(200.00));
+    keeper.onFill(5, OrderSide::BUY, 10, px(1.00));
+    ASSERT_EQ(keeper.symbols(), 701u);
+
+    // Nothing is marked yet, so nothing is unrealized
+    ASSERT_EQ(keeper.markToMarket(), 0);
+
+    keeper.setMark(1, px(51.00));
+    keeper.setMark(700, px(210.00));
+    ASSERT_EQ(keeper.markToMarket(), px(100.00 - 200.00));
+    ASSERT_EQ(keeper.unrealized(1), px(100.00));
+    ASSERT_EQ(keeper.unrealized(700), px(-200.00));
+    ASSERT_EQ(keeper.unrealized(5), 0);
+    ASSERT_EQ(keeper.totalUnrealized(), px(-100.00));
+
+    // Closing moves the P&L from unrealized to realized
+    keeper.onFill(1, OrderSide::SELL, 100, px(51.00));
+    keeper.markToMarket();
+    ASSERT_EQ(keeper.unrealized(1), 0);
+    ASSERT_EQ(keeper.totalRealized(), px(100.00));
+    ASSERT_DOUBLE_EQ(keeper.pnl(), 100.00 - 200.00);
+}
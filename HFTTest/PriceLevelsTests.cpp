@@ -0,0 +1,78 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "PriceLevels.hpp"
+#include <vector>
+
+struct TestLevel { uint32_t qty = 0; };
+
+TEST(TickLadder, BestPriceTracksBitmap) {
+    TickLadder<TestLevel, false, 256> bids;
+    bids.insert(10000).qty = 5;
+    bids.insert(10003).qty = 7;
+    bids.insert(9990).qty = 1;
+    ASSERT_EQ(bids.bestPrice(), 10003);
+    bids.erase(10003);
+    ASSERT_EQ(bids.bestPrice(), 10000);
+    ASSERT_EQ(bids.size(), 2u);
+
+    TickLadder<TestLevel, true, 256> asks;
+    asks.insert(10010).qty = 1;
+    asks.insert(10005).qty = 2;
+    ASSERT_EQ(asks.bestPrice(), 10005);
+    ASSERT_EQ(asks.find(10010)->qty, 1u);
+    ASSERT_EQ(asks.find(10011), nullptr);
+}
+
+TEST(TickLadder, RecentresAndSpillsFarLevels) {
+    TickLadder<TestLevel, true, 256> asks;
+    asks.insert(10000).qty = 3;
+    asks.insert(10100).qty = 4;     // recentres between the two
+    ASSERT_EQ(asks.find(10000)->qty, 3u);
+    asks.insert(50000).qty = 9;     // too far away, parked in overflow
+    ASSERT_EQ(asks.size(), 3u);
+    ASSERT_EQ(asks.bestPrice(), 10000);
+    asks.erase(10000);
+    asks.erase(10100);
+    ASSERT_EQ(asks.bestPrice(), 50000);
+    ASSERT_EQ(asks.find(50000)->qty, 9u);
+    asks.erase(50000);
+    ASSERT_TRUE(asks.empty());
+}
+
+TEST(TickLadder, FollowsTheBestAfterAPriceJump) {
+    TickLadder<TestLevel, true, 256> asks;
+    asks.insert(10000).qty = 1;
+    asks.insert(10001).qty = 1;
+    // A 50-tick move stays in the window; a 5000-tick gap moves the window
+    // to the new best and spills the stale levels
+    asks.insert(9950).qty = 2;
+    ASSERT_EQ(asks.overflowLevels(), 0u);
+    asks.insert(5000).qty = 3;
+    ASSERT_EQ(asks.bestPrice(), 5000);
+    ASSERT_EQ(asks.overflowLevels(), 3u);
+    for (Price p = 5001; p < 5100; ++p) asks.insert(p);
+    ASSERT_EQ(asks.overflowLevels(), 3u);
+
+    // A deep order far behind the best leaves the window where it is
+    asks.insert(20000);
+    ASSERT_EQ(asks.overflowLevels(), 4u);
+    asks.insert(5100);
+    ASSERT_EQ(asks.overflowLevels(), 4u);
+
+    // Once the near levels drain, the best is in overflow; the next insert
+    // near it brings the window back
+    for (Price p = 5000; p <= 5100; ++p) asks.erase(p);
+    ASSERT_EQ(asks.bestPrice(), 9950);
+    asks.insert(9960);
+    ASSERT_EQ(asks.overflowLevels(), 1u);     // only 20000 is left out
+    ASSERT_EQ(asks.find(10001)->qty, 1u);
+    ASSERT_EQ(asks.size(), 5u);
+}
+
+TEST(TickLadder, ForEachLevelVisitsBestFirst) {
+    TickLadder<TestLevel, false, 256> bids;
+    for (Price p : { 10000, 10050, 9990, 90000, 100 }) bids.insert(p);
+    std::vector<Price> seen;
+    bids.forEachLevel([&](Price p, TestLevel&) { seen.push_back(p); return true; });
+    ASSERT_EQ(seen, (std::vector<Price>{ 90000, 10050, 10000, 9990, 100 }));
+}
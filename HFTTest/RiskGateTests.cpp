@@ -0,0 +1,186 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "RiskGate.hpp"
+#include <atomic>
+#include <thread>
+
+static Order makeOrder(uint32_t symbolId, double price, int qty, OrderSide side = OrderSide::BUY,
+    OrderType type = OrderType::Limit) {
+    Order o("TEST", price, qty, type, side);
+    o.symbolId = symbolId;
+    return o;
+}
+
+static std::unique_ptr<RiskLimitTable> limitsFor(size_t symbols) {
+    SymbolRiskLimits l;
+    l.maxOrderQty = 1000;
+    l.maxPosition = 1500;
+    l.maxNotional = 100000.0;
+    l.priceBand = 0.05;
+    return std::make_unique<RiskLimitTable>(symbols, l);
+}
+
+TEST(RiskGate, EachLimitRejectsWithItsReason) {
+    RiskGate gate(16);
+    // Nothing configured: every symbol is disabled
+    ASSERT_EQ(gate.check(makeOrder(1, 100.0, 10)), RiskReject::SymbolDisabled);
+
+    auto limits = limitsFor(4);
+    limits->symbols[2].maxOrderQty = 0;
+    limits->maxGrossExposure = 250000.0;
+    gate.setLimits(std::move(limits));
+
+    ASSERT_EQ(gate.check(makeOrder(1, 100.0, 10)), RiskReject::NoReference);
+    gate.onTrade(1, 100.0);
+    ASSERT_EQ(gate.check(makeOrder(1, 100.0, 10)), RiskReject::None);
+    ASSERT_EQ(gate.check(makeOrder(2, 100.0, 10)), RiskReject::SymbolDisabled);
+    ASSERT_EQ(gate.check(makeOrder(7, 100.0, 10)), RiskReject::SymbolDisabled);     // past the table
+    ASSERT_EQ(gate.check(makeOrder(1, 100.0, 1001)), RiskReject::MaxQty);
+    ASSERT_EQ(gate.check(makeOrder(1, 100.0, 0)), RiskReject::MaxQty);
+
+    // Band around the last trade, then around the mid once both sides quote
+    ASSERT_EQ(gate.check(makeOrder(1, 105.0, 10)), RiskReject::None);
+    ASSERT_EQ(gate.check(makeOrder(1, 105.5, 10)), RiskReject::PriceBand);
+    gate.onQuote(1, 109.0, 111.0);
+    ASSERT_EQ(gate.check(makeOrder(1, 105.5, 10)), RiskReject::None);
+    ASSERT_EQ(gate.check(makeOrder(1, 104.0, 10)), RiskReject::PriceBand);
+    // Market orders are priced at the reference (110 here)
+    ASSERT_EQ(gate.check(makeOrder(1, 0.0, 950, OrderSide::BUY, OrderType::Market)), RiskReject::MaxNotional);
+    ASSERT_EQ(gate.check(makeOrder(1, 0.0, 900, OrderSide::BUY, OrderType::Market)), RiskReject::None);
+
+    // Position counts the order as if it filled, in either direction
+    gate.onFill(1, OrderSide::BUY, 900, 110.0);
+    ASSERT_EQ(gate.position(1), 900);
+    ASSERT_DOUBLE_EQ(gate.grossExposure(), 99000.0);
+    // The three small buys accepted above are still working until closed
+    ASSERT_EQ(gate.working(1, OrderSide::BUY), 30);
+    gate.onOrderClosed(1, OrderSide::BUY, 30);
+    ASSERT_EQ(gate.check(makeOrder(1, 110.0, 700)), RiskReject::Position);
+    ASSERT_EQ(gate.check(makeOrder(1, 110.0, 600)), RiskReject::None);
+    ASSERT_EQ(gate.check(makeOrder(1, 110.0, 900, OrderSide::SELL)), RiskReject::None);
+
+    // Gross exposure sums |position| across symbols
+    gate.onTrade(3, 200.0);
+    gate.onFill(3, OrderSide::SELL, 450, 200.0);
+    ASSERT_DOUBLE_EQ(gate.grossExposure(), 189000.0);
+    ASSERT_EQ(gate.check(makeOrder(3, 200.0, 400, OrderSide::SELL)), RiskReject::GrossExposure);
+    ASSERT_EQ(gate.check(makeOrder(3, 200.0, 300, OrderSide::SELL)), RiskReject::None);
+    // Buying back reduces |position|, so it adds no exposure
+    ASSERT_EQ(gate.check(makeOrder(3, 200.0, 450)), RiskReject::None);
+    // Flattening gives the exposure back
+    gate.onFill(3, OrderSide::BUY, 450, 200.0);
+    ASSERT_DOUBLE_EQ(gate.grossExposure(), 99000.0);
+
+    ASSERT_EQ(gate.rejected(RiskReject::PriceBand), 2u);
+    ASSERT_EQ(gate.rejected(RiskReject::SymbolDisabled), 3u);
+    ASSERT_EQ(gate.rejectedTotal(), 11u);
+}
+
+TEST(RiskGate, WorkingOrdersCountTowardThePosition) {
+    RiskGate gate(4);
+    gate.setLimits(limitsFor(4));
+    gate.onTrade(0, 100.0);
+
+    ASSERT_EQ(gate.check(makeOrder(0, 100.0, 1000)), RiskReject::None);
+    // Two working buys could fill together past the limit
+    ASSERT_EQ(gate.check(makeOrder(0, 100.0, 600)), RiskReject::Position);
+    // Sells are worked out separately
+    ASSERT_EQ(gate.check(makeOrder(0, 100.0, 1000, OrderSide::SELL)), RiskReject::None);
+    ASSERT_EQ(gate.working(0, OrderSide::SELL), 1000);
+
+    // A partial fill moves quantity from working to the position
+    gate.onFill(0, OrderSide::BUY, 400, 100.0);
+    ASSERT_EQ(gate.working(0, OrderSide::BUY), 600);
+    ASSERT_EQ(gate.check(makeOrder(0, 100.0, 600)), RiskReject::Position);
+    // Cancelling the rest frees the room again
+    gate.onOrderClosed(0, OrderSide::BUY, 600);
+    ASSERT_EQ(gate.check(makeOrder(0, 100.0, 600)), RiskReject::None);
+    ASSERT_EQ(gate.working(0, OrderSide::BUY), 600);
+}
+
+TEST(RiskGate, FlatteningPassesAtTheExposureCap) {
+    RiskGate gate(4);
+    auto limits = limitsFor(4);
+    limits->maxGrossExposure = 100000.0;
+    gate.setLimits(std::move(limits));
+    gate.onTrade(0, 100.0);
+    gate.onFill(0, OrderSide::BUY, 1000, 100.0);
+    ASSERT_DOUBLE_EQ(gate.grossExposure(), 100000.0);
+
+    ASSERT_EQ(gate.check(makeOrder(0, 100.0, 1)), RiskReject::GrossExposure);
+    ASSERT_EQ(gate.check(makeOrder(0, 100.0, 1000, OrderSide::SELL)), RiskReject::None);
+    // With that sell working, a second one ends as far from flat as the
+    // position is now; a third would end further
+    ASSERT_EQ(gate.check(makeOrder(0, 100.0, 1000, OrderSide::SELL)), RiskReject::None);
+    ASSERT_EQ(gate.check(makeOrder(0, 100.0, 500, OrderSide::SELL)), RiskReject::GrossExposure);
+}
+
+TEST(RiskGate, OrderRateAllowsBurstThenSpacing) {
+    RiskGate gate(4);
+    auto limits = limitsFor(4);
+    limits->maxOrdersPerSecond = 1000;
+    limits->rateBurst = 3;
+    gate.setLimits(std::move(limits));
+    gate.onTrade(0, 100.0);
+
+    // One order per ms, with three allowed back to back
+    const uint64_t start = TscClock::now();
+    const uint64_t ms = TscClock::fromNanos(1000000);
+    const Order o = makeOrder(0, 100.0, 1);
+    ASSERT_EQ(gate.check(o, start), RiskReject::None);
+    ASSERT_EQ(gate.check(o, start), RiskReject::None);
+    ASSERT_EQ(gate.check(o, start), RiskReject::None);
+    ASSERT_EQ(gate.check(o, start), RiskReject::OrderRate);
+    ASSERT_EQ(gate.check(o, start + ms / 2), RiskReject::OrderRate);
+    ASSERT_EQ(gate.check(o, start + ms + ms / 10), RiskReject::None);
+    ASSERT_EQ(gate.check(o, start + ms + ms / 10), RiskReject::OrderRate);
+    // Idle long enough and the burst is back
+    const uint64_t later = start + 10 * ms;
+    for (int i = 0; i < 3; ++i) ASSERT_EQ(gate.check(o, later), RiskReject::None);
+    ASSERT_EQ(gate.check(o, later), RiskReject::OrderRate);
+}
+
+TEST(RiskGate, LimitSwapsReachTheCheckerAndRetiredTablesAreFreed) {
+    RiskGate gate(4);
+    gate.setLimits(limitsFor(4));
+    gate.onTrade(0, 100.0);
+    const Order o = makeOrder(0, 100.0, 500);
+    ASSERT_EQ(gate.check(o), RiskReject::None);
+
+    // Until the checker runs again, the replaced table stays alive
+    auto tighter = gate.copyLimits();
+    tighter->symbols[0].maxOrderQty = 100;
+    gate.setLimits(std::move(tighter));
+    ASSERT_EQ(gate.retiredTables(), 1u);
+    ASSERT_EQ(gate.check(o), RiskReject::MaxQty);
+    gate.reclaim();
+    ASSERT_EQ(gate.retiredTables(), 0u);
+
+    // A control thread swapping tables while the checker runs
+    std::atomic<bool> stop{ false };
+    std::thread control([&] {
+        for (uint32_t i = 0; !stop.load(); ++i) {
+            auto t = gate.copyLimits();
+            t->symbols[0].maxOrderQty = (i & 1) ? 100 : 1000;
+            gate.setLimits(std::move(t));
+            std::this_thread::yield();
+        }
+    });
+    uint64_t accepted = 0, rejected = 0;
+    for (int i = 0; i < 200000; ++i) {
+        RiskReject r = gate.check(o);
+        if (r == RiskReject::None) {
+            // Nothing fills, so close it to keep the position check out of the way
+            gate.onOrderClosed(o.symbolId, o.side, static_cast<uint32_t>(o.qty));
+            ++accepted;
+        }
+        else if (r == RiskReject::MaxQty) ++rejected;
+        else FAIL() << toString(r);
+    }
+    stop.store(true);
+    control.join();
+    ASSERT_EQ(accepted + rejected, 200000u);
+    gate.check(o);
+    gate.reclaim();
+    ASSERT_EQ(gate.retiredTables(), 0u);
+}
@@ -0,0 +1,149 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "RollingAnalytics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <random>
+
+static int64_t px(double price) { return toFixedPrice(price); }
+
+TEST(RollingAnalytics, CountWindowTracksTheLastTrades) {
+    RollingWindowConfig config;
+    config.maxTrades = 3;
+    RollingAnalytics stats(4, config);
+    ASSERT_EQ(stats.vwap(1), 0.0);
+    ASSERT_EQ(stats.minPrice(1), 0.0);
+
+    stats.onTrade(1, px(10.00), 100, 1);
+    stats.onTrade(1, px(11.00), 300, 2);
+    stats.onTrade(1, px(9.00), 100, 3);
+    ASSERT_EQ(stats.trades(1), 3u);
+    ASSERT_EQ(stats.volume(1), 500u);
+    ASSERT_NEAR(stats.vwap(1), (1000.0 + 3300.0 + 900.0) / 500.0, 1e-12);
+    ASSERT_NEAR(stats.average(1), 10.0, 1e-12);
+    ASSERT_DOUBLE_EQ(stats.minPrice(1), 9.00);
+    ASSERT_DOUBLE_EQ(stats.maxPrice(1), 11.00);
+
+    // The fourth trade pushes out the first
+    stats.onTrade(1, px(12.00), 100, 4);
+    ASSERT_EQ(stats.trades(1), 3u);
+    ASSERT_NEAR(stats.vwap(1), (3300.0 + 900.0 + 1200.0) / 500.0, 1e-12);
+    ASSERT_DOUBLE_EQ(stats.minPrice(1), 9.00);
+    ASSERT_DOUBLE_EQ(stats.maxPrice(1), 12.00);
+    // Then the 11 and the 9 leave, one at a time
+    stats.onTrade(1, px(10.50), 100, 5);
+    ASSERT_DOUBLE_EQ(stats.minPrice(1), 9.00);
+    stats.onTrade(1, px(10.00), 100, 6);
+    ASSERT_DOUBLE_EQ(stats.minPrice(1), 10.00);
+    ASSERT_DOUBLE_EQ(stats.maxPrice(1), 12.00);
+
+    // Other symbols are untouched; EMA alpha is 2 / (3 + 1)
+    ASSERT_EQ(stats.trades(0), 0u);
+    RollingAnalytics ema(1, config);
+    ema.onTrade(0, px(10.00), 1, 0);
+    ema.onTrade(0, px(12.00), 1, 0);
+    ASSERT_NEAR(ema.ema(0), 11.0, 1e-12);
+}
+
+TEST(RollingAnalytics, TimeWindowDropsTradesOlderThanTheSpan) {
+    RollingWindowConfig config;
+    config.maxTrades = 16;
+    config.spanNs = 1000;
+    RollingAnalytics stats(2, config);
+    stats.onTrade(0, px(10.00), 10, 100);
+    stats.onTrade(0, px(20.00), 10, 600);
+    stats.onTrade(0, px(30.00), 10, 1000);
+    ASSERT_EQ(stats.trades(0), 3u);
+    // At 1100 the trade at 100 is a full span old
+    stats.onTrade(0, px(40.00), 10, 1100);
+    ASSERT_EQ(stats.trades(0), 3u);
+    ASSERT_DOUBLE_EQ(stats.minPrice(0), 20.00);
+    // Without new trades, expire() ages the window out
+    stats.expire(0, 2050);
+    ASSERT_EQ(stats.trades(0), 1u);
+    ASSERT_NEAR(stats.vwap(0), 40.00, 1e-12);
+    stats.expire(0, 5000);
+    ASSERT_EQ(stats.trades(0), 0u);
+    ASSERT_EQ(stats.vwap(0), 0.0);
+    ASSERT_EQ(stats.maxPrice(0), 0.0);
+    ASSERT_EQ(stats.volatility(0), 0.0);
+}
+
+// Random trades checked against a recomputation of the window from scratch
+static void checkAgainstBruteForce(RollingWindowConfig config) {
+    struct T { uint64_t time; int64_t price; uint32_t qty; double ret; bool hasRet; };
+    const uint32_t symbols = 5;
+    RollingAnalytics stats(symbols, config);
+    std::vector<std::deque<T>> windows(symbols);
+    std::vector<int64_t> last(symbols, 0);
+    std::mt19937 rng(7);
+    uint64_t now = 0;
+    for (int i = 0; i < 20000; ++i) {
+        const uint32_t id = rng() % symbols;
+        now += rng() % 50;
+        const int64_t price = px(100.0) + static_cast<int64_t>(rng() % 2000) - 1000;
+        const uint32_t qty = 1 + rng() % 500;
+        stats.onTrade(id, price, qty, now);
+
+        auto& w = windows[id];
+        w.push_back({ now, price, qty, last[id] ? static_cast<double>(price - last[id]) / last[id] : 0.0, last[id] != 0 });
+        last[id] = price;
+        while (w.size() > config.maxTrades) w.pop_front();
+        while (config.spanNs && now - w.front().time >= config.spanNs) w.pop_front();
+
+        double notional = 0, volume = 0, mean = 0;
+        int64_t lo = INT64_MAX, hi = INT64_MIN;
+        int n = 0;
+        for (const T& t : w) {
+            notional += static_cast<double>(t.price) * t.qty;
+            volume += t.qty;
+            lo = (std::min)(lo, t.price);
+            hi = (std::max)(hi, t.price);
+            if (t.hasRet) { mean += t.ret; ++n; }
+        }
+        double var = 0;
+        if (n) mean /= n;
+        for (const T& t : w) if (t.hasRet) var += (t.ret - mean) * (t.ret - mean);
+        const double sd = n >= 2 ? std::sqrt(var / (n - 1)) : 0.0;
+
+        ASSERT_EQ(stats.trades(id), w.size());
+        ASSERT_EQ(stats.volume(id), static_cast<uint64_t>(volume));
+        ASSERT_NEAR(stats.vwap(id), notional / volume / kPriceScale, 1e-9);
+        ASSERT_DOUBLE_EQ(stats.minPrice(id), static_cast<double>(lo) / kPriceScale);
+        ASSERT_DOUBLE_EQ(stats.maxPrice(id), static_cast<double>(hi) / kPriceScale);
+        ASSERT_NEAR(stats.volatility(id), sd, 1e-9);
+    }
+}
+
+TEST(RollingAnalytics, MatchesARecomputedWindow) {
+    RollingWindowConfig byCount;
+    byCount.maxTrades = 37;
+    checkAgainstBruteForce(byCount);
+    RollingWindowConfig byTime;
+    byTime.maxTrades = 256;
+    byTime.spanNs = 600;
+    checkAgainstBruteForce(byTime);
+}
+
+TEST(RollingAnalytics, BatchSignalsMatchPerSymbolReads) {
+    RollingAnalytics stats(67);
+    std::mt19937 rng(11);
+    for (int i = 0; i < 5000; ++i) {
+        // Leave some symbols with no trades and some with a single one
+        const uint32_t id = rng() % 60;
+        if (id % 7 == 3) continue;
+        if (id % 7 == 5 && stats.trades(id)) continue;
+        stats.onTrade(id, px(50.0) + static_cast<int64_t>(rng() % 1000), 1 + rng() % 100, i);
+    }
+    std::vector<double> vwap(67, -1.0), vol(67, -1.0);
+    stats.signals(0, 67, vwap.data(), vol.data());
+    for (uint32_t id = 0; id < 67; ++id) {
+        ASSERT_NEAR(vwap[id], stats.vwap(id), 1e-12) << id;
+        ASSERT_NEAR(vol[id], stats.volatility(id), 1e-15) << id;
+    }
+    // Ranges are clamped to the symbols that exist
+    std::vector<double> tail(8, -1.0), tailVol(8, -1.0);
+    stats.signals(63, 8, tail.data(), tailVol.data());
+    ASSERT_EQ(tail[4], -1.0);
+}
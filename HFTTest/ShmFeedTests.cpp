@@ -0,0 +1,92 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "ShmFeed.hpp"
+#include <string>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+static std::string regionName(const char* name) {
+#ifdef _WIN32
+    return std::string("/") + name;
+#else
+    return std::string("/") + name + "_" + std::to_string(getpid());
+#endif
+}
+
+TEST(ShmFeed, DatagramsArriveInOrderAndFullRingRefusesWrites) {
+    const std::string name = regionName("hft_shm_feed");
+    ShmFeedWriter writer;
+    ASSERT_FALSE(writer.open(name));        // no reader has created it yet
+
+    ShmFeedReader reader;
+    ASSERT_TRUE(reader.create(name, 8));
+    ASSERT_TRUE(writer.open(name));
+
+    uint32_t length = 0;
+    ASSERT_EQ(reader.peek(0, length), nullptr);
+
+    // Fill the ring; the ninth write has nowhere to go
+    for (int i = 0; i < 8; ++i) {
+        std::string msg = "AAPL,150.0" + std::to_string(i) + ",100,BUY";
+        ASSERT_TRUE(writer.write(msg.data(), msg.size()));
+    }
+    ASSERT_FALSE(writer.write("X", 1));
+
+    // Peeked in place, released in one go
+    const char* first = reader.peek(0, length);
+    ASSERT_NE(first, nullptr);
+    ASSERT_EQ(std::string(first, length), "AAPL,150.00,100,BUY");
+    const char* third = reader.peek(2, length);
+    ASSERT_NE(third, nullptr);
+    ASSERT_EQ(std::string(third, length), "AAPL,150.02,100,BUY");
+    reader.release(3);
+    ASSERT_EQ(reader.received(), 3u);
+
+    // Released slots are reused, wrapping around the ring
+    for (int i = 8; i < 11; ++i) {
+        std::string msg = "MSFT,300.0" + std::to_string(i - 8) + ",50,SELL";
+        ASSERT_TRUE(writer.write(msg.data(), msg.size()));
+    }
+    ASSERT_FALSE(writer.write("X", 1));
+    for (int i = 3; i < 11; ++i) {
+        const char* data = reader.peek(0, length);
+        ASSERT_NE(data, nullptr);
+        std::string expected = i < 8 ? "AAPL,150.0" + std::to_string(i) + ",100,BUY"
+            : "MSFT,300.0" + std::to_string(i - 8) + ",50,SELL";
+        ASSERT_EQ(std::string(data, length), expected);
+        reader.release(1);
+    }
+    ASSERT_EQ(reader.peek(0, length), nullptr);
+    ASSERT_EQ(writer.written(), 11u);
+
+    // Oversized datagrams are cut to what a UDP feed could carry
+    std::string big(kMaxDatagramSize + 100, 'x');
+    ASSERT_TRUE(writer.write(big.data(), big.size()));
+    ASSERT_NE(reader.peek(0, length), nullptr);
+    ASSERT_EQ(length, kMaxDatagramSize);
+}
+
+TEST(ShmFeed, HeartbeatsShowBothSidesAttached) {
+    const std::string name = regionName("hft_shm_beat");
+    ShmFeedReader reader;
+    ASSERT_TRUE(reader.create(name));
+    ASSERT_FALSE(reader.peerAlive());
+
+    ShmFeedWriter writer;
+    ASSERT_TRUE(writer.open(name));
+    // The reader beat when it created the ring, the writer when it attached
+    ASSERT_TRUE(writer.peerAlive());
+    reader.heartbeat();
+    ASSERT_TRUE(reader.peerAlive());
+
+    // A second writer picks up where the first left off
+    ASSERT_TRUE(writer.write("A", 1));
+    writer.close();
+    ShmFeedWriter next;
+    ASSERT_TRUE(next.open(name));
+    ASSERT_TRUE(next.write("B", 1));
+    uint32_t length = 0;
+    ASSERT_EQ(*reader.peek(0, length), 'A');
+    ASSERT_EQ(*reader.peek(1, length), 'B');
+}
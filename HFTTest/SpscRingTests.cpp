@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "SpscRing.hpp"
+#include <thread>
+
+TEST(SpscRing, PushPopUntilFull) {
+    SpscRing<int, 4> r;
+    for (int i = 0; i < 4; ++i) ASSERT_TRUE(r.tryPush(i));
+    ASSERT_FALSE(r.tryPush(99));
+    int v = -1;
+    ASSERT_TRUE(r.tryPop(v));
+    ASSERT_EQ(v, 0);
+    ASSERT_TRUE(r.tryPush(4));
+    for (int i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(r.tryPop(v));
+        ASSERT_EQ(v, i);
+    }
+    ASSERT_FALSE(r.tryPop(v));
+}
+
+TEST(SpscRing, BulkOperationsWrapAround) {
+    SpscRing<int, 8> r;
+    int in[6] = { 1, 2, 3, 4, 5, 6 };
+    int out[8] = {};
+    ASSERT_EQ(r.pushBulk(in, 6), 6u);
+    ASSERT_EQ(r.popBulk(out, 4), 4u);
+    ASSERT_EQ(r.pushBulk(in, 6), 6u);      // wraps past the end of the slot array
+    ASSERT_EQ(r.pushBulk(in, 6), 0u);
+    ASSERT_EQ(r.popBulk(out, 8), 8u);
+    ASSERT_EQ(out[0], 5);
+    ASSERT_EQ(out[2], 1);
+    ASSERT_EQ(out[7], 6);
+    ASSERT_TRUE(r.empty());
+}
+
+TEST(SpscRing, CrossThreadPreservesOrder) {
+    SpscRing<uint64_t, 1024> r;
+    const uint64_t count = 50000;
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < count; ++i) {
+            while (!r.tryPush(i)) {}
+        }
+    });
+    uint64_t expected = 0, buf[32];
+    while (expected < count) {
+        size_t n = r.popBulk(buf, 32);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(buf[i], expected++);
+    }
+    producer.join();
+}
@@ -0,0 +1,56 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "StageLatency.hpp"
+#include <map>
+#include <memory>
+#include <string>
+
+namespace {
+struct TestRegistry {
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> stages;
+    LatencyHistogram& addStage(const std::string& name) {
+        auto& h = stages[name];
+        if (!h) h = std::make_unique<LatencyHistogram>();
+        return *h;
+    }
+    HistogramSnapshot snap(const std::string& name) { return HistogramSnapshot(*stages.at(name)); }
+};
+}
+
+TEST(StageLatency, OffsetsSaturateAndMarkTaken) {
+    OrderStamps s;
+    s.rx = 1000;
+    ASSERT_EQ(s.since(1500), 500u);
+    ASSERT_EQ(s.since(1000), 1u);     // taken, even if no time passed
+    ASSERT_EQ(s.since(900), 1u);
+    ASSERT_EQ(s.since(1000 + (uint64_t(1) << 40)), UINT32_MAX);
+
+    s.markSent(0);
+    ASSERT_EQ(s.sentBefore, 0u);      // no send time
+    s.markSent(400);
+    ASSERT_EQ(s.sentBefore, 600u);
+}
+
+TEST(StageLatency, RecordsEachHop) {
+    TestRegistry registry;
+    StageLatency stages(registry);
+    ASSERT_EQ(registry.stages.size(), static_cast<size_t>(StageLatency::kStageCount));
+
+    OrderStamps s;
+    s.rx = 1;
+    s.parsed = 100;
+    s.enqueued = 150;
+    s.dequeued = 1150;
+    s.applied = 1400;
+    stages.record(s);
+
+    // Convert the expected tick deltas the same way the recorder does
+    ASSERT_EQ(registry.snap("ingest").max(), TscClock::toNanos(100));
+    ASSERT_EQ(registry.snap("enqueue").max(), TscClock::toNanos(50));
+    ASSERT_EQ(registry.snap("queue").max(), TscClock::toNanos(1000));
+    ASSERT_EQ(registry.snap("book").max(), TscClock::toNanos(250));
+    ASSERT_EQ(registry.snap("total").max(), TscClock::toNanos(1400));
+    // Stamps that were never taken record nothing
+    ASSERT_EQ(registry.snap("wire").count(), 0u);
+    ASSERT_EQ(registry.snap("fill").count(), 0u);
+}
@@ -0,0 +1,254 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "MarketMaker.hpp"
+#include "OrderBookManager.hpp"
+#include <string>
+#include <vector>
+
+// Records every event it sees into a shared log
+struct Recorder : StrategyBase<Recorder> {
+    std::vector<std::string>* log;
+    explicit Recorder(std::vector<std::string>* l) : log(l) {}
+
+    void onBookUpdate(const BookUpdate& u, OrderBuffer& out) {
+        log->push_back("book" + std::to_string(strategyIndex()));
+        sendLimit(out, u.symbolId, OrderSide::BUY, u.bid, 1);
+    }
+    void onFill(const Fill& f, OrderBuffer&) { log->push_back("fill" + std::to_string(strategyIndex()) + ":" + std::to_string(f.qty)); }
+};
+
+// Only cares about trades; the other handlers are the base's no-ops
+struct TradeCounter : StrategyBase<TradeCounter> {
+    uint64_t trades = 0;
+    void onTrade(const Trade&, OrderBuffer&) { ++trades; }
+    static const char* name() { return "trade counter"; }
+};
+
+static BookUpdate quote(uint32_t symbolId, double bid, double ask) {
+    BookUpdate u;
+    u.symbolId = symbolId;
+    u.bid = bid;
+    u.ask = ask;
+    u.bidQty = u.askQty = 100;
+    return u;
+}
+
+TEST(Strategy, HostDispatchesInOrderAndRoutesFillsToTheSender) {
+    std::vector<std::string> log;
+    StrategyHost<Recorder, TradeCounter, Recorder> host{ Recorder(&log), TradeCounter(), Recorder(&log) };
+    ASSERT_EQ(host.strategy<2>().strategyIndex(), 2u);
+    ASSERT_STREQ(host.name(0), "strategy");
+    ASSERT_STREQ(host.name(1), "trade counter");
+
+    host.onBookUpdate(quote(4, 10.0, 10.1));
+    ASSERT_EQ(log, (std::vector<std::string>{ "book0", "book2" }));
+    OrderBuffer& out = host.outbound();
+    ASSERT_EQ(out.size(), 2u);
+    ASSERT_TRUE(isStrategyOrder(out[0].orderId));
+    ASSERT_EQ(strategyOfOrder(out[0].orderId), 0u);
+    ASSERT_EQ(strategyOfOrder(out[1].orderId), 2u);
+    ASSERT_NE(out[0].orderId, out[1].orderId);
+    ASSERT_EQ(out[1].symbolId, 4u);
+    ASSERT_FALSE(isStrategyOrder(12345));
+
+    // The fill goes to whoever sent the order, and only to them
+    Fill f;
+    f.orderId = out[1].orderId;
+    f.qty = 7;
+    host.onFill(f);
+    ASSERT_EQ(log.back(), "fill2:7");
+    ASSERT_EQ(log.size(), 3u);
+
+    Trade t;
+    host.onTrade(t);
+    ASSERT_EQ(host.strategy<1>().trades, 1u);
+
+    ASSERT_EQ(host.stats(0).events, 2u);            // book update and trade
+    ASSERT_EQ(host.stats(0).requests, 1u);
+    ASSERT_EQ(host.stats(1).events, 2u);
+    ASSERT_EQ(host.stats(1).requests, 0u);
+    ASSERT_EQ(host.stats(2).events, 3u);            // plus its fill
+    ASSERT_GE(host.stats(2).maxTicks * host.stats(2).events, host.stats(2).ticks);
+
+    // A full buffer refuses requests instead of growing
+    out.clear();
+    for (int i = 0; i < 200; ++i) host.onBookUpdate(quote(4, 10.0, 10.1));
+    ASSERT_EQ(out.size(), out.capacity());
+    ASSERT_EQ(out.dropped(), 400u - out.capacity());
+}
+
+TEST(Strategy, MarketMakerQuotesAroundTheMidAndLeansOnInventory) {
+    MarketMakerConfig config;
+    config.halfSpread = 0.05;
+    config.quoteQty = 100;
+    config.maxPosition = 200;
+    config.skewPerShare = 0.0002;
+    config.requoteDistance = 0.02;
+    StrategyHost<MarketMaker> host(MarketMaker(8, config));
+    MarketMaker& mm = host.strategy<0>();
+    OrderBuffer& out = host.outbound();
+
+    // No two-sided book, no quotes
+    host.onBookUpdate(quote(1, 0.0, 10.10));
+    ASSERT_TRUE(out.empty());
+
+    host.onBookUpdate(quote(1, 10.00, 10.10));
+    ASSERT_EQ(out.size(), 2u);
+    ASSERT_EQ(out[0].side, OrderSide::BUY);
+    ASSERT_NEAR(out[0].price, 10.00, 1e-9);
+    ASSERT_NEAR(out[1].price, 10.10, 1e-9);
+    const uint64_t bidId = out[0].orderId;
+    ASSERT_EQ(mm.quoteId(1, OrderSide::BUY), bidId);
+    out.clear();
+
+    // Small moves leave the quotes alone
+    host.onBookUpdate(quote(1, 10.00, 10.11));
+    ASSERT_TRUE(out.empty());
+
+    // A fill on the bid: the filled quote is replaced, and both sides lean
+    // lower by 100 shares * 0.0002
+    Fill f;
+    f.symbolId = 1;
+    f.orderId = bidId;
+    f.side = OrderSide::BUY;
+    f.qty = 100;
+    f.price = 10.00;
+    f.passive = true;
+    host.onFill(f);
+    ASSERT_EQ(mm.position(1), 100);
+    ASSERT_EQ(mm.quoteId(1, OrderSide::BUY), 0u);
+    host.onBookUpdate(quote(1, 10.00, 10.10));
+    ASSERT_EQ(out.size(), 3u);
+    ASSERT_EQ(out[0].action, RequestAction::New);       // new bid
+    ASSERT_NEAR(out[0].price, 9.98, 1e-9);
+    ASSERT_EQ(out[1].action, RequestAction::Cancel);    // ask target moved two ticks
+    ASSERT_EQ(out[2].side, OrderSide::SELL);
+    ASSERT_NEAR(out[2].price, 10.08, 1e-9);
+    out.clear();
+
+    // Another 100 would pass maxPosition, so the bid is pulled
+    f.orderId = mm.quoteId(1, OrderSide::BUY);
+    f.qty = 60;
+    host.onFill(f);
+    ASSERT_EQ(mm.position(1), 160);
+    ASSERT_NE(mm.quoteId(1, OrderSide::BUY), 0u);       // 40 still working
+    host.onBookUpdate(quote(1, 10.00, 10.10));
+    ASSERT_EQ(out.size(), 1u);
+    ASSERT_EQ(out[0].action, RequestAction::Cancel);
+    ASSERT_EQ(out[0].orderId, f.orderId);
+    ASSERT_EQ(mm.quoteId(1, OrderSide::BUY), 0u);
+}
+
+// One share below the limit a full bid fill would pass it, so only the ask
+// is quoted; the mirror holds one share above the short limit
+TEST(Strategy, MarketMakerNeverQuotesPastMaxPosition) {
+    MarketMakerConfig config;
+    config.quoteQty = 100;
+    config.maxPosition = 1000;
+    StrategyHost<MarketMaker> host(MarketMaker(8, config));
+    MarketMaker& mm = host.strategy<0>();
+    OrderBuffer& out = host.outbound();
+    Fill f;
+    f.symbolId = 3;
+    f.side = OrderSide::BUY;
+    f.qty = 999;
+    f.price = 10.00;
+    host.onFill(f);
+    ASSERT_EQ(mm.position(3), 999);
+    host.onBookUpdate(quote(3, 10.00, 10.10));
+    ASSERT_EQ(out.size(), 1u);
+    ASSERT_EQ(out[0].side, OrderSide::SELL);
+    ASSERT_EQ(mm.quoteId(3, OrderSide::BUY), 0u);
+    out.clear();
+
+    f.symbolId = 4;
+    f.side = OrderSide::SELL;
+    host.onFill(f);
+    ASSERT_EQ(mm.position(4), -999);
+    host.onBookUpdate(quote(4, 10.00, 10.10));
+    ASSERT_EQ(out.size(), 1u);
+    ASSERT_EQ(out[0].side, OrderSide::BUY);
+    ASSERT_EQ(mm.quoteId(4, OrderSide::SELL), 0u);
+    out.clear();
+
+    // At exactly maxPosition - quoteQty a full fill lands on the limit
+    f.symbolId = 5;
+    f.side = OrderSide::BUY;
+    f.qty = 900;
+    host.onFill(f);
+    host.onBookUpdate(quote(5, 10.00, 10.10));
+    ASSERT_EQ(out.size(), 2u);
+}
+
+TEST(Strategy, MarketMakerRequotesARejectedOrder) {
+    StrategyHost<MarketMaker> host{ MarketMaker(8) };
+    MarketMaker& mm = host.strategy<0>();
+    OrderBuffer& out = host.outbound();
+    host.onBookUpdate(quote(2, 10.00, 10.10));
+    ASSERT_EQ(out.size(), 2u);
+    const OrderRequest refused = out[0];
+    out.clear();
+
+    // The bid never reached the book: no cancel for it, just a new one
+    host.onReject(refused);
+    ASSERT_EQ(mm.quoteId(2, OrderSide::BUY), 0u);
+    ASSERT_NE(mm.quoteId(2, OrderSide::SELL), 0u);
+    host.onBookUpdate(quote(2, 10.00, 10.10));
+    ASSERT_EQ(out.size(), 1u);
+    ASSERT_EQ(out[0].action, RequestAction::New);
+    ASSERT_EQ(out[0].side, OrderSide::BUY);
+    ASSERT_EQ(mm.quoteId(2, OrderSide::BUY), out[0].orderId);
+}
+
+TEST(Strategy, MarketMakerQuotesTradeInTheBook) {
+    OrderBookManager books(8);
+    StrategyHost<MarketMaker> host{ MarketMaker(8) };
+    uint32_t filled = 0;
+    auto onTrade = [&](const Trade& t) {
+        if (isStrategyOrder(t.makerId)) {
+            Fill f;
+            f.symbolId = t.symbolId;
+            f.orderId = t.makerId;
+            f.side = t.aggressorSide == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY;
+            f.price = t.price;
+            f.qty = t.qty;
+            f.passive = true;
+            filled += t.qty;
+            host.onFill(f);
+        }
+        host.onTrade(t);
+    };
+    auto send = [&] {
+        OrderBuffer& out = host.outbound();
+        for (size_t i = 0; i < out.size(); ++i) {
+            const OrderRequest& r = out[i];
+            if (r.action == RequestAction::Cancel) {
+                books.cancel(r.symbolId, r.orderId);
+                continue;
+            }
+            Order o("AAPL", r.price, static_cast<int>(r.qty), r.type, r.side, r.orderId);
+            o.symbolId = r.symbolId;
+            books.match(o, onTrade);
+        }
+        out.clear();
+    };
+
+    const uint32_t id = books.symbols().intern("AAPL");
+    Order bid("AAPL", 99.00, 500, OrderType::Limit, OrderSide::BUY, 1);
+    Order ask("AAPL", 101.00, 500, OrderType::Limit, OrderSide::SELL, 2);
+    bid.symbolId = ask.symbolId = id;
+    books.match(bid, onTrade);
+    books.match(ask, onTrade);
+    host.onBookUpdate(topOfBook(*books.find(id), TscClock::now()));
+    send();
+    // The quotes now make the inside market
+    ASSERT_NEAR(books.find(id)->bestBid(), 99.98, 1e-9);
+    ASSERT_NEAR(books.find(id)->bestAsk(), 100.02, 1e-9);
+
+    // A seller hits our bid
+    Order hit("AAPL", 99.98, 60, OrderType::Limit, OrderSide::SELL, 3);
+    hit.symbolId = id;
+    books.match(hit, onTrade);
+    ASSERT_EQ(filled, 60u);
+    ASSERT_EQ(host.strategy<0>().position(id), 60);
+}
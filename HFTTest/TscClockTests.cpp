@@ -0,0 +1,70 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "TscClock.hpp"
+#include <thread>
+#include <chrono>
+
+TEST(TscClock, ConversionMatchesRatio) {
+    if (!TscClock::usingTsc()) {
+        // Fallback ticks are already nanoseconds
+        ASSERT_EQ(TscClock::toNanos(123456789), 123456789u);
+        return;
+    }
+    ASSERT_GT(TscClock::ghz(), 0.1);
+    ASSERT_LT(TscClock::ghz(), 10.0);
+
+    // The split multiply must agree with floating point across the whole range
+    const double nsPerCycle = 1.0 / TscClock::ghz();
+    for (uint64_t cycles : { 1ull, 1000ull, 3000000000ull, 1ull << 40, 1ull << 56 }) {
+        double expected = cycles * nsPerCycle;
+        ASSERT_NEAR(static_cast<double>(TscClock::toNanos(cycles)), expected, expected * 1e-6 + 2.0);
+    }
+}
+
+TEST(TscClock, TracksMonotonicClock) {
+    uint64_t ns0 = TscClock::monotonicNanos();
+    uint64_t t0 = TscClock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    uint64_t t1 = TscClock::now();
+    uint64_t ns1 = TscClock::monotonicNanos();
+
+    double measured = static_cast<double>(TscClock::toNanos(t1 - t0));
+    double reference = static_cast<double>(ns1 - ns0);
+    ASSERT_NEAR(measured, reference, reference * 0.02);
+}
+
+TEST(TscClock, SerialisedReadsAreOrdered) {
+    uint64_t a = TscClock::start();
+    uint64_t b = TscClock::stop();
+    ASSERT_LE(a, b);
+}
+
+TEST(TscClock, MapsRealtimeOntoTicks) {
+    // Against a fresh anchor: the wall clock may have stepped since startup
+    TscClock::reanchor();
+    uint64_t mapped = TscClock::fromRealtimeNanos(TscClock::realtimeNanos());
+    uint64_t now = TscClock::now();
+    uint64_t diff = mapped > now ? mapped - now : now - mapped;
+    ASSERT_LT(TscClock::toNanos(diff), 1000000u);
+
+    // One millisecond of wall time maps to one millisecond of ticks
+    uint64_t base = TscClock::realtimeNanos();
+    uint64_t span = TscClock::fromRealtimeNanos(base + 1000000) - TscClock::fromRealtimeNanos(base);
+    ASSERT_NEAR(static_cast<double>(TscClock::toNanos(span)), 1e6, 10.0);
+}
+
+TEST(TscClock, ReanchorFollowsAWallClockStep) {
+    // An anchor taken before the wall clock jumped 2 s forward
+    const uint64_t ticks = TscClock::now();
+    TscClock::setRealtimeAnchor(TscClock::realtimeNanos() - 2000000000ull, ticks);
+    uint64_t mapped = TscClock::fromRealtimeNanos(TscClock::realtimeNanos());
+    ASSERT_GT(mapped, TscClock::now());
+    ASSERT_NEAR(static_cast<double>(TscClock::toNanos(mapped - TscClock::now())), 2e9, 1e6);
+
+    // Re-anchoring brings mapped stamps back onto the local clock
+    TscClock::reanchor();
+    mapped = TscClock::fromRealtimeNanos(TscClock::realtimeNanos());
+    const uint64_t now = TscClock::now();
+    const uint64_t diff = mapped > now ? mapped - now : now - mapped;
+    ASSERT_LT(TscClock::toNanos(diff), 1000000u);
+}
@@ -0,0 +1,141 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "WireProtocol.hpp"
+#include <cstring>
+#include <vector>
+
+static AddOrderMessage makeAdd(uint64_t id, const char* sym, int64_t price, uint32_t qty, char side) {
+    AddOrderMessage m{};
+    m.length = sizeof(AddOrderMessage);
+    m.type = static_cast<uint8_t>(WireMessageType::AddOrder);
+    m.side = static_cast<uint8_t>(side);
+    m.qty = qty;
+    m.orderId = id;
+    m.price = price;
+    strncpy(m.symbol, sym, sizeof(m.symbol));
+    return m;
+}
+
+TEST(WireProtocol, RoundTrip) {
+    char buf[kMaxDatagramSize];
+    PacketBuilder packet(buf, sizeof(buf));
+    packet.begin(100, 123456789);
+    ASSERT_TRUE(packet.add(makeAdd(1, "AAPL", 1500100, 10, 'B')));
+    ASSERT_TRUE(packet.add(makeAdd(2, "GOOGL", 28015700, 4200, 'S')));
+    ASSERT_EQ(packet.count(), 2);
+    ASSERT_EQ(packet.size(), sizeof(PacketHeader) + 2 * sizeof(AddOrderMessage));
+
+    std::vector<uint64_t> ids, seqs;
+    const PacketHeader* header = nullptr;
+    DecodeResult r = decodePacket(packet.data(), packet.size(), header,
+        [&](const AddOrderMessage& m, uint64_t seq) {
+            ids.push_back(m.orderId);
+            seqs.push_back(seq);
+        });
+    ASSERT_EQ(r, DecodeResult::Ok);
+    ASSERT_EQ(header->sendTimestamp, 123456789u);
+    ASSERT_EQ(ids, (std::vector<uint64_t>{ 1, 2 }));
+    ASSERT_EQ(seqs, (std::vector<uint64_t>{ 100, 101 }));
+}
+
+TEST(WireProtocol, ToOrderRejectsInvalidFields) {
+    Order o;
+    ASSERT_TRUE(toOrder(makeAdd(7, "AAPL", 1500000, 10, 'S'), o));
+    ASSERT_EQ(o.id, 7u);
+    ASSERT_EQ(o.qty, 10);
+    ASSERT_EQ(o.side, OrderSide::SELL);
+
+    o.id = 99;
+    ASSERT_FALSE(toOrder(makeAdd(1, "AAPL", 1500000, 0, 'B'), o));
+    ASSERT_FALSE(toOrder(makeAdd(1, "AAPL", 1500000, 0x80000000u, 'B'), o));
+    ASSERT_FALSE(toOrder(makeAdd(1, "AAPL", 0, 10, 'B'), o));
+    ASSERT_FALSE(toOrder(makeAdd(1, "AAPL", -1500000, 10, 'B'), o));
+    ASSERT_FALSE(toOrder(makeAdd(1, "AAPL", 1500000, 10, 'X'), o));
+    ASSERT_FALSE(toOrder(makeAdd(kStrategyOrderBit | 1, "AAPL", 1500000, 10, 'B'), o));
+    ASSERT_EQ(o.id, 99u);
+}
+
+TEST(WireProtocol, PacketFillsToMtu) {
+    char buf[kMaxDatagramSize];
+    PacketBuilder packet(buf, sizeof(buf));
+    packet.begin(1, 0);
+    size_t added = 0;
+    while (packet.add(makeAdd(added + 1, "MSFT", 3000000, 1, 'B'))) ++added;
+    ASSERT_EQ(added, kMaxMessagesPerPacket);
+    ASSERT_LE(packet.size(), kMaxDatagramSize);
+}
+
+TEST(WireProtocol, RejectsMalformed) {
+    char buf[kMaxDatagramSize];
+    PacketBuilder packet(buf, sizeof(buf));
+    packet.begin(1, 0);
+    packet.add(makeAdd(1, "AAPL", 1500000, 10, 'B'));
+    packet.add(makeAdd(2, "AAPL", 1500000, 10, 'S'));
+
+    int delivered = 0;
+    auto count = [&](const AddOrderMessage&, uint64_t) { ++delivered; };
+    const PacketHeader* header = nullptr;
+
+    ASSERT_EQ(decodePacket(buf, sizeof(PacketHeader) - 1, header, count), DecodeResult::TooShort);
+
+    // Cut the second message short: the first one is still delivered
+    ASSERT_EQ(decodePacket(buf, packet.size() - 1, header, count), DecodeResult::Truncated);
+    ASSERT_EQ(delivered, 1);
+
+    buf[0] ^= 0xFF;
+    ASSERT_EQ(decodePacket(buf, packet.size(), header, count), DecodeResult::BadMagic);
+}
+
+TEST(WireProtocol, LineArbiterTakesFirstCopy) {
+    LineArbiter arbiter;
+    // Line A loses 4 and 7; line B runs a few messages behind and fills them
+    for (uint64_t seq : { 1, 2, 3, 5, 6 }) ASSERT_TRUE(arbiter.accept(seq, 0));
+    for (uint64_t seq : { 1, 2, 3, 4 }) ASSERT_EQ(arbiter.accept(seq, 1), seq == 4);
+    ASSERT_TRUE(arbiter.accept(8, 0));
+    for (uint64_t seq : { 5, 6, 7, 8 }) ASSERT_EQ(arbiter.accept(seq, 1), seq == 7);
+
+    ASSERT_EQ(arbiter.high(), 9u);
+    ASSERT_EQ(arbiter.wins(0), 6u);
+    ASSERT_EQ(arbiter.wins(1), 2u);
+    ASSERT_EQ(arbiter.recovered(), 2u);
+    ASSERT_EQ(arbiter.duplicates(), 6u);
+    ASSERT_EQ(arbiter.lostMessages(), 0u);
+}
+
+TEST(WireProtocol, LineArbiterTakesNumbersBelowTheFirstInsideTheWindow) {
+    LineArbiter arbiter;
+    // A later-reserved range overtakes the first one
+    for (uint64_t seq : { 9, 10, 11, 12 }) ASSERT_TRUE(arbiter.accept(seq, 0));
+    ASSERT_EQ(arbiter.missing(), 0u);
+    ASSERT_TRUE(arbiter.accept(6, 0));
+    ASSERT_EQ(arbiter.missing(), 2u);
+    for (uint64_t seq : { 5, 7, 8 }) ASSERT_TRUE(arbiter.accept(seq, 0));
+    ASSERT_FALSE(arbiter.accept(6, 0));
+
+    ASSERT_EQ(arbiter.missing(), 0u);
+    ASSERT_EQ(arbiter.duplicates(), 1u);
+    ASSERT_EQ(arbiter.late(), 0u);
+    ASSERT_EQ(arbiter.lostMessages(), 0u);
+}
+
+TEST(WireProtocol, LineArbiterCountsLossOnceWindowPasses) {
+    LineArbiter arbiter;
+    const uint64_t w = LineArbiter::kWindow;
+    for (uint64_t seq = 100; seq < 100 + w; ++seq) {
+        if (seq != 150) {
+            ASSERT_TRUE(arbiter.accept(seq, 0));
+        }
+    }
+    // 150 is still inside the window: not lost yet, and still fillable
+    ASSERT_EQ(arbiter.lostMessages(), 0u);
+    ASSERT_TRUE(arbiter.accept(100 + w, 0));
+    ASSERT_TRUE(arbiter.accept(100 + w + 60, 0));   // window now starts past 150
+    ASSERT_EQ(arbiter.lostMessages(), 1u);
+    ASSERT_FALSE(arbiter.accept(150, 1));
+    ASSERT_EQ(arbiter.late(), 1u);
+
+    // A jump of more than a whole window: the 59 holes left in the old
+    // window and the skipped numbers already below the new one are lost
+    ASSERT_TRUE(arbiter.accept(100 + 3 * w, 0));
+    ASSERT_EQ(arbiter.lostMessages(), 1u + 59u + (w - 60));
+}
@@ -2,6 +2,13 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include "../HFTCore/TscClock.hpp"
 
 MarketDataGenerator::MarketDataGenerator(const std::string& host, int port)
     : sock_(INVALID_SOCKET), targetHost_(host), targetPort_(port),
@@ -55,11 +62,35 @@ void MarketDataGenerator::addSymbol(const std::string& symbol, double basePrice)
     symbolDist_ = std::uniform_int_distribution<int>(0, symbols_.size() - 1);
 }
 
+void MarketDataGenerator::setWireFormat(WireFormat format, int batchSize) {
+    wireFormat_ = format;
+    batchSize_ = 1;
+    if (format == WireFormat::Binary) {
+        batchSize_ = (std::max)(1, (std::min)(batchSize, static_cast<int>(kMaxMessagesPerPacket)));
+    }
+}
+
 void MarketDataGenerator::setTargetAddress(const std::string& host, int port) {
     targetHost_ = host;
     targetPort_ = port;
 }
 
+void MarketDataGenerator::setSecondLine(const std::string& host, int port) {
+    lineB_ = !host.empty();
+    lineBHost_ = host;
+    lineBPort_ = port;
+}
+
+void MarketDataGenerator::setMulticastOptions(const std::string& iface, int ttl) {
+    multicastInterface_ = iface;
+    multicastTtl_ = ttl;
+}
+
+void MarketDataGenerator::setLineLoss(int line, double fraction) {
+    fraction = (std::max)(0.0, (std::min)(1.0, fraction));
+    lineLossPpm_[line & 1] = static_cast<uint32_t>(fraction * 1e6);
+}
+
 bool MarketDataGenerator::start(int rateHz, int durationSec) {
     if (running_.load()) {
         std::cout << "[MarketDataGenerator] Already running" << std::endl;
@@ -74,7 +105,9 @@ bool MarketDataGenerator::start(int rateHz, int durationSec) {
     running_.store(true);
     generatorThread_ = std::thread(&MarketDataGenerator::generatorLoop, this, rateHz, durationSec);
 
-    std::cout << "[MarketDataGenerator] Started - Target: " << targetHost_ << ":" << targetPort_
+    std::cout << "[MarketDataGenerator] Started - Target: "
+        << (shmFeed_.isOpen() ? "shared memory " + shmFeedName_ : targetHost_ + ":" + std::to_string(targetPort_))
+        << (lineB_ && !shmFeed_.isOpen() ? ", Line B: " + lineBHost_ + ":" + std::to_string(lineBPort_) : std::string())
         << ", Rate: " << rateHz << " Hz, Duration: "
         << (durationSec ? std::to_string(durationSec) + "s" : "infinite") << std::endl;
     return true;
@@ -92,6 +125,18 @@ void MarketDataGenerator::stop() {
 }
 
 bool MarketDataGenerator::initializeSocket() {
+    if (!shmFeedName_.empty()) {
+        if (!shmFeed_.open(shmFeedName_)) {
+            std::cerr << "[MarketDataGenerator] No shared-memory feed " << shmFeedName_
+                << " (start HFTApp with --shm-feed first)" << std::endl;
+            return false;
+        }
+        if (lineB_) {
+            std::cerr << "[MarketDataGenerator] Line B is ignored on the shared-memory feed" << std::endl;
+        }
+        return true;
+    }
+
     sock_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
     if (sock_ == INVALID_SOCKET) {
 #ifdef _WIN32
@@ -102,34 +147,48 @@ bool MarketDataGenerator::initializeSocket() {
         return false;
     }
 
-    // Configure target address
-    targetAddr_.sin_family = AF_INET;
-    targetAddr_.sin_port = htons(targetPort_);
-
-#ifdef _WIN32
-    if (inet_pton(AF_INET, targetHost_.c_str(), &targetAddr_.sin_addr) <= 0) {
-        std::cerr << "[MarketDataGenerator] Invalid address: " << targetHost_ << std::endl;
+    if (!resolve(targetHost_, targetPort_, targetAddr_) ||
+        (lineB_ && !resolve(lineBHost_, lineBPort_, lineBAddr_))) {
         closesocket(sock_);
         sock_ = INVALID_SOCKET;
         return false;
     }
-#else
-    if (inet_pton(AF_INET, targetHost_.c_str(), &targetAddr_.sin_addr) <= 0) {
-        std::cerr << "[MarketDataGenerator] Invalid address: " << targetHost_ << std::endl;
-        closesocket(sock_);
-        sock_ = INVALID_SOCKET;
+    applyMulticastOptions(sock_);
+    return true;
+}
+
+bool MarketDataGenerator::resolve(const std::string& host, int port, sockaddr_in& out) {
+    out = sockaddr_in{};
+    out.sin_family = AF_INET;
+    out.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, host.c_str(), &out.sin_addr) <= 0) {
+        std::cerr << "[MarketDataGenerator] Invalid address: " << host << std::endl;
         return false;
     }
-#endif
-
     return true;
 }
 
+void MarketDataGenerator::applyMulticastOptions(SOCKET sock) {
+    // Loopback on, so a receiver on this host gets its copy
+    int ttl = multicastTtl_;
+    int loop = 1;
+    setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL, reinterpret_cast<const char*>(&ttl), sizeof(ttl));
+    setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, reinterpret_cast<const char*>(&loop), sizeof(loop));
+    if (!multicastInterface_.empty()) {
+        in_addr iface{};
+        if (inet_pton(AF_INET, multicastInterface_.c_str(), &iface) <= 0 ||
+            setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF, reinterpret_cast<const char*>(&iface), sizeof(iface)) != 0) {
+            std::cerr << "[MarketDataGenerator] Multicast interface not applied: " << multicastInterface_ << std::endl;
+        }
+    }
+}
+
 void MarketDataGenerator::cleanupSocket() {
     if (sock_ != INVALID_SOCKET) {
         closesocket(sock_);
         sock_ = INVALID_SOCKET;
     }
+    shmFeed_.close();
 }
 
 void MarketDataGenerator::generatorLoop(int rateHz, int durationSec) {
@@ -137,10 +196,12 @@ void MarketDataGenerator::generatorLoop(int rateHz, int durationSec) {
     auto endTime = durationSec ? startTime + std::chrono::seconds(durationSec) :
         std::chrono::steady_clock::time_point::max();
 
-    const auto interval = std::chrono::microseconds(1000000 / rateHz);
+    // rateHz counts messages; a binary datagram carries batchSize_ of them
+    const auto interval = std::chrono::microseconds(1000000LL * batchSize_ / rateHz);
     auto nextSendTime = std::chrono::steady_clock::now();
 
     int messageCount = 0;
+    auto lastReport = startTime;
 
     while (running_.load()) {
         auto now = std::chrono::steady_clock::now();
@@ -150,16 +211,20 @@ void MarketDataGenerator::generatorLoop(int rateHz, int durationSec) {
         }
 
         if (now >= nextSendTime) {
-            sendSingleMessage();
-            messageCount++;
+            messageCount += sendSingleMessage();
 
-            if (messageCount % 100 == 0) {
-                std::cout << "[MarketDataGenerator] Sent " << messageCount << " messages" << std::endl;
+            if (now - lastReport >= std::chrono::seconds(1)) {
+                std::cout << "[MarketDataGenerator] Sent " << messageCount << " messages"
+                    << (shmFeed_.isOpen() && !shmFeed_.peerAlive() ? " (shared-memory reader not responding)" : "")
+                    << std::endl;
+                lastReport = now;
             }
 
             nextSendTime += interval;
         }
         else {
+            // Keep beating while idle, so the reader can tell quiet from gone
+            if (shmFeed_.isOpen()) shmFeed_.heartbeat();
             // Sleep for a small amount to avoid busy waiting
             std::this_thread::sleep_for(std::chrono::microseconds(100));
         }
@@ -168,30 +233,53 @@ void MarketDataGenerator::generatorLoop(int rateHz, int durationSec) {
     std::cout << "[MarketDataGenerator] Completed. Sent " << messageCount << " messages total." << std::endl;
 }
 
-std::string MarketDataGenerator::generateMarketData() {
-    if (symbols_.empty()) return "";
-
+MarketDataGenerator::Quote MarketDataGenerator::nextQuote() {
     // Select random symbol
     int symbolIdx = symbolDist_(rng_);
-    const std::string& symbol = symbols_[symbolIdx];
+    return quoteFor(symbols_[symbolIdx]);
+}
 
-    // Generate price
-    double price = generatePrice(symbol);
+MarketDataGenerator::Quote MarketDataGenerator::quoteFor(const std::string& symbol) {
+    Quote q;
+    q.symbol = &symbol;
+    q.price = generatePrice(symbol);
+    q.qty = qtyDist_(rng_);
+    q.buy = (sideDist_(rng_) == 0);
+    return q;
+}
 
-    // Generate quantity
-    int qty = qtyDist_(rng_);
+std::string MarketDataGenerator::generateMarketData() {
+    if (symbols_.empty()) return "";
 
-    // Generate side
-    std::string side = (sideDist_(rng_) == 0) ? "BUY" : "SELL";
+    return formatQuote(nextQuote());
+}
 
+std::string MarketDataGenerator::formatQuote(const Quote& q) const {
     // Format: SYMBOL,PRICE,QTY,SIDE
     std::ostringstream oss;
-    oss << symbol << "," << std::fixed << std::setprecision(2) << price
-        << "," << qty << "," << side;
+    oss << *q.symbol << "," << std::fixed << std::setprecision(2) << q.price
+        << "," << q.qty << "," << (q.buy ? "BUY" : "SELL");
 
     return oss.str();
 }
 
+AddOrderMessage MarketDataGenerator::generateAddOrder() {
+    return toAddOrder(nextQuote(), nextOrderId_++);
+}
+
+AddOrderMessage MarketDataGenerator::toAddOrder(const Quote& q, uint64_t orderId) const {
+    AddOrderMessage m{};
+    m.length = sizeof(AddOrderMessage);
+    m.type = static_cast<uint8_t>(WireMessageType::AddOrder);
+    m.side = q.buy ? 'B' : 'S';
+    m.qty = static_cast<uint32_t>(q.qty);
+    m.orderId = orderId;
+    // Round to cents like the ASCII feed, then scale to wire fixed point
+    m.price = std::llround(q.price * 100.0) * (kPriceScale / 100);
+    memcpy(m.symbol, q.symbol->data(), (std::min)(q.symbol->size(), sizeof(m.symbol)));
+    return m;
+}
+
 double MarketDataGenerator::generatePrice(const std::string& symbol) {
     double current = currentPrices_[symbol];
     double base = basePrices_[symbol];
@@ -209,14 +297,44 @@ double MarketDataGenerator::generatePrice(const std::string& symbol) {
     return newPrice;
 }
 
-void MarketDataGenerator::sendSingleMessage() {
-    if (sock_ == INVALID_SOCKET) return;
+int MarketDataGenerator::sendSingleMessage() {
+    if (!connected() || symbols_.empty()) return 0;
+    if (wireFormat_ == WireFormat::Binary) return sendBinaryPacket();
 
     std::string message = generateMarketData();
-    if (message.empty()) return;
+    return sendDatagram(message.c_str(), message.length()) ? 1 : 0;
+}
+
+int MarketDataGenerator::sendBinaryPacket() {
+    PacketBuilder packet(packetBuffer_, sizeof(packetBuffer_));
+    // Wall clock, so the receiver can compare it with kernel receive stamps
+    uint64_t sendTs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    packet.begin(nextSequence_, sendTs);
+    for (int i = 0; i < batchSize_; ++i) {
+        packet.add(generateAddOrder());
+    }
 
-    int result = sendto(sock_, message.c_str(), static_cast<int>(message.length()), 0,
-        (sockaddr*)&targetAddr_, sizeof(targetAddr_));
+    // Sequence numbers advance even when the send fails, so the receiver sees the gap
+    nextSequence_ += packet.count();
+    return sendDatagram(packet.data(), packet.size()) ? packet.count() : 0;
+}
+
+bool MarketDataGenerator::sendDatagram(const char* data, size_t length) {
+    bool sent = sendToLine(0, data, length);
+    // Counts as sent if either line took it
+    if (lineB_ && !shmFeed_.isOpen()) sent = sendToLine(1, data, length) || sent;
+    return sent;
+}
+
+bool MarketDataGenerator::sendToLine(int line, const char* data, size_t length) {
+    // Simulated wire loss: the datagram just never leaves
+    if (lineLossPpm_[line] && rng_() % 1000000 < lineLossPpm_[line]) return true;
+    // A full ring fails like a send the kernel refused
+    if (shmFeed_.isOpen()) return shmFeed_.write(data, length);
+    const sockaddr_in& addr = line ? lineBAddr_ : targetAddr_;
+    int result = sendto(sock_, data, static_cast<int>(length), 0,
+        (const sockaddr*)&addr, sizeof(addr));
 
     if (result == SOCKET_ERROR) {
 #ifdef _WIN32
@@ -229,11 +347,13 @@ void MarketDataGenerator::sendSingleMessage() {
             std::cerr << "[MarketDataGenerator] Send failed: " << errno << std::endl;
         }
 #endif
+        return false;
     }
+    return true;
 }
 
 void MarketDataGenerator::sendBurst(int count) {
-    if (sock_ == INVALID_SOCKET) {
+    if (!connected()) {
         if (!initializeSocket()) {
             std::cerr << "[MarketDataGenerator] Cannot send burst - socket initialization failed" << std::endl;
             return;
@@ -242,11 +362,13 @@ void MarketDataGenerator::sendBurst(int count) {
 
     std::cout << "[MarketDataGenerator] Sending burst of " << count << " messages..." << std::endl;
 
-    for (int i = 0; i < count; ++i) {
+    // In binary mode each datagram carries batchSize_ messages
+    for (int i = 0; i < count; i += batchSize_) {
         sendSingleMessage();
 
-        if ((i + 1) % 1000 == 0) {
-            std::cout << "[MarketDataGenerator] Burst progress: " << (i + 1) << "/" << count << std::endl;
+        int sent = (std::min)(i + batchSize_, count);
+        if (sent / 1000 != i / 1000) {
+            std::cout << "[MarketDataGenerator] Burst progress: " << sent << "/" << count << std::endl;
         }
 
         // small delay to avoid overwhelming the receiver
@@ -254,4 +376,303 @@ void MarketDataGenerator::sendBurst(int count) {
     }
 
     std::cout << "[MarketDataGenerator] Burst completed: " << count << " messages sent." << std::endl;
-}
\ No newline at end of file
+}
+
+// Pre-serialized datagrams and counters for one runLoad() sender thread
+struct MarketDataGenerator::LoadSender {
+    static constexpr size_t kPoolSize = 4096;       // datagrams, reused round-robin
+
+    SOCKET sock = INVALID_SOCKET;
+    SOCKET sockB = INVALID_SOCKET;                  // line B, if configured
+    std::vector<char> pool;                         // kPoolSize slots of kMaxDatagramSize
+    std::vector<uint16_t> lengths;
+    int messagesPerDatagram = 1;
+    int sendBatch = 1;
+    size_t next = 0;
+
+    uint64_t messages = 0;
+    uint64_t datagrams = 0;
+    uint64_t errors = 0;
+    uint64_t lineDrops[2] = { 0, 0 };
+    std::minstd_rand lossRng;
+    std::vector<uint64_t> phaseMessages;
+    LatencyHistogram lateness;
+    std::thread thread;
+};
+
+static constexpr int kMaxLoadBatch = 64;
+
+std::vector<LoadPhase> MarketDataGenerator::openSpikeProfile(double rate, int durationSec,
+    double spikeMultiplier, int spikeMs) {
+    std::vector<LoadPhase> profile;
+    int totalMs = durationSec * 1000;
+    spikeMs = (std::min)(spikeMs, totalMs);
+    if (spikeMs > 0) profile.push_back({ rate * spikeMultiplier, spikeMs });
+    if (totalMs > spikeMs) profile.push_back({ rate, totalMs - spikeMs });
+    return profile;
+}
+
+void MarketDataGenerator::prepareSender(LoadSender& sender, const std::vector<int>& symbolIdx) {
+    std::uniform_int_distribution<size_t> pick(0, symbolIdx.size() - 1);
+    sender.pool.assign(LoadSender::kPoolSize * kMaxDatagramSize, 0);
+    sender.lengths.assign(LoadSender::kPoolSize, 0);
+    sender.messagesPerDatagram = wireFormat_ == WireFormat::Binary ? batchSize_ : 1;
+
+    // The price walk runs here, once, on the calling thread; the senders
+    // only replay it. Sequence numbers, send times and order ids are
+    // filled in at send time.
+    for (size_t d = 0; d < LoadSender::kPoolSize; ++d) {
+        char* buf = &sender.pool[d * kMaxDatagramSize];
+        if (wireFormat_ == WireFormat::Binary) {
+            PacketBuilder packet(buf, kMaxDatagramSize);
+            packet.begin(0, 0);
+            for (int i = 0; i < batchSize_; ++i) {
+                packet.add(toAddOrder(quoteFor(symbols_[symbolIdx[pick(rng_)]]), 0));
+            }
+            sender.lengths[d] = static_cast<uint16_t>(packet.size());
+        }
+        else {
+            std::string message = formatQuote(quoteFor(symbols_[symbolIdx[pick(rng_)]]));
+            size_t len = (std::min)(message.size(), kMaxDatagramSize);
+            memcpy(buf, message.data(), len);
+            sender.lengths[d] = static_cast<uint16_t>(len);
+        }
+    }
+}
+
+LoadReport MarketDataGenerator::runLoad(const std::vector<LoadPhase>& profile, int threads, int sendBatch) {
+    LoadReport report;
+    if (profile.empty() || symbols_.empty() || running_.load()) return report;
+    if (!connected() && !initializeSocket()) {
+        std::cerr << "[MarketDataGenerator] Cannot run load - socket initialization failed" << std::endl;
+        return report;
+    }
+    const bool shm = shmFeed_.isOpen();
+    if (shm && threads > 1) {
+        std::cout << "[MarketDataGenerator] The shared-memory feed has one producer; using 1 sender" << std::endl;
+        threads = 1;
+    }
+    threads = (std::max)(1, (std::min)(threads, static_cast<int>(symbols_.size())));
+    sendBatch = (std::max)(1, (std::min)(sendBatch, kMaxLoadBatch));
+
+    std::vector<std::unique_ptr<LoadSender>> senders;
+    for (int t = 0; t < threads; ++t) {
+        auto sender = std::make_unique<LoadSender>();
+        std::vector<int> symbolIdx;
+        for (int i = t; i < static_cast<int>(symbols_.size()); i += threads) symbolIdx.push_back(i);
+        prepareSender(*sender, symbolIdx);
+        sender->phaseMessages.assign(profile.size(), 0);
+        sender->sendBatch = sendBatch;
+
+        sender->lossRng.seed(static_cast<unsigned>(t + 1));
+
+        // A connected socket per sender and line: no shared send path and
+        // no per-datagram address. The shared-memory sender needs neither.
+        if (!shm) {
+            sender->sock = openLoadSocket(targetAddr_);
+            if (lineB_) sender->sockB = openLoadSocket(lineBAddr_);
+        }
+        const bool ok = shm || (sender->sock != INVALID_SOCKET && (!lineB_ || sender->sockB != INVALID_SOCKET));
+        senders.push_back(std::move(sender));
+        if (!ok) {
+            std::cerr << "[MarketDataGenerator] Load sender socket setup failed" << std::endl;
+            for (auto& s : senders) {
+                if (s->sock != INVALID_SOCKET) closesocket(s->sock);
+                if (s->sockB != INVALID_SOCKET) closesocket(s->sockB);
+            }
+            return report;
+        }
+    }
+
+    double totalMs = 0.0, totalMessages = 0.0;
+    for (const LoadPhase& p : profile) {
+        totalMs += p.durationMs;
+        totalMessages += p.ratePerSec * p.durationMs * 1e-3;
+    }
+    std::cout << "[MarketDataGenerator] Load: " << threads << " sender(s), " << profile.size()
+        << " phase(s), " << static_cast<uint64_t>(totalMessages) << " messages over " << totalMs * 1e-3 << "s" << std::endl;
+
+    loadSequence_.store(nextSequence_);
+    running_.store(true);
+    const uint64_t startTicks = TscClock::now();
+    for (auto& s : senders) {
+        LoadSender* sender = s.get();
+        sender->thread = std::thread(&MarketDataGenerator::senderLoop, this,
+            std::ref(*sender), std::cref(profile), startTicks, threads);
+    }
+    for (auto& s : senders) s->thread.join();
+    const uint64_t endTicks = TscClock::now();
+    running_.store(false);
+    nextSequence_ = loadSequence_.load();
+
+    report.phaseRates.assign(profile.size(), 0.0);
+    for (auto& s : senders) {
+        report.messages += s->messages;
+        report.datagrams += s->datagrams;
+        report.sendErrors += s->errors;
+        report.lineDrops[0] += s->lineDrops[0];
+        report.lineDrops[1] += s->lineDrops[1];
+        report.lateness.merge(s->lateness);
+        for (size_t i = 0; i < profile.size(); ++i) {
+            if (profile[i].durationMs > 0) {
+                report.phaseRates[i] += s->phaseMessages[i] / (profile[i].durationMs * 1e-3);
+            }
+        }
+        if (s->sock != INVALID_SOCKET) closesocket(s->sock);
+        if (s->sockB != INVALID_SOCKET) closesocket(s->sockB);
+    }
+    report.seconds = TscClock::toNanos(endTicks - startTicks) * 1e-9;
+    report.targetRate = totalMs > 0 ? totalMessages / (totalMs * 1e-3) : 0.0;
+    report.achievedRate = report.seconds > 0 ? report.messages / report.seconds : 0.0;
+    return report;
+}
+
+SOCKET MarketDataGenerator::openLoadSocket(const sockaddr_in& target) {
+    SOCKET sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == INVALID_SOCKET) return INVALID_SOCKET;
+    int sndbuf = 4 << 20;
+    setsockopt(sock, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&sndbuf), sizeof(sndbuf));
+    applyMulticastOptions(sock);
+    if (connect(sock, reinterpret_cast<const sockaddr*>(&target), sizeof(target)) == SOCKET_ERROR) {
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    return sock;
+}
+
+void MarketDataGenerator::senderLoop(LoadSender& sender, const std::vector<LoadPhase>& profile,
+    uint64_t startTicks, int threads) {
+    // Phase boundaries, and this sender's cumulative message target at the
+    // start of each phase
+    const size_t phases = profile.size();
+    const double share = 1.0 / threads;
+    std::vector<uint64_t> startNs(phases), endNs(phases);
+    std::vector<double> startTarget(phases);
+    uint64_t at = 0;
+    double target = 0.0;
+    for (size_t i = 0; i < phases; ++i) {
+        startNs[i] = at;
+        startTarget[i] = target;
+        at += uint64_t((std::max)(profile[i].durationMs, 0)) * 1000000ull;
+        endNs[i] = at;
+        target += profile[i].ratePerSec * share * profile[i].durationMs * 1e-3;
+    }
+
+    const bool binary = wireFormat_ == WireFormat::Binary;
+    const bool shm = shmFeed_.isOpen();
+    const int perDatagram = sender.messagesPerDatagram;
+    const size_t batch = static_cast<size_t>(sender.sendBatch);
+    uint64_t scheduled = 0;     // messages whose send time has been reached and handled
+    size_t phase = 0;
+
+#ifdef __linux__
+    mmsghdr msgs[kMaxLoadBatch];
+    iovec iov[kMaxLoadBatch];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < kMaxLoadBatch; ++i) {
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
+
+    while (running_.load(std::memory_order_relaxed)) {
+        const uint64_t t = TscClock::toNanos(TscClock::now() - startTicks);
+        while (phase < phases && t >= endNs[phase]) ++phase;
+        if (phase == phases) break;
+
+        // Open loop: how many messages should be out by now
+        const double rate = profile[phase].ratePerSec * share;
+        const double due = startTarget[phase] + rate * double(t - startNs[phase]) * 1e-9;
+        if (double(scheduled + perDatagram) > due) {
+            if (shm) shmFeed_.heartbeat();
+            cpuRelax();
+            continue;
+        }
+        size_t n = static_cast<size_t>((due - double(scheduled)) / perDatagram);
+        if (n > batch) n = batch;
+
+        // When the first of these datagrams was due; if it belonged to the
+        // previous phase, count from this phase's start
+        double firstDue = startNs[phase] + (double(scheduled + perDatagram) - startTarget[phase]) / rate * 1e9;
+        uint64_t late = firstDue < double(t) ? t - static_cast<uint64_t>((std::max)(firstDue, double(startNs[phase]))) : 0;
+        sender.lateness.record(late);
+
+        if (binary) {
+            uint64_t seq = loadSequence_.fetch_add(n * perDatagram, std::memory_order_relaxed);
+            uint64_t sendTs = TscClock::realtimeNanos();
+            for (size_t k = 0; k < n; ++k) {
+                char* buf = &sender.pool[((sender.next + k) % LoadSender::kPoolSize) * kMaxDatagramSize];
+                memcpy(buf + offsetof(PacketHeader, sequence), &seq, sizeof(seq));
+                memcpy(buf + offsetof(PacketHeader, sendTimestamp), &sendTs, sizeof(sendTs));
+                // Order ids follow the sequence so they stay unique across senders
+                for (int m = 0; m < perDatagram; ++m, ++seq) {
+                    memcpy(buf + sizeof(PacketHeader) + m * sizeof(AddOrderMessage) + offsetof(AddOrderMessage, orderId),
+                        &seq, sizeof(seq));
+                }
+            }
+        }
+
+        // Line A, then the same datagrams on line B. Failures on line A
+        // decide what counts as sent; withheld datagrams are simulated wire
+        // loss, not errors.
+        size_t sent = n;
+        const int lines = sender.sockB != INVALID_SOCKET ? 2 : 1;
+        for (int line = 0; line < lines; ++line) {
+            const SOCKET sock = line ? sender.sockB : sender.sock;
+            const uint32_t lossPpm = lineLossPpm_[line];
+            size_t count = 0, ok = 0;
+            if (shm) {
+                // Straight into the ring; a full ring fails the datagram
+                for (size_t k = 0; k < n; ++k) {
+                    if (lossPpm && sender.lossRng() % 1000000 < lossPpm) {
+                        ++sender.lineDrops[line];
+                        continue;
+                    }
+                    size_t slot = (sender.next + k) % LoadSender::kPoolSize;
+                    ++count;
+                    if (shmFeed_.write(&sender.pool[slot * kMaxDatagramSize], sender.lengths[slot])) ++ok;
+                }
+            }
+            else {
+#ifdef __linux__
+                for (size_t k = 0; k < n; ++k) {
+                    if (lossPpm && sender.lossRng() % 1000000 < lossPpm) {
+                        ++sender.lineDrops[line];
+                        continue;
+                    }
+                    size_t slot = (sender.next + k) % LoadSender::kPoolSize;
+                    iov[count].iov_base = &sender.pool[slot * kMaxDatagramSize];
+                    iov[count].iov_len = sender.lengths[slot];
+                    ++count;
+                }
+                while (ok < count) {
+                    int r = sendmmsg(sock, msgs + ok, static_cast<unsigned>(count - ok), 0);
+                    if (r <= 0) break;
+                    ok += static_cast<size_t>(r);
+                }
+#else
+                for (size_t k = 0; k < n; ++k) {
+                    if (lossPpm && sender.lossRng() % 1000000 < lossPpm) {
+                        ++sender.lineDrops[line];
+                        continue;
+                    }
+                    size_t slot = (sender.next + k) % LoadSender::kPoolSize;
+                    ++count;
+                    if (send(sock, &sender.pool[slot * kMaxDatagramSize], sender.lengths[slot], 0) != SOCKET_ERROR) {
+                        ++ok;
+                    }
+                }
+#endif
+            }
+            sender.errors += count - ok;
+            if (line == 0) sent = n - (count - ok);
+        }
+        sender.next = (sender.next + n) % LoadSender::kPoolSize;
+        // Failed sends still consume their slot in the schedule (and their
+        // sequence numbers), so the receiver sees a gap rather than a stall
+        scheduled += n * perDatagram;
+        sender.datagrams += sent;
+        sender.messages += sent * perDatagram;
+        sender.phaseMessages[phase] += sent * perDatagram;
+    }
+}
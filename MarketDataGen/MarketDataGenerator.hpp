@@ -0,0 +1,180 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cerrno>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#define SOCKET int
+#define INVALID_SOCKET -1
+#define SOCKET_ERROR -1
+#define closesocket close
+#endif
+
+#include "../HFTCore/LatencyHistogram.hpp"
+#include "../HFTCore/WireProtocol.hpp"
+#include "../HFTCore/ShmFeed.hpp"
+
+// One step of a load profile: hold ratePerSec messages/s for durationMs
+struct LoadPhase {
+    double ratePerSec;
+    int durationMs;
+};
+
+// Outcome of MarketDataGenerator::runLoad()
+struct LoadReport {
+    uint64_t messages = 0;
+    uint64_t datagrams = 0;
+    uint64_t sendErrors = 0;
+    // Datagrams withheld by setLineLoss(), per line
+    uint64_t lineDrops[2] = { 0, 0 };
+    double seconds = 0.0;
+    double targetRate = 0.0;            // profile average, messages/s
+    double achievedRate = 0.0;
+    // Per phase, messages/s actually sent
+    std::vector<double> phaseRates;
+    // How late each send call started relative to its schedule, in ns
+    HistogramSnapshot lateness;
+};
+
+class MarketDataGenerator {
+private:
+    SOCKET sock_;
+    std::string targetHost_;
+    int targetPort_;
+    sockaddr_in targetAddr_;
+    // B side of a redundant feed: every datagram also goes here
+    bool lineB_ = false;
+    std::string lineBHost_;
+    int lineBPort_ = 0;
+    sockaddr_in lineBAddr_;
+    std::string multicastInterface_;
+    int multicastTtl_ = 1;
+    // Simulated loss per line, in parts per million
+    uint32_t lineLossPpm_[2] = { 0, 0 };
+    // Shared-memory ring in place of the socket when a name is set
+    std::string shmFeedName_;
+    ShmFeedWriter shmFeed_;
+
+    std::thread generatorThread_;
+    std::atomic<bool> running_{ false };
+
+    std::mt19937 rng_;
+    std::uniform_real_distribution<double> volatilityDist_;
+    std::uniform_int_distribution<int> qtyDist_;
+    std::uniform_int_distribution<int> sideDist_;
+    std::uniform_int_distribution<int> symbolDist_;
+
+    std::vector<std::string> symbols_;
+    std::unordered_map<std::string, double> basePrices_;
+    std::unordered_map<std::string, double> currentPrices_;
+
+    WireFormat wireFormat_ = WireFormat::Ascii;
+    int batchSize_ = 1;
+    uint64_t nextSequence_ = 1;
+    uint64_t nextOrderId_ = 1;
+    char packetBuffer_[kMaxDatagramSize];
+    // Shared by the load senders; each reserves a range per send call
+    std::atomic<uint64_t> loadSequence_{ 1 };
+
+    struct LoadSender;
+
+    struct Quote {
+        const std::string* symbol;
+        double price;
+        int qty;
+        bool buy;
+    };
+
+public:
+    MarketDataGenerator(const std::string& host = "127.0.0.1", int port = 8080);
+    ~MarketDataGenerator();
+
+    void addSymbol(const std::string& symbol, double basePrice);
+    void setTargetAddress(const std::string& host, int port);
+    // Redundant A/B feed: every datagram is sent to the target (line A) and
+    // again to host:port (line B), typically two multicast groups
+    void setSecondLine(const std::string& host, int port);
+    // Multicast sends: outgoing interface address ("" = routing table) and
+    // TTL. "127.0.0.1" keeps a local test on loopback.
+    void setMulticastOptions(const std::string& iface, int ttl = 1);
+    // Withhold this fraction of datagrams on one line (0 = A, 1 = B), chosen
+    // at random, to exercise the receiver's arbitration
+    void setLineLoss(int line, double fraction);
+    // Write datagrams into the shared-memory ring HFTApp created with
+    // --shm-feed instead of sending them over UDP. The ring has a single
+    // producer, so runLoad() uses one sender thread, and there is no line B.
+    void setShmFeed(const std::string& name) { shmFeedName_ = name; }
+    // Binary mode packs batchSize messages into each datagram
+    void setWireFormat(WireFormat format, int batchSize = 1);
+
+    bool start(int rateHz, int durationSec = 0);
+    void stop();
+    bool isRunning() const { return running_.load(); }
+
+    void sendBurst(int count);
+
+    // High-rate mode. Blocks until the profile has played out (or stop()).
+    // Each of `threads` senders owns its own socket and a subset of the
+    // symbols, sends from a pool of pre-serialized datagrams (only the
+    // sequence number, timestamp and order ids are patched per send), and
+    // paces by spinning on the TSC, sending up to sendBatch datagrams per
+    // sendmmsg call when it falls behind. Sequence ranges are reserved per
+    // send call, so with more than one thread a receiver sees reordering
+    // at the interleave points; MarketDataHandler takes those within its
+    // LineArbiter window (65536 messages) rather than dropping them.
+    LoadReport runLoad(const std::vector<LoadPhase>& profile, int threads = 1, int sendBatch = 32);
+    // Steady rate with a market-open spike of rate * spikeMultiplier for
+    // the first spikeMs
+    static std::vector<LoadPhase> openSpikeProfile(double rate, int durationSec,
+        double spikeMultiplier, int spikeMs = 2000);
+
+    // One ASCII message: SYMBOL,PRICE,QTY,SIDE
+    std::string generateMarketData();
+    // One binary message with the next order id
+    AddOrderMessage generateAddOrder();
+
+private:
+    bool initializeSocket();
+    void cleanupSocket();
+    bool connected() const { return sock_ != INVALID_SOCKET || shmFeed_.isOpen(); }
+    void generatorLoop(int rateHz, int durationSec);
+    double generatePrice(const std::string& symbol);
+    Quote nextQuote();
+    Quote quoteFor(const std::string& symbol);
+    std::string formatQuote(const Quote& q) const;
+    AddOrderMessage toAddOrder(const Quote& q, uint64_t orderId) const;
+    // Sends one datagram; returns the number of messages it carried
+    int sendSingleMessage();
+    int sendBinaryPacket();
+    bool sendDatagram(const char* data, size_t length);
+    bool sendToLine(int line, const char* data, size_t length);
+    bool resolve(const std::string& host, int port, sockaddr_in& out);
+    // Multicast TTL, loopback and interface; harmless on unicast targets
+    void applyMulticastOptions(SOCKET sock);
+    SOCKET openLoadSocket(const sockaddr_in& target);
+    void prepareSender(LoadSender& sender, const std::vector<int>& symbolIdx);
+    void senderLoop(LoadSender& sender, const std::vector<LoadPhase>& profile, uint64_t startTicks, int threads);
+
+#ifdef _WIN32
+    bool initializeWinsock();
+    void cleanupWinsock();
+#endif
+};
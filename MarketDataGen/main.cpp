@@ -2,6 +2,7 @@
 #include <string>
 #include <chrono>
 #include <thread>
+#include <vector>
 #include "MarketDataGenerator.hpp"
 
 void printUsage(const char* programName) {
@@ -12,10 +13,28 @@ void printUsage(const char* programName) {
         << "  -r, --rate RATE     Messages per second (default: 100)\n"
         << "  -d, --duration SEC  Duration in seconds (default: 60, 0 = infinite)\n"
         << "  -b, --burst COUNT   Send burst of COUNT messages and exit\n"
+        << "  --binary            Send the binary packet format instead of ASCII\n"
+        << "  --batch N           Messages per binary datagram (default: 1)\n"
+        << "  --load RATE         High-rate mode: hold RATE messages/s for --duration (must be > 0)\n"
+        << "  --threads N         Sender threads in high-rate mode (default: 1)\n"
+        << "  --send-batch N      Max datagrams per sendmmsg call (default: 32)\n"
+        << "  --spike MULT[:MS]   Market-open spike: MULT x RATE for the first MS ms (default 2000)\n"
+        << "  --profile R:MS,...  Explicit phases instead of --load/--spike\n"
+        << "  --line-b HOST:PORT  Redundant A/B feed: also send every datagram here\n"
+        << "  --mcast-if ADDR     Outgoing interface for multicast targets (127.0.0.1 for loopback)\n"
+        << "  --mcast-ttl N       Multicast TTL (default: 1)\n"
+        << "  --drop-a PCT        Withhold PCT% of datagrams on line A, at random\n"
+        << "  --drop-b PCT        Withhold PCT% of datagrams on line B, at random\n"
+        << "  --shm-feed NAME     Write into HFTApp's shared-memory ring NAME instead of UDP\n"
         << "  --help              Show this help message\n"
         << "\nExamples:\n"
         << "  " << programName << " --rate 200 --duration 30\n"
-        << "  " << programName << " --burst 1000\n";
+        << "  " << programName << " --burst 1000\n"
+        << "  " << programName << " --binary --batch 16 --rate 100000\n"
+        << "  " << programName << " --binary --batch 16 --load 2000000 --threads 4 --spike 3 --duration 20\n"
+        << "  " << programName << " --binary --batch 16 --rate 100000 -h 239.1.1.1 -p 9001 --line-b 239.1.1.2:9002\n"
+        << "      --mcast-if 127.0.0.1 --drop-a 1 --drop-b 1\n"
+        << "  " << programName << " --binary --batch 16 --load 2000000 --shm-feed /hft_feed\n";
 }
 
 int main(int argc, char* argv[]) {
@@ -25,6 +44,20 @@ int main(int argc, char* argv[]) {
     int rate = 100;
     int duration = 60;
     int burstCount = 0;
+    bool binary = false;
+    int batch = 1;
+    double loadRate = 0.0;
+    int threads = 1;
+    int sendBatch = 32;
+    double spikeMultiplier = 0.0;
+    int spikeMs = 2000;
+    std::vector<LoadPhase> profile;
+    std::string lineBHost;
+    int lineBPort = 0;
+    std::string multicastIf;
+    int multicastTtl = 1;
+    double dropPct[2] = { 0.0, 0.0 };
+    std::string shmFeed;
 
     // Parse command line arguments
     for (int i = 1; i < argc; ++i) {
@@ -45,6 +78,65 @@ int main(int argc, char* argv[]) {
         else if ((arg == "-b" || arg == "--burst") && i + 1 < argc) {
             burstCount = std::stoi(argv[++i]);
         }
+        else if (arg == "--binary") {
+            binary = true;
+        }
+        else if (arg == "--batch" && i + 1 < argc) {
+            batch = std::stoi(argv[++i]);
+        }
+        else if (arg == "--load" && i + 1 < argc) {
+            loadRate = std::stod(argv[++i]);
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::stoi(argv[++i]);
+        }
+        else if (arg == "--send-batch" && i + 1 < argc) {
+            sendBatch = std::stoi(argv[++i]);
+        }
+        else if (arg == "--spike" && i + 1 < argc) {
+            std::string spec = argv[++i];
+            size_t colon = spec.find(':');
+            spikeMultiplier = std::stod(spec.substr(0, colon));
+            if (colon != std::string::npos) spikeMs = std::stoi(spec.substr(colon + 1));
+        }
+        else if (arg == "--profile" && i + 1 < argc) {
+            std::string spec = argv[++i];
+            size_t start = 0;
+            while (start < spec.size()) {
+                size_t end = spec.find(',', start);
+                if (end == std::string::npos) end = spec.size();
+                std::string phase = spec.substr(start, end - start);
+                size_t colon = phase.find(':');
+                if (colon == std::string::npos) {
+                    std::cerr << "Bad profile phase: " << phase << std::endl;
+                    return 1;
+                }
+                profile.push_back({ std::stod(phase.substr(0, colon)), std::stoi(phase.substr(colon + 1)) });
+                start = end + 1;
+            }
+        }
+        else if (arg == "--line-b" && i + 1 < argc) {
+            std::string spec = argv[++i];
+            size_t colon = spec.rfind(':');
+            if (colon == std::string::npos) {
+                std::cerr << "Expected HOST:PORT for --line-b: " << spec << std::endl;
+                return 1;
+            }
+            lineBHost = spec.substr(0, colon);
+            lineBPort = std::stoi(spec.substr(colon + 1));
+        }
+        else if (arg == "--mcast-if" && i + 1 < argc) {
+            multicastIf = argv[++i];
+        }
+        else if (arg == "--mcast-ttl" && i + 1 < argc) {
+            multicastTtl = std::stoi(argv[++i]);
+        }
+        else if ((arg == "--drop-a" || arg == "--drop-b") && i + 1 < argc) {
+            dropPct[arg == "--drop-b" ? 1 : 0] = std::stod(argv[++i]);
+        }
+        else if (arg == "--shm-feed" && i + 1 < argc) {
+            shmFeed = argv[++i];
+        }
         else if (arg == "--help") {
             printUsage(argv[0]);
             return 0;
@@ -57,12 +149,73 @@ int main(int argc, char* argv[]) {
     }
 
     std::cout << "=== C++ Market Data Generator ===" << std::endl;
-    std::cout << "Target: " << host << ":" << port << std::endl;
+    if (!shmFeed.empty()) {
+        std::cout << "Target: shared memory " << shmFeed << std::endl;
+    }
+    else {
+        std::cout << "Target: " << host << ":" << port << std::endl;
+    }
+    if (!lineBHost.empty() && shmFeed.empty()) {
+        std::cout << "Line B: " << lineBHost << ":" << lineBPort << std::endl;
+    }
+
+    std::cout << "Format: " << (binary ? "binary, " + std::to_string(batch) + " per datagram" : "ASCII") << std::endl;
 
     MarketDataGenerator generator(host, port);
+    if (binary) {
+        generator.setWireFormat(WireFormat::Binary, batch);
+    }
+    if (!lineBHost.empty()) {
+        generator.setSecondLine(lineBHost, lineBPort);
+    }
+    generator.setMulticastOptions(multicastIf, multicastTtl);
+    if (!shmFeed.empty()) {
+        generator.setShmFeed(shmFeed);
+    }
+    generator.setLineLoss(0, dropPct[0] / 100.0);
+    generator.setLineLoss(1, dropPct[1] / 100.0);
+
+    if (profile.empty() && loadRate > 0) {
+        // A load run is a fixed profile that ends with a report; there is
+        // no open-ended version of it
+        if (duration <= 0) {
+            std::cerr << "--load needs a positive --duration (0 = infinite is only for --rate)" << std::endl;
+            return 1;
+        }
+        profile = spikeMultiplier > 0
+            ? MarketDataGenerator::openSpikeProfile(loadRate, duration, spikeMultiplier, spikeMs)
+            : std::vector<LoadPhase>{ { loadRate, duration * 1000 } };
+    }
 
     try {
-        if (burstCount > 0) {
+        if (!profile.empty()) {
+            // High-rate mode
+            std::cout << "Mode: Load (" << threads << " sender thread(s))" << std::endl;
+            for (size_t i = 0; i < profile.size(); ++i) {
+                std::cout << "  Phase " << i << ": " << profile[i].ratePerSec << " msg/s for "
+                    << profile[i].durationMs << " ms" << std::endl;
+            }
+            LoadReport r = generator.runLoad(profile, threads, sendBatch);
+
+            std::cout << std::endl << "=== Load Report ===" << std::endl;
+            std::cout << "Messages: " << r.messages << " in " << r.datagrams << " datagrams ("
+                << r.sendErrors << " send errors)" << std::endl;
+            if (r.lineDrops[0] || r.lineDrops[1]) {
+                std::cout << "Withheld: " << r.lineDrops[0] << " datagrams on line A, "
+                    << r.lineDrops[1] << " on line B" << std::endl;
+            }
+            std::cout << "Rate: " << r.achievedRate << " msg/s achieved, " << r.targetRate
+                << " msg/s target, over " << r.seconds << " s" << std::endl;
+            for (size_t i = 0; i < profile.size(); ++i) {
+                std::cout << "  Phase " << i << ": " << r.phaseRates[i] << " / " << profile[i].ratePerSec
+                    << " msg/s" << std::endl;
+            }
+            std::cout << "Send Lateness (us): p50 " << r.lateness.percentile(0.50) * 1e-3
+                << ", p99 " << r.lateness.percentile(0.99) * 1e-3
+                << ", p99.9 " << r.lateness.percentile(0.999) * 1e-3
+                << ", max " << r.lateness.max() * 1e-3 << std::endl;
+        }
+        else if (burstCount > 0) {
             // Burst mode
             std::cout << "Mode: Burst (" << burstCount << " messages)" << std::endl;
             generator.sendBurst(burstCount);
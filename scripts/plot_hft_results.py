@@ -1,18 +1,52 @@
+import glob
+import struct
+
+import numpy as np
 import pandas as pd
 import matplotlib.pyplot as plt
 
-def plot_csv(filename, x_col, y_cols, title, xlabel, ylabel, output_png):
-    df = pd.read_csv(filename)
-    print(f"\n{filename} columns: {list(df.columns)}")
+def read_timeseries_binary(filename):
+    # TimeSeriesWriter binary format: "HFTTS001", u32 column count, NUL-terminated
+    # names, then blocks of u32 row count followed by one float64 array per column
+    with open(filename, 'rb') as f:
+        data = f.read()
+    if data[:8] != b'HFTTS001':
+        raise ValueError(f"{filename} is not a time-series file")
+    (ncols,) = struct.unpack_from('<I', data, 8)
+    offset = 12
+    names = []
+    for _ in range(ncols):
+        end = data.index(b'\0', offset)
+        names.append(data[offset:end].decode())
+        offset = end + 1
+    columns = [[] for _ in range(ncols)]
+    while offset < len(data):
+        (nrows,) = struct.unpack_from('<I', data, offset)
+        offset += 4
+        for c in range(ncols):
+            columns[c].append(np.frombuffer(data, dtype='<f8', count=nrows, offset=offset))
+            offset += nrows * 8
+    return pd.DataFrame({name: np.concatenate(col) if col else np.array([]) for name, col in zip(names, columns)})
+
+def load_series(base):
+    # Single file, or the rotated parts <base>-000000.csv, <base>-000001.csv, ...
+    for ext, reader in (('.csv', pd.read_csv), ('.ts', read_timeseries_binary)):
+        parts = sorted(glob.glob(f"{base}-[0-9]*{ext}")) or glob.glob(f"{base}{ext}")
+        if parts:
+            return pd.concat([reader(p) for p in parts], ignore_index=True), parts
+    return None, []
+
+def plot_frame(df, source, x_col, y_cols, title, xlabel, ylabel, output_png):
+    print(f"\n{source} columns: {list(df.columns)}")
     if x_col not in df.columns:
-        print(f"Error: X column \"{x_col}\" not found in {filename}. Skipping plot.")
+        print(f"Error: X column \"{x_col}\" not found in {source}. Skipping plot.")
         return
     plt.figure(figsize=(10, 6))
     for col in y_cols:
         if col in df.columns:
             plt.plot(df[x_col], df[col], label=col)
         else:
-            print(f"Warning: Y column \"{col}\" not found in {filename}.")
+            print(f"Warning: Y column \"{col}\" not found in {source}.")
     plt.title(title)
     plt.xlabel(xlabel)
     plt.ylabel(ylabel)
@@ -24,15 +58,19 @@ def plot_csv(filename, x_col, y_cols, title, xlabel, ylabel, output_png):
     plt.close()
 
 def main():
-    files_and_plots = [
-        ('dashboard_timeseries.csv', 'Time', ['Price', 'MovingAvg', 'Volume', 'CumPnL'], 'dashboard_metrics.png', 'Trading Dashboard Metrics', 'Time', 'Value'),
-        ('price_series.csv', 'Time', ['Price'], 'price_over_time.png', 'Price Over Time', 'Time', 'Price'),
-        ('Synthetic_Price_data.csv', 'Time', ['Price'], 'synthetic_price.png', 'Synthetic Price', 'Time', 'Price'),
-        ('Cumulative_PnL_data.csv', 'Time', ['PnL'], 'cumulative_pnl.png', 'Cumulative P&L Over Time', 'Time', 'P&L'),
-        ('Moving_Average_data.csv', 'Time', ['MovingAvg'], 'moving_average.png', 'Moving Average Over Time', 'Time', 'Moving Average')
+    df, parts = load_series('dashboard_timeseries')
+    if df is None:
+        print("No dashboard_timeseries output found.")
+        return
+    source = ', '.join(parts)
+    plots = [
+        ('Time', ['Price', 'MovingAvg', 'Volume', 'CumPnL'], 'dashboard_metrics.png', 'Trading Dashboard Metrics', 'Time', 'Value'),
+        ('Time', ['Price'], 'price_over_time.png', 'Price Over Time', 'Time', 'Price'),
+        ('Time', ['CumPnL'], 'cumulative_pnl.png', 'Cumulative P&L Over Time', 'Time', 'P&L'),
+        ('Time', ['MovingAvg'], 'moving_average.png', 'Moving Average Over Time', 'Time', 'Moving Average')
     ]
-    for fname, xcol, ycols, opng, title, xlabel, ylabel in files_and_plots:
-        plot_csv(fname, xcol, ycols, title, xlabel, ylabel, opng)
+    for xcol, ycols, opng, title, xlabel, ylabel in plots:
+        plot_frame(df, source, xcol, ycols, title, xlabel, ylabel, opng)
 
 if __name__ == '__main__':
     main()